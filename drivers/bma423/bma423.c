@@ -0,0 +1,531 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "bma423.h"
+
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(bma423, CONFIG_BMA423_LOG_LEVEL);
+
+#define DT_DRV_COMPAT bosch_bma423
+
+int bma423_bus_read(const struct device *dev, uint8_t reg, uint8_t *buf, size_t len)
+{
+    const struct bma423_config *config = dev->config;
+    struct bma423_data *data = dev->data;
+
+    const uint32_t start = k_cycle_get_32();
+    int ret = i2c_burst_read_dt(&config->i2c, reg, buf, len);
+    data->bus_cycles += k_cycle_get_32() - start;
+    return ret;
+}
+
+// With advanced power save on (low power mode), the chip needs 450 us
+// between writes
+#define BMA423_POWER_SAVE_WRITE_GAP_US 450
+
+static void bma423_bus_write_gap(struct bma423_data *data)
+{
+    if (!data->low_power)
+    {
+        return;
+    }
+
+    const uint32_t since_us = k_cyc_to_us_floor32(k_cycle_get_32() - data->last_write);
+    if (since_us < BMA423_POWER_SAVE_WRITE_GAP_US)
+    {
+        k_busy_wait(BMA423_POWER_SAVE_WRITE_GAP_US - since_us);
+    }
+}
+
+int bma423_bus_write(const struct device *dev, uint8_t reg, uint8_t value)
+{
+    const struct bma423_config *config = dev->config;
+    struct bma423_data *data = dev->data;
+
+    bma423_bus_write_gap(data);
+    const uint32_t start = k_cycle_get_32();
+    int ret = i2c_reg_write_byte_dt(&config->i2c, reg, value);
+    data->last_write = k_cycle_get_32();
+    data->bus_cycles += data->last_write - start;
+    return ret;
+}
+
+int bma423_bus_burst_write(const struct device *dev, uint8_t reg, const uint8_t *buf, size_t len)
+{
+    const struct bma423_config *config = dev->config;
+    struct bma423_data *data = dev->data;
+
+    bma423_bus_write_gap(data);
+    const uint32_t start = k_cycle_get_32();
+    int ret = i2c_burst_write_dt(&config->i2c, reg, buf, len);
+    data->last_write = k_cycle_get_32();
+    data->bus_cycles += data->last_write - start;
+    return ret;
+}
+
+void bma423_stats_get(const struct device *dev, struct bma423_stats *stats)
+{
+    struct bma423_data *data = dev->data;
+
+    *stats = data->stats;
+    stats->bus_us = (uint32_t)k_cyc_to_us_floor64(data->bus_cycles);
+}
+
+void bma423_stats_reset(const struct device *dev)
+{
+    struct bma423_data *data = dev->data;
+
+    // the config file upload only happens once, at boot
+    data->stats = (struct bma423_stats){.config_upload_us = data->stats.config_upload_us};
+    data->bus_cycles = 0;
+}
+
+static bool bma423_is_accel_channel(enum sensor_channel chan)
+{
+    return chan == SENSOR_CHAN_ACCEL_X || chan == SENSOR_CHAN_ACCEL_Y || chan == SENSOR_CHAN_ACCEL_Z ||
+           chan == SENSOR_CHAN_ACCEL_XYZ;
+}
+
+// Performance mode samples continuously and filters with the normal
+// bandwidth. Low power mode duty cycles, and averages instead.
+static int bma423_acc_conf_write(const struct device *dev, uint8_t odr, bool low_power, uint8_t avg)
+{
+    struct bma423_data *data = dev->data;
+
+    uint8_t acc_conf = FIELD_PREP(BMA423_ACC_CONF_ODR_MASK, odr);
+    if (low_power)
+    {
+        acc_conf |= FIELD_PREP(BMA423_ACC_CONF_BWP_MASK, avg);
+    }
+    else
+    {
+        acc_conf |= BMA423_ACC_CONF_PERF_MODE | FIELD_PREP(BMA423_ACC_CONF_BWP_MASK, BMA423_ACC_CONF_BWP_NORM_AVG4);
+    }
+
+    CHECK_OK(bma423_bus_write(dev, BMA423_REG_ACC_CONF, acc_conf));
+    data->odr = odr;
+    data->avg = avg;
+    return 0;
+}
+
+static int bma423_set_odr(const struct device *dev, const struct sensor_value *val)
+{
+    struct bma423_data *data = dev->data;
+
+    // pick the slowest rate at or above the requested one
+    const int64_t requested_mhz = sensor_value_to_milli(val);
+    uint8_t odr = BMA423_ODR_12_5;
+    while (odr < BMA423_ODR_1600 && (25000LL << (odr - 1)) / 32 < requested_mhz)
+    {
+        odr++;
+    }
+
+    return bma423_acc_conf_write(dev, odr, data->low_power, data->avg);
+}
+
+static int bma423_set_oversampling(const struct device *dev, const struct sensor_value *val)
+{
+    struct bma423_data *data = dev->data;
+
+    if (val->val1 < 1 || val->val1 > BIT(BMA423_ACC_CONF_BWP_AVG_MAX))
+    {
+        return -EINVAL;
+    }
+
+    // at least as many samples as requested
+    uint8_t avg = 0;
+    while (BIT(avg) < val->val1)
+    {
+        avg++;
+    }
+
+    // only used in low power mode, but kept for it either way
+    if (!data->low_power)
+    {
+        data->avg = avg;
+        return 0;
+    }
+
+    return bma423_acc_conf_write(dev, data->odr, true, avg);
+}
+
+// Low power mode is only worth it with advanced power save on, which
+// spaces out every following write
+static int bma423_set_low_power(const struct device *dev, const struct sensor_value *val)
+{
+    struct bma423_data *data = dev->data;
+    const bool low_power = val->val1 != 0;
+
+    if (low_power == data->low_power)
+    {
+        return 0;
+    }
+
+    if (low_power)
+    {
+        CHECK_OK(bma423_acc_conf_write(dev, data->odr, true, data->avg));
+        CHECK_OK(bma423_bus_write(dev, BMA423_REG_PWR_CONF, BMA423_PWR_CONF_ADV_POWER_SAVE));
+        data->low_power = true;
+    }
+    else
+    {
+        CHECK_OK(bma423_bus_write(dev, BMA423_REG_PWR_CONF, 0));
+        data->low_power = false;
+        CHECK_OK(bma423_acc_conf_write(dev, data->odr, false, data->avg));
+    }
+
+    return 0;
+}
+
+static int bma423_set_range(const struct device *dev, const struct sensor_value *val)
+{
+    struct bma423_data *data = dev->data;
+
+    const int64_t requested_ug = sensor_value_to_micro(val) * 1000000LL / SENSOR_G;
+    uint8_t range = BMA423_RANGE_2G;
+    while ((2000000LL << range) < requested_ug)
+    {
+        if (range == BMA423_RANGE_16G)
+        {
+            return -EINVAL;
+        }
+        range++;
+    }
+
+    CHECK_OK(bma423_bus_write(dev, BMA423_REG_ACC_RANGE, range));
+    data->range = range;
+    return 0;
+}
+
+static int bma423_attr_set(const struct device *dev, enum sensor_channel chan, enum sensor_attribute attr,
+                           const struct sensor_value *val)
+{
+    if (!bma423_is_accel_channel(chan))
+    {
+        return -ENOTSUP;
+    }
+
+    switch ((int)attr)
+    {
+    case SENSOR_ATTR_SAMPLING_FREQUENCY:
+        return bma423_set_odr(dev, val);
+    case SENSOR_ATTR_FULL_SCALE:
+        return bma423_set_range(dev, val);
+    case SENSOR_ATTR_OVERSAMPLING:
+        return bma423_set_oversampling(dev, val);
+    case SENSOR_ATTR_BMA423_LOW_POWER:
+        return bma423_set_low_power(dev, val);
+    case SENSOR_ATTR_OFFSET:
+        return bma423_offset_attr_set(dev, chan, val);
+    case SENSOR_ATTR_CALIB_TARGET:
+        return chan == SENSOR_CHAN_ACCEL_XYZ ? bma423_calibrate(dev, val) : -ENOTSUP;
+#ifdef CONFIG_BMA423_FEATURES
+    case SENSOR_ATTR_SLOPE_TH:
+    case SENSOR_ATTR_SLOPE_DUR:
+    case SENSOR_ATTR_BMA423_NO_MOTION_TH:
+    case SENSOR_ATTR_BMA423_NO_MOTION_DUR:
+        return bma423_motion_attr_set(dev, attr, val);
+#endif
+    default:
+        return -ENOTSUP;
+    }
+}
+
+static int bma423_attr_get(const struct device *dev, enum sensor_channel chan, enum sensor_attribute attr,
+                           struct sensor_value *val)
+{
+    struct bma423_data *data = dev->data;
+
+    if (!bma423_is_accel_channel(chan))
+    {
+        return -ENOTSUP;
+    }
+
+    switch ((int)attr)
+    {
+    case SENSOR_ATTR_SAMPLING_FREQUENCY:
+        return sensor_value_from_milli(val, (25000LL << (data->odr - 1)) / 32);
+    case SENSOR_ATTR_FULL_SCALE:
+        sensor_g_to_ms2(2 << data->range, val);
+        return 0;
+    case SENSOR_ATTR_OVERSAMPLING:
+        *val = (struct sensor_value){.val1 = BIT(data->avg)};
+        return 0;
+    case SENSOR_ATTR_BMA423_LOW_POWER:
+        *val = (struct sensor_value){.val1 = data->low_power};
+        return 0;
+    case SENSOR_ATTR_OFFSET:
+        return bma423_offset_attr_get(dev, chan, val);
+    default:
+        return -ENOTSUP;
+    }
+}
+
+static void bma423_submit_one_shot(const struct device *dev, struct rtio_iodev_sqe *iodev_sqe)
+{
+    const struct sensor_read_config *read_config = iodev_sqe->sqe.iodev->data;
+    struct bma423_data *data = dev->data;
+    bool has_accel = false;
+    bool has_steps = false;
+
+    for (size_t i = 0; i < read_config->count; i++)
+    {
+        const enum sensor_channel chan = read_config->channels[i].chan_type;
+        if (bma423_is_accel_channel(chan))
+        {
+            has_accel = true;
+        }
+        else if (IS_ENABLED(CONFIG_BMA423_STEP_COUNTER) && chan == (enum sensor_channel)SENSOR_CHAN_BMA423_STEPS)
+        {
+            has_steps = true;
+        }
+        else
+        {
+            LOG_ERR("Channel %d not supported", chan);
+            rtio_iodev_sqe_err(iodev_sqe, -ENOTSUP);
+            return;
+        }
+    }
+
+    const uint32_t len = sizeof(struct bma423_encoded_data) + (has_accel ? BMA423_FRAME_SIZE : 0);
+    uint8_t *buf;
+    uint32_t buf_len;
+    int ret = rtio_sqe_rx_buf(iodev_sqe, len, len, &buf, &buf_len);
+    if (ret < 0)
+    {
+        LOG_ERR("Failed to get a read buffer: %d", ret);
+        rtio_iodev_sqe_err(iodev_sqe, ret);
+        return;
+    }
+
+    struct bma423_encoded_data *edata = (struct bma423_encoded_data *)buf;
+    edata->timestamp = k_ticks_to_ns_floor64(k_uptime_ticks());
+    edata->period_ns = bma423_odr_period_ns(data->odr);
+    edata->frame_count = has_accel ? 1 : 0;
+    edata->range = data->range;
+    edata->has_steps = has_steps;
+    edata->events = 0;
+    edata->steps = 0;
+
+    if (has_accel)
+    {
+        ret = bma423_bus_read(dev, BMA423_REG_DATA_8, edata->frames, BMA423_FRAME_SIZE);
+        if (ret < 0)
+        {
+            LOG_ERR("Failed to read sample: %d", ret);
+            rtio_iodev_sqe_err(iodev_sqe, ret);
+            return;
+        }
+        data->stats.frames++;
+    }
+
+    if (has_steps)
+    {
+        uint8_t steps[4];
+        ret = bma423_bus_read(dev, BMA423_REG_STEP_COUNTER_0, steps, sizeof(steps));
+        if (ret < 0)
+        {
+            LOG_ERR("Failed to read the step counter: %d", ret);
+            rtio_iodev_sqe_err(iodev_sqe, ret);
+            return;
+        }
+        edata->steps = sys_get_le32(steps);
+    }
+
+    data->stats.reads++;
+    rtio_iodev_sqe_ok(iodev_sqe, 0);
+}
+
+static void bma423_submit(const struct device *dev, struct rtio_iodev_sqe *iodev_sqe)
+{
+    const struct sensor_read_config *read_config = iodev_sqe->sqe.iodev->data;
+
+    if (!read_config->is_streaming)
+    {
+        bma423_submit_one_shot(dev, iodev_sqe);
+        return;
+    }
+
+#ifdef CONFIG_BMA423_STREAM
+    bma423_submit_stream(dev, iodev_sqe);
+#else
+    rtio_iodev_sqe_err(iodev_sqe, -ENOTSUP);
+#endif
+}
+
+static const struct sensor_driver_api bma423_driver_api = {
+    .attr_set = bma423_attr_set,
+    .attr_get = bma423_attr_get,
+#ifdef CONFIG_BMA423_TRIGGER
+    .trigger_set = bma423_trigger_set,
+#endif
+    .submit = bma423_submit,
+    .get_decoder = bma423_get_decoder,
+};
+
+void bma423_bringup_get(const struct device *dev, struct bma423_bringup *bringup)
+{
+    struct bma423_data *data = dev->data;
+
+    *bringup = data->bringup;
+}
+
+// Below a tick, sleeping would round up to the whole tick
+static void bma423_delay_us(uint32_t us)
+{
+    if (us < k_ticks_to_us_ceil32(1))
+    {
+        k_busy_wait(us);
+    }
+    else
+    {
+        k_usleep(us);
+    }
+}
+
+// Polls CHIP_ID and ERR_REG in one read: the chip is up once it answers
+// with the right id and no fatal error
+static int bma423_poll(const struct device *dev)
+{
+    uint8_t regs[BMA423_REG_ERR - BMA423_REG_CHIP_ID + 1];
+    int ret = bma423_bus_read(dev, BMA423_REG_CHIP_ID, regs, sizeof(regs));
+    if (ret < 0)
+    {
+        return ret;
+    }
+
+    if (regs[0] != BMA423_CHIP_ID || (regs[BMA423_REG_ERR] & BMA423_ERR_FATAL))
+    {
+        return -ENODEV;
+    }
+
+    return 0;
+}
+
+// Resets the chip and waits for it with exponential backoff, recording
+// every poll. A chip that answers right away costs one short delay; one
+// that missed the reset (it does not acknowledge it, so there is no
+// telling) gets reset again once the timeout runs out.
+static int bma423_bring_up(const struct device *dev)
+{
+    struct bma423_data *data = dev->data;
+    struct bma423_bringup *bringup = &data->bringup;
+    int ret = -ETIMEDOUT;
+
+    *bringup = (struct bma423_bringup){0};
+    const uint32_t start = k_cycle_get_32();
+
+    while (bringup->resets < CONFIG_BMA423_BRINGUP_RESETS)
+    {
+        (void)bma423_bus_write(dev, BMA423_REG_CMD, BMA423_CMD_SOFT_RESET);
+        bringup->resets++;
+
+        const uint32_t reset_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+        uint32_t delay_us = CONFIG_BMA423_BRINGUP_FIRST_POLL_US;
+        uint32_t at_us;
+        do
+        {
+            bma423_delay_us(delay_us);
+            delay_us *= 2;
+
+            ret = bma423_poll(dev);
+            at_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+            if (bringup->attempts < BMA423_BRINGUP_MAX_ATTEMPTS)
+            {
+                bringup->attempt[bringup->attempts].at_us = at_us;
+                bringup->attempt[bringup->attempts].result = ret;
+                bringup->attempts++;
+            }
+
+            if (ret == 0)
+            {
+                bringup->total_us = at_us;
+                LOG_DBG("Up after %u us, %u polls, %u resets", at_us, bringup->attempts, bringup->resets);
+                return 0;
+            }
+        } while (at_us - reset_us < CONFIG_BMA423_BRINGUP_TIMEOUT_MS * USEC_PER_MSEC);
+    }
+
+    bringup->total_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+    LOG_ERR("No answer after %u us, %u resets (last error %d)", bringup->total_us, bringup->resets, ret);
+    return ret;
+}
+
+static int bma423_init(const struct device *dev)
+{
+    const struct bma423_config *config = dev->config;
+
+    if (!i2c_is_ready_dt(&config->i2c))
+    {
+        LOG_ERR("I2C bus not ready");
+        return -ENODEV;
+    }
+
+    CHECK_OK(bma423_bring_up(dev));
+    CHECK_OK(bma423_offset_init(dev));
+
+    // With advanced power save on, consecutive register writes need 450us
+    // between them. Leave it off: the accelerometer itself stays in
+    // performance mode at 100 Hz, +-4 g until told otherwise, and low power
+    // mode turns it on later.
+    CHECK_OK(bma423_bus_write(dev, BMA423_REG_PWR_CONF, 0));
+
+    const struct sensor_value odr = {.val1 = 100};
+    CHECK_OK(bma423_set_odr(dev, &odr));
+    struct sensor_value range;
+    sensor_g_to_ms2(4, &range);
+    CHECK_OK(bma423_set_range(dev, &range));
+
+    CHECK_OK(bma423_bus_write(dev, BMA423_REG_PWR_CTRL, BMA423_PWR_CTRL_ACC_EN));
+
+#ifdef CONFIG_BMA423_FEATURES
+    CHECK_OK(bma423_feature_init(dev));
+#endif
+
+#ifdef CONFIG_BMA423_INT1
+    if (config->int1_gpio.port != NULL)
+    {
+        CHECK_OK(bma423_int1_init(dev));
+    }
+#endif
+
+    LOG_DBG("Initialized");
+    return 0;
+}
+
+#define BMA423_MOTION_THRESHOLD(mg) ((mg) * BMA423_FEATURE_MOTION_THRESHOLD_PER_G / 1000)
+#define BMA423_MOTION_DURATION(ms) ((ms) / BMA423_FEATURE_MOTION_MS_PER_STEP)
+
+#define BMA423_DEFINE(inst)                                                                                            \
+    BUILD_ASSERT(DT_INST_PROP(inst, fifo_watermark) > 0 &&                                                             \
+                     DT_INST_PROP(inst, fifo_watermark) <= BMA423_FIFO_MAX_FRAMES,                                     \
+                 "fifo-watermark must fit in the FIFO");                                                               \
+    BUILD_ASSERT(BMA423_MOTION_THRESHOLD(DT_INST_PROP(inst, any_motion_threshold_mg)) <= 0x7FF &&                      \
+                     BMA423_MOTION_THRESHOLD(DT_INST_PROP(inst, no_motion_threshold_mg)) <= 0x7FF,                     \
+                 "motion thresholds go up to 999 mg");                                                                 \
+    BUILD_ASSERT(BMA423_MOTION_DURATION(DT_INST_PROP(inst, any_motion_duration_ms)) <= 0x1FFF &&                       \
+                     BMA423_MOTION_DURATION(DT_INST_PROP(inst, no_motion_duration_ms)) <= 0x1FFF,                      \
+                 "motion durations go up to 163 s");                                                                   \
+    static const struct bma423_config bma423_config_##inst = {                                                         \
+        .i2c = I2C_DT_SPEC_INST_GET(inst),                                                                             \
+        .int1_gpio = GPIO_DT_SPEC_INST_GET_OR(inst, int1_gpios, {0}),                                                  \
+        .fifo_watermark = DT_INST_PROP(inst, fifo_watermark),                                                          \
+        .any_motion_threshold = BMA423_MOTION_THRESHOLD(DT_INST_PROP(inst, any_motion_threshold_mg)),                  \
+        .any_motion_duration = BMA423_MOTION_DURATION(DT_INST_PROP(inst, any_motion_duration_ms)),                     \
+        .no_motion_threshold = BMA423_MOTION_THRESHOLD(DT_INST_PROP(inst, no_motion_threshold_mg)),                    \
+        .no_motion_duration = BMA423_MOTION_DURATION(DT_INST_PROP(inst, no_motion_duration_ms)),                       \
+    };                                                                                                                 \
+    static struct bma423_data bma423_data_##inst = {                                                                   \
+        .dev = DEVICE_DT_INST_GET(inst),                                                                               \
+        .avg = BMA423_ACC_CONF_BWP_NORM_AVG4,                                                                          \
+    };                                                                                                                 \
+    SENSOR_DEVICE_DT_INST_DEFINE(inst, bma423_init, NULL, &bma423_data_##inst, &bma423_config_##inst, POST_KERNEL,     \
+                                 CONFIG_SENSOR_INIT_PRIORITY, &bma423_driver_api);
+
+DT_INST_FOREACH_STATUS_OKAY(BMA423_DEFINE)
@@ -0,0 +1,284 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef BMA423_H
+#define BMA423_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/drivers/sensor/bma423.h>
+#include <zephyr/rtio/rtio.h>
+
+#define BMA423_CHIP_ID 0x13
+
+#define BMA423_REG_CHIP_ID 0x00
+#define BMA423_REG_ERR 0x02
+#define BMA423_REG_STATUS 0x03
+#define BMA423_REG_DATA_8 0x12 // ACC_X LSB, the first of 6 data registers
+#define BMA423_REG_INT_STATUS_0 0x1C
+#define BMA423_REG_INT_STATUS_1 0x1D
+#define BMA423_REG_STEP_COUNTER_0 0x1E
+#define BMA423_REG_FIFO_LENGTH_0 0x24
+#define BMA423_REG_FIFO_DATA 0x26
+#define BMA423_REG_INTERNAL_STATUS 0x2A
+#define BMA423_REG_ACC_CONF 0x40
+#define BMA423_REG_ACC_RANGE 0x41
+#define BMA423_REG_FIFO_WTM_0 0x46
+#define BMA423_REG_FIFO_WTM_1 0x47
+#define BMA423_REG_FIFO_CONFIG_0 0x48
+#define BMA423_REG_FIFO_CONFIG_1 0x49
+#define BMA423_REG_INT1_IO_CTRL 0x53
+#define BMA423_REG_INT_LATCH 0x55
+#define BMA423_REG_INT1_MAP 0x56
+#define BMA423_REG_INT_MAP_DATA 0x58
+#define BMA423_REG_INIT_CTRL 0x59
+#define BMA423_REG_ASIC_LSB 0x5B
+#define BMA423_REG_ASIC_MSB 0x5C
+#define BMA423_REG_FEATURE_CONFIG 0x5E
+#define BMA423_REG_NVM_CONF 0x6A
+#define BMA423_REG_NV_CONF 0x70
+#define BMA423_REG_OFFSET_0 0x71 // X, then Y and Z
+#define BMA423_REG_PWR_CONF 0x7C
+#define BMA423_REG_PWR_CTRL 0x7D
+#define BMA423_REG_CMD 0x7E
+
+#define BMA423_ERR_FATAL BIT(0)
+
+#define BMA423_STATUS_CMD_RDY BIT(4)
+
+#define BMA423_INT_STATUS_1_FFULL BIT(0)
+#define BMA423_INT_STATUS_1_FWM BIT(1)
+
+// Feature engine interrupts, the same bits in INT_STATUS_0 and INT1_MAP
+#define BMA423_FEATURE_INT_SINGLE_TAP BIT(0)
+#define BMA423_FEATURE_INT_STEP BIT(1)
+#define BMA423_FEATURE_INT_ACTIVITY BIT(2)
+#define BMA423_FEATURE_INT_WRIST_WEAR BIT(3)
+#define BMA423_FEATURE_INT_DOUBLE_TAP BIT(4)
+#define BMA423_FEATURE_INT_ANY_MOTION BIT(5)
+#define BMA423_FEATURE_INT_NO_MOTION BIT(6)
+#define BMA423_FEATURE_INT_ERROR BIT(7)
+
+#define BMA423_INTERNAL_STATUS_MSG_MASK GENMASK(3, 0)
+#define BMA423_INTERNAL_STATUS_INIT_OK 0x01
+
+#define BMA423_ACC_CONF_ODR_MASK GENMASK(3, 0)
+#define BMA423_ACC_CONF_BWP_MASK GENMASK(6, 4)
+#define BMA423_ACC_CONF_PERF_MODE BIT(7)
+#define BMA423_ACC_CONF_BWP_NORM_AVG4 2
+// In low power mode, BWP is the log2 of the samples averaged, up to 128
+#define BMA423_ACC_CONF_BWP_AVG_MAX 7
+
+#define BMA423_ODR_12_5 0x05
+#define BMA423_ODR_100 0x08
+#define BMA423_ODR_1600 0x0C
+
+#define BMA423_RANGE_2G 0
+#define BMA423_RANGE_16G 3
+
+#define BMA423_FIFO_CONFIG_1_ACC_EN BIT(6)
+#define BMA423_FIFO_CONFIG_1_HEADER_EN BIT(4)
+
+#define BMA423_INT1_IO_CTRL_LVL BIT(1)
+#define BMA423_INT1_IO_CTRL_OD BIT(2)
+#define BMA423_INT1_IO_CTRL_OUTPUT_EN BIT(3)
+
+#define BMA423_INT_MAP_DATA_INT1_FFULL BIT(0)
+#define BMA423_INT_MAP_DATA_INT1_FWM BIT(1)
+
+#define BMA423_PWR_CONF_ADV_POWER_SAVE BIT(0)
+#define BMA423_PWR_CTRL_ACC_EN BIT(2)
+
+#define BMA423_NVM_CONF_PROG_EN BIT(1)
+#define BMA423_NV_CONF_ACC_OFF_EN BIT(3)
+
+// Offsets are signed, in 1/256 g (3.9 mg), and added to every sample once
+// NV_CONF enables them. Both are loaded from the NVM at reset.
+#define BMA423_OFFSET_PER_G 256
+
+#define BMA423_CMD_NVM_PROG 0xA0
+#define BMA423_CMD_FIFO_FLUSH 0xB0
+#define BMA423_CMD_SOFT_RESET 0xB6
+
+// The feature engine's settings, read and written as one block through
+// FEATURE_CONFIG once the config file is running. It is made of little
+// endian 16-bit words, at the offsets of Bosch's BMA423 config file.
+#define BMA423_FEATURE_SIZE 70
+#define BMA423_FEATURE_ANY_MOTION 0x00
+#define BMA423_FEATURE_NO_MOTION 0x04
+#define BMA423_FEATURE_STEP_CNTR 0x3A
+#define BMA423_FEATURE_SINGLE_TAP 0x3C
+#define BMA423_FEATURE_DOUBLE_TAP 0x3E
+#define BMA423_FEATURE_WRIST_TILT 0x40
+#define BMA423_FEATURE_EN BIT(0)
+
+#define BMA423_FEATURE_STEP_CNTR_DETECTOR_EN BIT(11)
+#define BMA423_FEATURE_STEP_CNTR_EN BIT(12)
+
+// Any and no motion are a threshold word, then a duration word that also
+// holds the per-axis enables
+#define BMA423_FEATURE_MOTION_DURATION 2
+#define BMA423_FEATURE_MOTION_THRESHOLD_MASK GENMASK(10, 0)
+#define BMA423_FEATURE_MOTION_DURATION_MASK GENMASK(12, 0)
+#define BMA423_FEATURE_MOTION_AXES_EN GENMASK(15, 13)
+// 1/2048 g per threshold step, and the engine runs at 50 Hz
+#define BMA423_FEATURE_MOTION_THRESHOLD_PER_G 2048
+#define BMA423_FEATURE_MOTION_MS_PER_STEP 20
+
+// One accelerometer sample: X, Y, Z as little endian 16-bit words, with
+// the 12-bit reading left aligned. This is both the DATA_8..DATA_13
+// register layout and the headerless FIFO frame layout.
+#define BMA423_FRAME_SIZE 6
+#define BMA423_FIFO_SIZE 1024
+#define BMA423_FIFO_MAX_FRAMES (BMA423_FIFO_SIZE / BMA423_FRAME_SIZE)
+
+// Events recorded in bma423_encoded_data.events
+#define BMA423_EVENT_FIFO_WATERMARK BIT(0)
+#define BMA423_EVENT_FIFO_FULL BIT(1)
+
+// What the RTIO buffers hold: a header, then frame_count frames in the
+// order they were sampled
+struct bma423_encoded_data
+{
+    // sample time of the newest frame, in nanoseconds of uptime
+    uint64_t timestamp;
+    uint32_t period_ns;
+    uint16_t frame_count;
+    uint8_t range : 2;
+    uint8_t has_steps : 1;
+    uint8_t events;
+    // step counter, if has_steps
+    uint32_t steps;
+    uint8_t frames[];
+};
+
+BUILD_ASSERT(sizeof(struct bma423_encoded_data) % 4 == 0, "frames should be word aligned");
+
+struct bma423_config
+{
+    struct i2c_dt_spec i2c;
+    struct gpio_dt_spec int1_gpio;
+    uint16_t fifo_watermark;
+    // any/no motion defaults, in feature engine units
+    uint16_t any_motion_threshold;
+    uint16_t any_motion_duration;
+    uint16_t no_motion_threshold;
+    uint16_t no_motion_duration;
+};
+
+#ifdef CONFIG_BMA423_TRIGGER
+// The triggers sensor_trigger_set() takes, each one a feature engine interrupt
+enum bma423_trigger
+{
+    BMA423_TRIGGER_TAP,
+    BMA423_TRIGGER_DOUBLE_TAP,
+    BMA423_TRIGGER_WRIST_TILT,
+    BMA423_TRIGGER_MOTION,
+    BMA423_TRIGGER_STATIONARY,
+    BMA423_TRIGGER_COUNT,
+};
+#endif
+
+struct bma423_data
+{
+    const struct device *dev;
+
+    // ACC_CONF ODR and ACC_RANGE codes currently programmed
+    uint8_t odr;
+    uint8_t range;
+    // low power mode averages 2^avg samples, and turns on advanced power
+    // save, so writes have to be spaced out
+    bool low_power;
+    uint8_t avg;
+    uint32_t last_write;
+
+    // the offsets as the NVM holds them, loaded at reset
+    int8_t nvm_offset[3];
+    bool nvm_offset_en;
+
+#ifdef CONFIG_BMA423_INT1
+    struct gpio_callback gpio_cb;
+    struct k_work work;
+    uint64_t int_timestamp;
+    bool int1_enabled;
+#endif
+
+#ifdef CONFIG_BMA423_STREAM
+    struct k_spinlock lock;
+    struct rtio_iodev_sqe *stream_sqe;
+    bool fifo_enabled;
+    bool fifo_pending;
+#endif
+
+#ifdef CONFIG_BMA423_TRIGGER
+    // indexed by enum bma423_trigger
+    sensor_trigger_handler_t trigger_handlers[BMA423_TRIGGER_COUNT];
+    const struct sensor_trigger *triggers[BMA423_TRIGGER_COUNT];
+    // feature interrupts currently mapped to INT1
+    uint8_t int1_map;
+#endif
+
+    struct bma423_bringup bringup;
+
+    // bus_us is derived from bus_cycles when the stats are read
+    struct bma423_stats stats;
+    uint64_t bus_cycles;
+};
+
+// check return code, return code on error
+#define CHECK_OK(ret)                        \
+    do                                       \
+    {                                        \
+        int ret_ = (ret);                    \
+        if (ret_ < 0)                        \
+        {                                    \
+            LOG_ERR("Error: %d", ret_);      \
+            return ret_;                     \
+        }                                    \
+    } while (0)
+
+// Nanoseconds between samples for an ACC_CONF ODR code (code 1 is 25/32 Hz,
+// and every code above doubles it)
+static inline uint32_t bma423_odr_period_ns(uint8_t odr)
+{
+    return 1280000000U >> (odr - 1);
+}
+
+// Bus transfers go through here so the time spent on i2c0 can be accounted
+int bma423_bus_read(const struct device *dev, uint8_t reg, uint8_t *buf, size_t len);
+int bma423_bus_write(const struct device *dev, uint8_t reg, uint8_t value);
+int bma423_bus_burst_write(const struct device *dev, uint8_t reg, const uint8_t *buf, size_t len);
+
+int bma423_offset_init(const struct device *dev);
+int bma423_offset_attr_set(const struct device *dev, enum sensor_channel chan, const struct sensor_value *val);
+int bma423_offset_attr_get(const struct device *dev, enum sensor_channel chan, struct sensor_value *val);
+int bma423_calibrate(const struct device *dev, const struct sensor_value target[3]);
+
+int bma423_get_decoder(const struct device *dev, const struct sensor_decoder_api **decoder);
+
+#ifdef CONFIG_BMA423_INT1
+int bma423_int1_init(const struct device *dev);
+void bma423_int1_update(const struct device *dev);
+#endif
+
+#ifdef CONFIG_BMA423_STREAM
+void bma423_stream_handle(const struct device *dev, uint8_t int_status);
+void bma423_submit_stream(const struct device *dev, struct rtio_iodev_sqe *iodev_sqe);
+#endif
+
+#ifdef CONFIG_BMA423_FEATURES
+int bma423_feature_init(const struct device *dev);
+int bma423_feature_update(const struct device *dev, uint8_t offset, uint16_t mask, uint16_t value);
+int bma423_motion_attr_set(const struct device *dev, enum sensor_attribute attr, const struct sensor_value *val);
+#endif
+
+#ifdef CONFIG_BMA423_TRIGGER
+int bma423_trigger_set(const struct device *dev, const struct sensor_trigger *trig,
+                       sensor_trigger_handler_t handler);
+void bma423_trigger_handle(const struct device *dev, uint8_t int_status);
+#endif
+
+#endif // BMA423_H
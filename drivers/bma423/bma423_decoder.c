@@ -0,0 +1,244 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "bma423.h"
+
+#include <errno.h>
+
+#include <zephyr/sys/byteorder.h>
+
+#define DT_DRV_COMPAT bosch_bma423
+
+// Each axis is a little endian 16-bit word holding a 12-bit two's
+// complement reading in its top bits, +-(2 << range) g full scale. Taken as
+// an int16 it is the reading times 16, already sign extended. With a q31
+// shift of 5 + range, one of those int16 steps is 9.80665 * 2^12 in q31 at
+// every range.
+#define BMA423_Q31_PER_STEP 40168
+
+// the low 4 bits of every word are not part of the reading
+#define BMA423_DATA_MASK 0xFFF0FFF0U
+
+static inline q31_t bma423_q31_lo(uint32_t word)
+{
+    return ((int32_t)(word << 16) >> 16) * BMA423_Q31_PER_STEP;
+}
+
+static inline q31_t bma423_q31_hi(uint32_t word)
+{
+    return ((int32_t)word >> 16) * BMA423_Q31_PER_STEP;
+}
+
+static inline q31_t bma423_q31(const uint8_t *axis)
+{
+    return bma423_q31_lo(sys_get_le16(axis) & BMA423_DATA_MASK);
+}
+
+static inline void bma423_decode_frame(const uint8_t *frame, uint32_t timestamp_delta,
+                                       struct sensor_three_axis_sample_data *out)
+{
+    out->timestamp_delta = timestamp_delta;
+    out->x = bma423_q31(&frame[0]);
+    out->y = bma423_q31(&frame[2]);
+    out->z = bma423_q31(&frame[4]);
+}
+
+// Two frames are three words: [x0 y0] [z0 x1] [y1 z1]. Reading them a word
+// at a time converts two axes per load, one mask and two shifts, with no
+// branches per sample. Frames start word aligned in the RTIO buffer, so the
+// word loop is only skipped past an odd first frame.
+static void bma423_decode_xyz(const uint8_t *frame, uint16_t count, uint32_t period_ns,
+                              struct sensor_three_axis_sample_data *out)
+{
+    uint16_t i = 0;
+
+    if (count > 0 && !IS_ALIGNED(frame, sizeof(uint32_t)))
+    {
+        bma423_decode_frame(frame, 0, &out[0]);
+        frame += BMA423_FRAME_SIZE;
+        i++;
+    }
+
+    if (IS_ALIGNED(frame, sizeof(uint32_t)))
+    {
+        const uint32_t *word = (const uint32_t *)frame;
+        for (; i + 1 < count; i += 2, word += 3)
+        {
+            const uint32_t w0 = sys_le32_to_cpu(word[0]) & BMA423_DATA_MASK;
+            const uint32_t w1 = sys_le32_to_cpu(word[1]) & BMA423_DATA_MASK;
+            const uint32_t w2 = sys_le32_to_cpu(word[2]) & BMA423_DATA_MASK;
+
+            out[i].timestamp_delta = i * period_ns;
+            out[i].x = bma423_q31_lo(w0);
+            out[i].y = bma423_q31_hi(w0);
+            out[i].z = bma423_q31_lo(w1);
+
+            out[i + 1].timestamp_delta = (i + 1) * period_ns;
+            out[i + 1].x = bma423_q31_hi(w1);
+            out[i + 1].y = bma423_q31_lo(w2);
+            out[i + 1].z = bma423_q31_hi(w2);
+        }
+        frame = (const uint8_t *)word;
+    }
+
+    for (; i < count; i++, frame += BMA423_FRAME_SIZE)
+    {
+        bma423_decode_frame(frame, i * period_ns, &out[i]);
+    }
+}
+
+// The step counter is a single 32-bit count: with a shift of 31 the q31
+// value is the count itself
+static int bma423_decode_steps(const struct bma423_encoded_data *edata, uint32_t *fit, uint16_t max_count,
+                               struct sensor_q31_data *out)
+{
+    if (!edata->has_steps || *fit > 0 || max_count == 0)
+    {
+        return 0;
+    }
+
+    out->header.base_timestamp_ns = edata->timestamp;
+    out->header.reading_count = 1;
+    out->shift = 31;
+    out->readings[0].timestamp_delta = 0;
+    out->readings[0].value = (q31_t)edata->steps;
+
+    *fit = 1;
+    return 1;
+}
+
+static int bma423_decoder_get_frame_count(const uint8_t *buffer, struct sensor_chan_spec chan_spec,
+                                          uint16_t *frame_count)
+{
+    const struct bma423_encoded_data *edata = (const struct bma423_encoded_data *)buffer;
+
+    if (chan_spec.chan_idx != 0)
+    {
+        return -ENOTSUP;
+    }
+
+    switch (chan_spec.chan_type)
+    {
+    case SENSOR_CHAN_ACCEL_X:
+    case SENSOR_CHAN_ACCEL_Y:
+    case SENSOR_CHAN_ACCEL_Z:
+    case SENSOR_CHAN_ACCEL_XYZ:
+        *frame_count = edata->frame_count;
+        return 0;
+    case (enum sensor_channel)SENSOR_CHAN_BMA423_STEPS:
+        if (!edata->has_steps)
+        {
+            return -ENODATA;
+        }
+        *frame_count = 1;
+        return 0;
+    default:
+        return -ENOTSUP;
+    }
+}
+
+static int bma423_decoder_get_size_info(struct sensor_chan_spec chan_spec, size_t *base_size, size_t *frame_size)
+{
+    if (chan_spec.chan_type == (enum sensor_channel)SENSOR_CHAN_BMA423_STEPS)
+    {
+        *base_size = sizeof(struct sensor_q31_data);
+        *frame_size = sizeof(struct sensor_q31_sample_data);
+        return 0;
+    }
+
+    return sensor_natively_supported_channel_size_info(chan_spec, base_size, frame_size);
+}
+
+static int bma423_decoder_decode(const uint8_t *buffer, struct sensor_chan_spec chan_spec, uint32_t *fit,
+                                 uint16_t max_count, void *data_out)
+{
+    const struct bma423_encoded_data *edata = (const struct bma423_encoded_data *)buffer;
+
+    if (chan_spec.chan_idx != 0)
+    {
+        return -ENOTSUP;
+    }
+
+    if (chan_spec.chan_type == (enum sensor_channel)SENSOR_CHAN_BMA423_STEPS)
+    {
+        return bma423_decode_steps(edata, fit, max_count, data_out);
+    }
+
+    if (*fit >= edata->frame_count)
+    {
+        return 0;
+    }
+
+    const uint16_t first = *fit;
+    // timestamp deltas are 32-bit nanoseconds, which only spans 53 frames
+    // at the slowest rate: the caller has to come back for the rest
+    const uint32_t max_span = UINT32_MAX / edata->period_ns + 1;
+    const uint16_t count = MIN(MIN(max_count, edata->frame_count - first), max_span);
+    // the header timestamp belongs to the newest frame in the buffer
+    const uint64_t base_timestamp =
+        edata->timestamp - (uint64_t)(edata->frame_count - 1 - first) * edata->period_ns;
+    const uint8_t *frame = &edata->frames[first * BMA423_FRAME_SIZE];
+
+    switch (chan_spec.chan_type)
+    {
+    case SENSOR_CHAN_ACCEL_XYZ: {
+        struct sensor_three_axis_data *out = data_out;
+        out->header.base_timestamp_ns = base_timestamp;
+        out->header.reading_count = count;
+        out->shift = 5 + edata->range;
+        bma423_decode_xyz(frame, count, edata->period_ns, out->readings);
+        break;
+    }
+    case SENSOR_CHAN_ACCEL_X:
+    case SENSOR_CHAN_ACCEL_Y:
+    case SENSOR_CHAN_ACCEL_Z: {
+        struct sensor_q31_data *out = data_out;
+        out->header.base_timestamp_ns = base_timestamp;
+        out->header.reading_count = count;
+        out->shift = 5 + edata->range;
+
+        const size_t axis = (chan_spec.chan_type - SENSOR_CHAN_ACCEL_X) * 2;
+        for (uint16_t i = 0; i < count; i++, frame += BMA423_FRAME_SIZE)
+        {
+            out->readings[i].timestamp_delta = i * edata->period_ns;
+            out->readings[i].value = bma423_q31(&frame[axis]);
+        }
+        break;
+    }
+    default:
+        return -ENOTSUP;
+    }
+
+    *fit = first + count;
+    return count;
+}
+
+static bool bma423_decoder_has_trigger(const uint8_t *buffer, enum sensor_trigger_type trigger)
+{
+    const struct bma423_encoded_data *edata = (const struct bma423_encoded_data *)buffer;
+
+    switch (trigger)
+    {
+    case SENSOR_TRIG_FIFO_WATERMARK:
+        return edata->events & BMA423_EVENT_FIFO_WATERMARK;
+    case SENSOR_TRIG_FIFO_FULL:
+        return edata->events & BMA423_EVENT_FIFO_FULL;
+    default:
+        return false;
+    }
+}
+
+SENSOR_DECODER_API_DT_DEFINE() = {
+    .get_frame_count = bma423_decoder_get_frame_count,
+    .get_size_info = bma423_decoder_get_size_info,
+    .decode = bma423_decoder_decode,
+    .has_trigger = bma423_decoder_has_trigger,
+};
+
+int bma423_get_decoder(const struct device *dev, const struct sensor_decoder_api **decoder)
+{
+    ARG_UNUSED(dev);
+    *decoder = &SENSOR_DECODER_NAME();
+    return 0;
+}
@@ -0,0 +1,154 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "bma423.h"
+
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(bma423, CONFIG_BMA423_LOG_LEVEL);
+
+// Bosch's feature engine firmware, from CONFIG_BMA423_FEATURE_CONFIG_FILE
+static const uint8_t bma423_config_file[] = {
+#include "bma423_config_file.inc"
+};
+
+BUILD_ASSERT(sizeof(bma423_config_file) % 2 == 0, "the config file is made of 16-bit words");
+BUILD_ASSERT(CONFIG_BMA423_FEATURE_UPLOAD_CHUNK % 2 == 0, "chunks have to start on a word");
+
+// The engine comes up within 140 ms of INIT_CTRL
+#define BMA423_FEATURE_INIT_TIMEOUT_MS 150
+#define BMA423_FEATURE_INIT_POLL_MS 10
+
+// The config file is written through FEATURE_CONFIG, with the destination
+// in ASIC_LSB/ASIC_MSB counted in words. Bosch's reference code writes it 8
+// or 16 bytes at a time, each one with its own address and transaction; in
+// chunks of CONFIG_BMA423_FEATURE_UPLOAD_CHUNK, the 6 KiB take a few
+// bursts and the upload is limited by the bus clock alone.
+static int bma423_feature_upload(const struct device *dev)
+{
+    for (size_t offset = 0; offset < sizeof(bma423_config_file); offset += CONFIG_BMA423_FEATURE_UPLOAD_CHUNK)
+    {
+        const size_t len = MIN(CONFIG_BMA423_FEATURE_UPLOAD_CHUNK, sizeof(bma423_config_file) - offset);
+        const uint16_t word = offset / 2;
+
+        CHECK_OK(bma423_bus_write(dev, BMA423_REG_ASIC_LSB, word & 0x0F));
+        CHECK_OK(bma423_bus_write(dev, BMA423_REG_ASIC_MSB, word >> 4));
+        CHECK_OK(bma423_bus_burst_write(dev, BMA423_REG_FEATURE_CONFIG, &bma423_config_file[offset], len));
+    }
+
+    return 0;
+}
+
+int bma423_feature_update(const struct device *dev, uint8_t offset, uint16_t mask, uint16_t value)
+{
+    // the engine only takes its settings as a whole block
+    uint8_t features[BMA423_FEATURE_SIZE];
+    CHECK_OK(bma423_bus_read(dev, BMA423_REG_FEATURE_CONFIG, features, sizeof(features)));
+
+    const uint16_t word = sys_get_le16(&features[offset]);
+    const uint16_t updated = (word & ~mask) | (value & mask);
+    if (updated == word)
+    {
+        return 0;
+    }
+
+    sys_put_le16(updated, &features[offset]);
+    CHECK_OK(bma423_bus_burst_write(dev, BMA423_REG_FEATURE_CONFIG, features, sizeof(features)));
+    return 0;
+}
+
+static int bma423_motion_set(const struct device *dev, uint8_t feature, uint16_t threshold, uint16_t duration)
+{
+    CHECK_OK(bma423_feature_update(dev, feature, BMA423_FEATURE_MOTION_THRESHOLD_MASK, threshold));
+    CHECK_OK(bma423_feature_update(dev, feature + BMA423_FEATURE_MOTION_DURATION,
+                                   BMA423_FEATURE_MOTION_DURATION_MASK, duration));
+    return 0;
+}
+
+// Thresholds are accelerations in m/s^2, durations are milliseconds in
+// val1. Both apply straight away, even to an armed trigger.
+int bma423_motion_attr_set(const struct device *dev, enum sensor_attribute attr, const struct sensor_value *val)
+{
+    uint8_t offset;
+    uint16_t mask;
+    int64_t value;
+
+    switch ((int)attr)
+    {
+    case SENSOR_ATTR_SLOPE_TH:
+    case SENSOR_ATTR_BMA423_NO_MOTION_TH:
+        offset = attr == SENSOR_ATTR_SLOPE_TH ? BMA423_FEATURE_ANY_MOTION : BMA423_FEATURE_NO_MOTION;
+        mask = BMA423_FEATURE_MOTION_THRESHOLD_MASK;
+        value = sensor_value_to_micro(val) * BMA423_FEATURE_MOTION_THRESHOLD_PER_G / SENSOR_G;
+        break;
+    case SENSOR_ATTR_SLOPE_DUR:
+    case SENSOR_ATTR_BMA423_NO_MOTION_DUR:
+        offset = (attr == SENSOR_ATTR_SLOPE_DUR ? BMA423_FEATURE_ANY_MOTION : BMA423_FEATURE_NO_MOTION) +
+                 BMA423_FEATURE_MOTION_DURATION;
+        mask = BMA423_FEATURE_MOTION_DURATION_MASK;
+        value = val->val1 / BMA423_FEATURE_MOTION_MS_PER_STEP;
+        break;
+    default:
+        return -ENOTSUP;
+    }
+
+    if (value < 0 || value > mask)
+    {
+        return -EINVAL;
+    }
+
+    return bma423_feature_update(dev, offset, mask, value);
+}
+
+int bma423_feature_init(const struct device *dev)
+{
+    const struct bma423_config *config = dev->config;
+    struct bma423_data *data = dev->data;
+
+    // The upload needs advanced power save off, which init has already
+    // taken care of
+    const uint32_t start = k_cycle_get_32();
+    CHECK_OK(bma423_bus_write(dev, BMA423_REG_INIT_CTRL, 0));
+    CHECK_OK(bma423_feature_upload(dev));
+    CHECK_OK(bma423_bus_write(dev, BMA423_REG_INIT_CTRL, 1));
+    const uint32_t upload_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+    uint8_t status = 0;
+    for (int waited = 0; waited < BMA423_FEATURE_INIT_TIMEOUT_MS; waited += BMA423_FEATURE_INIT_POLL_MS)
+    {
+        k_msleep(BMA423_FEATURE_INIT_POLL_MS);
+        CHECK_OK(bma423_bus_read(dev, BMA423_REG_INTERNAL_STATUS, &status, 1));
+        if (FIELD_GET(BMA423_INTERNAL_STATUS_MSG_MASK, status) == BMA423_INTERNAL_STATUS_INIT_OK)
+        {
+            break;
+        }
+    }
+
+    if (FIELD_GET(BMA423_INTERNAL_STATUS_MSG_MASK, status) != BMA423_INTERNAL_STATUS_INIT_OK)
+    {
+        LOG_ERR("Feature engine did not start (internal status 0x%02x)", status);
+        return -EIO;
+    }
+
+    data->stats.config_upload_us = upload_us;
+    LOG_INF("Feature engine loaded: %u bytes in %u us", (uint32_t)sizeof(bma423_config_file), upload_us);
+
+    // armed by their triggers, but configured from the devicetree up front
+    CHECK_OK(bma423_motion_set(dev, BMA423_FEATURE_ANY_MOTION, config->any_motion_threshold,
+                               config->any_motion_duration));
+    CHECK_OK(bma423_motion_set(dev, BMA423_FEATURE_NO_MOTION, config->no_motion_threshold,
+                               config->no_motion_duration));
+
+#ifdef CONFIG_BMA423_STEP_COUNTER
+    // the counter runs on its own from here on: reading it is one transfer
+    CHECK_OK(bma423_feature_update(dev, BMA423_FEATURE_STEP_CNTR, BMA423_FEATURE_STEP_CNTR_EN,
+                                   BMA423_FEATURE_STEP_CNTR_EN));
+#endif
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "bma423.h"
+
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(bma423, CONFIG_BMA423_LOG_LEVEL);
+
+// INT1 is shared by the FIFO (INT_MAP_DATA) and the feature engine
+// (INT1_MAP). It is latched until the status registers are read, so every
+// edge is one work item that reads INT_STATUS_0 and INT_STATUS_1 in one go
+// and hands each half to whoever asked for it.
+
+static void bma423_int1_callback(const struct device *port, struct gpio_callback *cb, gpio_port_pins_t pins)
+{
+    ARG_UNUSED(port);
+    ARG_UNUSED(pins);
+
+    struct bma423_data *data = CONTAINER_OF(cb, struct bma423_data, gpio_cb);
+    data->int_timestamp = k_ticks_to_ns_floor64(k_uptime_ticks());
+    data->stats.wakeups++;
+    k_work_submit(&data->work);
+}
+
+static void bma423_int1_work(struct k_work *work)
+{
+    struct bma423_data *data = CONTAINER_OF(work, struct bma423_data, work);
+    const struct device *dev = data->dev;
+
+    // reading the status also releases the latched INT1 line
+    uint8_t int_status[2];
+    int ret = bma423_bus_read(dev, BMA423_REG_INT_STATUS_0, int_status, sizeof(int_status));
+    if (ret < 0)
+    {
+        LOG_ERR("Failed to read the interrupt status: %d", ret);
+        return;
+    }
+
+#ifdef CONFIG_BMA423_TRIGGER
+    bma423_trigger_handle(dev, int_status[0]);
+#endif
+#ifdef CONFIG_BMA423_STREAM
+    bma423_stream_handle(dev, int_status[1]);
+#endif
+
+    bma423_int1_update(dev);
+}
+
+// The line may have latched while nobody was listening, and no edge will
+// come for it
+static void bma423_int1_check(const struct device *dev)
+{
+    const struct bma423_config *config = dev->config;
+    struct bma423_data *data = dev->data;
+
+    if (gpio_pin_get_dt(&config->int1_gpio) > 0)
+    {
+        data->int_timestamp = k_ticks_to_ns_floor64(k_uptime_ticks());
+        k_work_submit(&data->work);
+    }
+}
+
+void bma423_int1_update(const struct device *dev)
+{
+    const struct bma423_config *config = dev->config;
+    struct bma423_data *data = dev->data;
+
+    // Only listen to INT1 while something is mapped to it, so an idle
+    // sensor never wakes the host
+    bool needed = false;
+#ifdef CONFIG_BMA423_STREAM
+    needed |= data->fifo_enabled;
+#endif
+#ifdef CONFIG_BMA423_TRIGGER
+    needed |= data->int1_map != 0;
+#endif
+
+    if (needed == data->int1_enabled)
+    {
+        return;
+    }
+
+    int ret = gpio_pin_interrupt_configure_dt(&config->int1_gpio, needed ? GPIO_INT_EDGE_TO_ACTIVE : GPIO_INT_DISABLE);
+    if (ret < 0)
+    {
+        LOG_ERR("Failed to configure the INT1 interrupt: %d", ret);
+        return;
+    }
+    data->int1_enabled = needed;
+
+    if (needed)
+    {
+        bma423_int1_check(dev);
+    }
+}
+
+void bma423_int1_resync(const struct device *dev)
+{
+    const struct bma423_config *config = dev->config;
+    struct bma423_data *data = dev->data;
+
+    if (config->int1_gpio.port == NULL || !data->int1_enabled)
+    {
+        return;
+    }
+
+    int ret = gpio_pin_interrupt_configure_dt(&config->int1_gpio, GPIO_INT_EDGE_TO_ACTIVE);
+    if (ret < 0)
+    {
+        LOG_ERR("Failed to configure the INT1 interrupt: %d", ret);
+        return;
+    }
+
+    bma423_int1_check(dev);
+}
+
+int bma423_int1_init(const struct device *dev)
+{
+    const struct bma423_config *config = dev->config;
+    struct bma423_data *data = dev->data;
+
+    if (!gpio_is_ready_dt(&config->int1_gpio))
+    {
+        LOG_ERR("INT1 GPIO not ready");
+        return -ENODEV;
+    }
+
+    k_work_init(&data->work, bma423_int1_work);
+
+    CHECK_OK(gpio_pin_configure_dt(&config->int1_gpio, GPIO_INPUT));
+    gpio_init_callback(&data->gpio_cb, bma423_int1_callback, BIT(config->int1_gpio.pin));
+    CHECK_OK(gpio_add_callback(config->int1_gpio.port, &data->gpio_cb));
+
+    // Drive INT1 push-pull at the polarity the board expects, and keep it
+    // asserted until the status register has been read. Push-pull, because
+    // the SoC's pull-ups are gone in deep sleep and INT1 can wake it from there.
+    const bool active_high = !(config->int1_gpio.dt_flags & GPIO_ACTIVE_LOW);
+    const uint8_t io_ctrl = BMA423_INT1_IO_CTRL_OUTPUT_EN | (active_high ? BMA423_INT1_IO_CTRL_LVL : 0);
+    CHECK_OK(bma423_bus_write(dev, BMA423_REG_INT1_IO_CTRL, io_ctrl));
+    CHECK_OK(bma423_bus_write(dev, BMA423_REG_INT_LATCH, 1));
+
+    return 0;
+}
@@ -0,0 +1,251 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "bma423.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(bma423, CONFIG_BMA423_LOG_LEVEL);
+
+// More spread than this on any axis while sampling, and the watch moved
+#define BMA423_CALIB_MAX_SPREAD_MG 50
+
+// Programming the NVM takes tens of milliseconds
+#define BMA423_NVM_PROG_TIMEOUT_MS 100
+#define BMA423_NVM_PROG_POLL_MS 5
+
+static int32_t bma423_offset_to_micro(int8_t offset)
+{
+    return (int64_t)offset * SENSOR_G / BMA423_OFFSET_PER_G;
+}
+
+static int bma423_offset_from_micro(int64_t micro, int8_t *offset)
+{
+    const int64_t value = DIV_ROUND_CLOSEST(micro * BMA423_OFFSET_PER_G, SENSOR_G);
+    if (value < INT8_MIN || value > INT8_MAX)
+    {
+        return -ERANGE;
+    }
+
+    *offset = value;
+    return 0;
+}
+
+static int bma423_axes(enum sensor_channel chan, uint8_t *first, uint8_t *count)
+{
+    switch (chan)
+    {
+    case SENSOR_CHAN_ACCEL_X:
+    case SENSOR_CHAN_ACCEL_Y:
+    case SENSOR_CHAN_ACCEL_Z:
+        *first = chan - SENSOR_CHAN_ACCEL_X;
+        *count = 1;
+        return 0;
+    case SENSOR_CHAN_ACCEL_XYZ:
+        *first = 0;
+        *count = 3;
+        return 0;
+    default:
+        return -ENOTSUP;
+    }
+}
+
+// The offsets and their enable, as currently in effect
+static int bma423_offset_read(const struct device *dev, int8_t offset[3], bool *enabled)
+{
+    uint8_t nv_conf;
+    CHECK_OK(bma423_bus_read(dev, BMA423_REG_NV_CONF, &nv_conf, 1));
+    CHECK_OK(bma423_bus_read(dev, BMA423_REG_OFFSET_0, (uint8_t *)offset, 3));
+    *enabled = nv_conf & BMA423_NV_CONF_ACC_OFF_EN;
+    return 0;
+}
+
+static int bma423_offset_write(const struct device *dev, const int8_t offset[3])
+{
+    CHECK_OK(bma423_bus_burst_write(dev, BMA423_REG_OFFSET_0, (const uint8_t *)offset, 3));
+
+    // NV_CONF also holds the interface settings
+    uint8_t nv_conf;
+    CHECK_OK(bma423_bus_read(dev, BMA423_REG_NV_CONF, &nv_conf, 1));
+    if (!(nv_conf & BMA423_NV_CONF_ACC_OFF_EN))
+    {
+        CHECK_OK(bma423_bus_write(dev, BMA423_REG_NV_CONF, nv_conf | BMA423_NV_CONF_ACC_OFF_EN));
+    }
+
+    return 0;
+}
+
+int bma423_offset_init(const struct device *dev)
+{
+    struct bma423_data *data = dev->data;
+
+    // right after the reset, this is what the NVM holds
+    CHECK_OK(bma423_offset_read(dev, data->nvm_offset, &data->nvm_offset_en));
+    if (data->nvm_offset_en)
+    {
+        LOG_INF("Offsets from NVM: %d, %d, %d (1/%d g)", data->nvm_offset[0], data->nvm_offset[1],
+                data->nvm_offset[2], BMA423_OFFSET_PER_G);
+    }
+
+    return 0;
+}
+
+int bma423_offset_attr_set(const struct device *dev, enum sensor_channel chan, const struct sensor_value *val)
+{
+    uint8_t first;
+    uint8_t count;
+    CHECK_OK(bma423_axes(chan, &first, &count));
+
+    int8_t offset[3];
+    bool enabled;
+    CHECK_OK(bma423_offset_read(dev, offset, &enabled));
+    if (!enabled)
+    {
+        memset(offset, 0, sizeof(offset));
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        int ret = bma423_offset_from_micro(sensor_value_to_micro(&val[i]), &offset[first + i]);
+        if (ret < 0)
+        {
+            return ret;
+        }
+    }
+
+    return bma423_offset_write(dev, offset);
+}
+
+int bma423_offset_attr_get(const struct device *dev, enum sensor_channel chan, struct sensor_value *val)
+{
+    uint8_t first;
+    uint8_t count;
+    CHECK_OK(bma423_axes(chan, &first, &count));
+
+    int8_t offset[3];
+    bool enabled;
+    CHECK_OK(bma423_offset_read(dev, offset, &enabled));
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        sensor_value_from_micro(&val[i], enabled ? bma423_offset_to_micro(offset[first + i]) : 0);
+    }
+
+    return 0;
+}
+
+// Averages CONFIG_BMA423_CALIB_SAMPLES samples, and moves the offsets by
+// however far that is from the target. The samples come out of the data
+// registers with the current offsets applied, so those are the starting
+// point.
+int bma423_calibrate(const struct device *dev, const struct sensor_value target[3])
+{
+    struct bma423_data *data = dev->data;
+
+    int8_t offset[3];
+    bool enabled;
+    CHECK_OK(bma423_offset_read(dev, offset, &enabled));
+    if (!enabled)
+    {
+        memset(offset, 0, sizeof(offset));
+    }
+
+    int64_t sum[3] = {0};
+    int16_t min[3] = {INT16_MAX, INT16_MAX, INT16_MAX};
+    int16_t max[3] = {INT16_MIN, INT16_MIN, INT16_MIN};
+    for (int i = 0; i < CONFIG_BMA423_CALIB_SAMPLES; i++)
+    {
+        k_sleep(K_NSEC(bma423_odr_period_ns(data->odr)));
+
+        uint8_t frame[BMA423_FRAME_SIZE];
+        CHECK_OK(bma423_bus_read(dev, BMA423_REG_DATA_8, frame, sizeof(frame)));
+        for (int axis = 0; axis < 3; axis++)
+        {
+            const int16_t sample = sys_get_le16(&frame[axis * 2]);
+            sum[axis] += sample;
+            min[axis] = MIN(min[axis], sample);
+            max[axis] = MAX(max[axis], sample);
+        }
+    }
+
+    // Samples are 1/32768 of the full scale, offsets 1/256 g
+    const int32_t full_scale_g = 2 << data->range;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        const int32_t spread_mg = (max[axis] - min[axis]) * full_scale_g * 1000 / 32768;
+        if (spread_mg > BMA423_CALIB_MAX_SPREAD_MG)
+        {
+            LOG_WRN("Moved during calibration (%d mg on axis %d)", spread_mg, axis);
+            return -EAGAIN;
+        }
+
+        const int64_t measured =
+            DIV_ROUND_CLOSEST(sum[axis] * full_scale_g * BMA423_OFFSET_PER_G, 32768LL * CONFIG_BMA423_CALIB_SAMPLES);
+        int8_t wanted;
+        CHECK_OK(bma423_offset_from_micro(sensor_value_to_micro(&target[axis]), &wanted));
+
+        const int32_t calibrated = offset[axis] + wanted - measured;
+        if (calibrated < INT8_MIN || calibrated > INT8_MAX)
+        {
+            LOG_ERR("Offset out of range on axis %d: %d", axis, calibrated);
+            return -ERANGE;
+        }
+        offset[axis] = calibrated;
+    }
+
+    LOG_INF("Calibrated offsets: %d, %d, %d (1/%d g)", offset[0], offset[1], offset[2], BMA423_OFFSET_PER_G);
+    return bma423_offset_write(dev, offset);
+}
+
+int bma423_offset_store(const struct device *dev)
+{
+    struct bma423_data *data = dev->data;
+
+    int8_t offset[3];
+    bool enabled;
+    CHECK_OK(bma423_offset_read(dev, offset, &enabled));
+    if (enabled == data->nvm_offset_en && memcmp(offset, data->nvm_offset, sizeof(offset)) == 0)
+    {
+        return 0;
+    }
+
+    // the NVM cannot be programmed with advanced power save on
+    if (data->low_power)
+    {
+        CHECK_OK(bma423_bus_write(dev, BMA423_REG_PWR_CONF, 0));
+    }
+
+    CHECK_OK(bma423_bus_write(dev, BMA423_REG_NVM_CONF, BMA423_NVM_CONF_PROG_EN));
+    CHECK_OK(bma423_bus_write(dev, BMA423_REG_CMD, BMA423_CMD_NVM_PROG));
+
+    uint8_t status = 0;
+    for (int waited = 0; waited < BMA423_NVM_PROG_TIMEOUT_MS && !(status & BMA423_STATUS_CMD_RDY);
+         waited += BMA423_NVM_PROG_POLL_MS)
+    {
+        k_msleep(BMA423_NVM_PROG_POLL_MS);
+        CHECK_OK(bma423_bus_read(dev, BMA423_REG_STATUS, &status, 1));
+    }
+
+    CHECK_OK(bma423_bus_write(dev, BMA423_REG_NVM_CONF, 0));
+    if (data->low_power)
+    {
+        CHECK_OK(bma423_bus_write(dev, BMA423_REG_PWR_CONF, BMA423_PWR_CONF_ADV_POWER_SAVE));
+    }
+
+    if (!(status & BMA423_STATUS_CMD_RDY))
+    {
+        LOG_ERR("NVM programming did not finish");
+        return -ETIMEDOUT;
+    }
+
+    memcpy(data->nvm_offset, offset, sizeof(offset));
+    data->nvm_offset_en = enabled;
+    LOG_INF("Offsets stored: %d, %d, %d (1/%d g)", offset[0], offset[1], offset[2], BMA423_OFFSET_PER_G);
+    return 0;
+}
@@ -0,0 +1,232 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "bma423.h"
+
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(bma423, CONFIG_BMA423_LOG_LEVEL);
+
+// FIFO streaming. The FIFO runs headerless with only the accelerometer in
+// it, so it is nothing but 6 byte frames and can be drained straight into
+// the RTIO buffer. Each watermark is one edge on INT1, one work item and
+// one burst read.
+
+static struct rtio_iodev_sqe *bma423_take_sqe(struct bma423_data *data)
+{
+    struct rtio_iodev_sqe *iodev_sqe;
+
+    K_SPINLOCK(&data->lock)
+    {
+        iodev_sqe = data->stream_sqe;
+        data->stream_sqe = NULL;
+    }
+
+    return iodev_sqe;
+}
+
+static int bma423_fifo_enable(const struct device *dev)
+{
+    const struct bma423_config *config = dev->config;
+    struct bma423_data *data = dev->data;
+
+    const uint16_t watermark = config->fifo_watermark * BMA423_FRAME_SIZE;
+    CHECK_OK(bma423_bus_write(dev, BMA423_REG_FIFO_CONFIG_1, BMA423_FIFO_CONFIG_1_ACC_EN));
+    CHECK_OK(bma423_bus_write(dev, BMA423_REG_FIFO_WTM_0, watermark & 0xFF));
+    CHECK_OK(bma423_bus_write(dev, BMA423_REG_FIFO_WTM_1, watermark >> 8));
+    CHECK_OK(bma423_bus_write(dev, BMA423_REG_CMD, BMA423_CMD_FIFO_FLUSH));
+    CHECK_OK(bma423_bus_write(dev, BMA423_REG_INT_MAP_DATA,
+                              BMA423_INT_MAP_DATA_INT1_FWM | BMA423_INT_MAP_DATA_INT1_FFULL));
+
+    data->fifo_enabled = true;
+    return 0;
+}
+
+// Nobody is listening any more: stop the FIFO interrupts until the next
+// submission, and let the FIFO overwrite its oldest frames in the meantime
+static void bma423_fifo_disable(const struct device *dev)
+{
+    struct bma423_data *data = dev->data;
+
+    if (bma423_bus_write(dev, BMA423_REG_INT_MAP_DATA, 0) < 0)
+    {
+        LOG_ERR("Failed to unmap the FIFO interrupts");
+        return;
+    }
+
+    data->fifo_enabled = false;
+    data->fifo_pending = false;
+}
+
+// What to do with the FIFO contents, given the triggers that fired. The
+// enum is ordered from most to least demanding, so the strictest wins.
+static enum sensor_stream_data_opt bma423_stream_data_opt(const struct sensor_read_config *read_config,
+                                                          uint8_t events)
+{
+    enum sensor_stream_data_opt opt = SENSOR_STREAM_DATA_DROP;
+    bool matched = false;
+
+    for (size_t i = 0; i < read_config->count; i++)
+    {
+        const struct sensor_stream_trigger *trigger = &read_config->triggers[i];
+        if ((trigger->trigger == SENSOR_TRIG_FIFO_WATERMARK && (events & BMA423_EVENT_FIFO_WATERMARK)) ||
+            (trigger->trigger == SENSOR_TRIG_FIFO_FULL && (events & BMA423_EVENT_FIFO_FULL)))
+        {
+            opt = MIN(opt, trigger->opt);
+            matched = true;
+        }
+    }
+
+    return matched ? opt : SENSOR_STREAM_DATA_NOP;
+}
+
+static void bma423_stream_complete(const struct device *dev, struct rtio_iodev_sqe *iodev_sqe, uint8_t events)
+{
+    const struct sensor_read_config *read_config = iodev_sqe->sqe.iodev->data;
+    struct bma423_data *data = dev->data;
+    int ret;
+
+    const enum sensor_stream_data_opt opt = bma423_stream_data_opt(read_config, events);
+
+    uint16_t available = 0;
+    if (opt == SENSOR_STREAM_DATA_INCLUDE)
+    {
+        uint8_t length[2];
+        ret = bma423_bus_read(dev, BMA423_REG_FIFO_LENGTH_0, length, sizeof(length));
+        if (ret < 0)
+        {
+            rtio_iodev_sqe_err(iodev_sqe, ret);
+            return;
+        }
+        available = (sys_get_le16(length) & 0x3FFF) / BMA423_FRAME_SIZE;
+    }
+
+    const uint32_t min_len = sizeof(struct bma423_encoded_data) + (available > 0 ? BMA423_FRAME_SIZE : 0);
+    const uint32_t ideal_len = sizeof(struct bma423_encoded_data) + available * BMA423_FRAME_SIZE;
+    uint8_t *buf;
+    uint32_t buf_len;
+    ret = rtio_sqe_rx_buf(iodev_sqe, min_len, ideal_len, &buf, &buf_len);
+    if (ret < 0)
+    {
+        LOG_ERR("Failed to get a FIFO buffer: %d", ret);
+        rtio_iodev_sqe_err(iodev_sqe, ret);
+        return;
+    }
+
+    // Whatever does not fit stays in the FIFO, and is picked up as soon as
+    // the next buffer is submitted
+    const uint16_t count = MIN(available, (buf_len - sizeof(struct bma423_encoded_data)) / BMA423_FRAME_SIZE);
+    data->fifo_pending = count < available;
+
+    struct bma423_encoded_data *edata = (struct bma423_encoded_data *)buf;
+    edata->period_ns = bma423_odr_period_ns(data->odr);
+    // the interrupt fired as the newest frame in the FIFO landed
+    edata->timestamp = data->int_timestamp - (uint64_t)(available - count) * edata->period_ns;
+    edata->frame_count = count;
+    edata->range = data->range;
+    // the buffer is not zeroed, and streams carry no step count
+    edata->has_steps = 0;
+    edata->events = events;
+    edata->steps = 0;
+
+    if (count > 0)
+    {
+        ret = bma423_bus_read(dev, BMA423_REG_FIFO_DATA, edata->frames, count * BMA423_FRAME_SIZE);
+    }
+    else if (opt == SENSOR_STREAM_DATA_DROP)
+    {
+        ret = bma423_bus_write(dev, BMA423_REG_CMD, BMA423_CMD_FIFO_FLUSH);
+    }
+
+    if (ret < 0)
+    {
+        LOG_ERR("Failed to drain the FIFO: %d", ret);
+        rtio_iodev_sqe_err(iodev_sqe, ret);
+        return;
+    }
+
+    data->stats.frames += count;
+    rtio_iodev_sqe_ok(iodev_sqe, 0);
+}
+
+void bma423_stream_handle(const struct device *dev, uint8_t int_status)
+{
+    struct bma423_data *data = dev->data;
+
+    uint8_t events = 0;
+    events |= (int_status & BMA423_INT_STATUS_1_FWM) ? BMA423_EVENT_FIFO_WATERMARK : 0;
+    events |= (int_status & BMA423_INT_STATUS_1_FFULL) ? BMA423_EVENT_FIFO_FULL : 0;
+    if (data->fifo_pending)
+    {
+        // left over from the last drain, which was already past the watermark
+        events |= BMA423_EVENT_FIFO_WATERMARK;
+    }
+
+    if (events == 0 || !data->fifo_enabled)
+    {
+        // not for the FIFO: keep waiting for a real one
+        return;
+    }
+
+    struct rtio_iodev_sqe *iodev_sqe = bma423_take_sqe(data);
+    if (iodev_sqe == NULL)
+    {
+        bma423_fifo_disable(dev);
+        return;
+    }
+
+    if (iodev_sqe->sqe.flags & RTIO_SQE_CANCELED)
+    {
+        bma423_fifo_disable(dev);
+        rtio_iodev_sqe_err(iodev_sqe, -ECANCELED);
+        return;
+    }
+
+    bma423_stream_complete(dev, iodev_sqe, events);
+}
+
+void bma423_submit_stream(const struct device *dev, struct rtio_iodev_sqe *iodev_sqe)
+{
+    const struct bma423_config *config = dev->config;
+    struct bma423_data *data = dev->data;
+
+    if (config->int1_gpio.port == NULL)
+    {
+        rtio_iodev_sqe_err(iodev_sqe, -ENOTSUP);
+        return;
+    }
+
+    if (!data->fifo_enabled && bma423_fifo_enable(dev) < 0)
+    {
+        rtio_iodev_sqe_err(iodev_sqe, -EIO);
+        return;
+    }
+
+    struct rtio_iodev_sqe *old_sqe;
+    K_SPINLOCK(&data->lock)
+    {
+        old_sqe = data->stream_sqe;
+        data->stream_sqe = iodev_sqe;
+    }
+
+    // one stream at a time: a newer one, likely after a cancel the FIFO
+    // never got to see, takes over from whatever was still waiting
+    if (old_sqe != NULL)
+    {
+        rtio_iodev_sqe_err(old_sqe, -ECANCELED);
+    }
+
+    bma423_int1_update(dev);
+
+    // the last drain may not have fit in its buffer
+    if (data->fifo_pending)
+    {
+        data->int_timestamp = k_ticks_to_ns_floor64(k_uptime_ticks());
+        k_work_submit(&data->work);
+    }
+}
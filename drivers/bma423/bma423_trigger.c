@@ -0,0 +1,95 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "bma423.h"
+
+#include <errno.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(bma423, CONFIG_BMA423_LOG_LEVEL);
+
+// Feature engine triggers. Setting a handler turns the feature on and maps
+// its interrupt to INT1; clearing it does the opposite, so features nobody
+// listens to neither run nor wake the host.
+
+struct bma423_trigger_info
+{
+    enum sensor_trigger_type type;
+    // word in the feature config block holding the enable bits
+    uint8_t feature;
+    uint16_t enable;
+    // bit in INT_STATUS_0 and INT1_MAP
+    uint8_t int_bit;
+};
+
+#define BMA423_MOTION_ENABLE(feature) ((feature) + BMA423_FEATURE_MOTION_DURATION), BMA423_FEATURE_MOTION_AXES_EN
+
+static const struct bma423_trigger_info bma423_triggers[BMA423_TRIGGER_COUNT] = {
+    [BMA423_TRIGGER_TAP] = {SENSOR_TRIG_TAP, BMA423_FEATURE_SINGLE_TAP, BMA423_FEATURE_EN,
+                            BMA423_FEATURE_INT_SINGLE_TAP},
+    [BMA423_TRIGGER_DOUBLE_TAP] = {SENSOR_TRIG_DOUBLE_TAP, BMA423_FEATURE_DOUBLE_TAP, BMA423_FEATURE_EN,
+                                   BMA423_FEATURE_INT_DOUBLE_TAP},
+    [BMA423_TRIGGER_WRIST_TILT] = {(enum sensor_trigger_type)SENSOR_TRIG_BMA423_WRIST_TILT, BMA423_FEATURE_WRIST_TILT,
+                                   BMA423_FEATURE_EN, BMA423_FEATURE_INT_WRIST_WEAR},
+    [BMA423_TRIGGER_MOTION] = {SENSOR_TRIG_MOTION, BMA423_MOTION_ENABLE(BMA423_FEATURE_ANY_MOTION),
+                               BMA423_FEATURE_INT_ANY_MOTION},
+    [BMA423_TRIGGER_STATIONARY] = {SENSOR_TRIG_STATIONARY, BMA423_MOTION_ENABLE(BMA423_FEATURE_NO_MOTION),
+                                   BMA423_FEATURE_INT_NO_MOTION},
+};
+
+int bma423_trigger_set(const struct device *dev, const struct sensor_trigger *trig, sensor_trigger_handler_t handler)
+{
+    const struct bma423_config *config = dev->config;
+    struct bma423_data *data = dev->data;
+
+    if (config->int1_gpio.port == NULL)
+    {
+        return -ENOTSUP;
+    }
+
+    size_t index = 0;
+    while (index < BMA423_TRIGGER_COUNT && bma423_triggers[index].type != trig->type)
+    {
+        index++;
+    }
+    if (index == BMA423_TRIGGER_COUNT)
+    {
+        return -ENOTSUP;
+    }
+
+    const struct bma423_trigger_info *info = &bma423_triggers[index];
+    const bool enable = handler != NULL;
+
+    CHECK_OK(bma423_feature_update(dev, info->feature, info->enable, enable ? info->enable : 0));
+
+    const uint8_t int1_map = enable ? (data->int1_map | info->int_bit) : (data->int1_map & ~info->int_bit);
+    CHECK_OK(bma423_bus_write(dev, BMA423_REG_INT1_MAP, int1_map));
+
+    data->triggers[index] = trig;
+    data->trigger_handlers[index] = handler;
+    data->int1_map = int1_map;
+
+    bma423_int1_update(dev);
+    return 0;
+}
+
+void bma423_trigger_handle(const struct device *dev, uint8_t int_status)
+{
+    struct bma423_data *data = dev->data;
+
+    if (int_status & BMA423_FEATURE_INT_ERROR)
+    {
+        LOG_WRN("Feature engine error");
+    }
+
+    for (size_t i = 0; i < BMA423_TRIGGER_COUNT; i++)
+    {
+        const sensor_trigger_handler_t handler = data->trigger_handlers[i];
+        if ((int_status & bma423_triggers[i].int_bit) && handler != NULL)
+        {
+            data->stats.feature_events++;
+            handler(dev, data->triggers[i]);
+        }
+    }
+}
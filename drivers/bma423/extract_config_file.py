@@ -0,0 +1,41 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+# SPDX-License-Identifier: Apache-2.0
+
+"""Extract the BMA423 feature engine config file from Bosch's SensorAPI.
+
+bma423.c in https://github.com/boschsensortec/BMA423_SensorAPI carries it as
+the bma423_config_file[] array. This writes it out as the binary file that
+CONFIG_BMA423_FEATURE_CONFIG_FILE points to.
+"""
+
+import argparse
+import re
+import sys
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("source", help="bma423.c from the BMA423 SensorAPI")
+    parser.add_argument("output", help="binary config file to write")
+    args = parser.parse_args()
+
+    with open(args.source, encoding="utf-8") as f:
+        source = f.read()
+
+    match = re.search(r"bma423_config_file\[\]\s*=\s*\{(.*?)\};", source, re.DOTALL)
+    if match is None:
+        sys.exit(f"no bma423_config_file[] in {args.source}")
+
+    blob = bytes(int(value, 16) for value in re.findall(r"0x[0-9a-fA-F]{1,2}", match.group(1)))
+    if len(blob) % 2 != 0:
+        sys.exit(f"config file is {len(blob)} bytes, expected 16-bit words")
+
+    with open(args.output, "wb") as f:
+        f.write(blob)
+
+    print(f"{args.output}: {len(blob)} bytes")
+
+
+if __name__ == "__main__":
+    main()
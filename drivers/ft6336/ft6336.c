@@ -0,0 +1,466 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <zephyr/drivers/input/ft6336.h>
+
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/input/input.h>
+#include <zephyr/pm/device.h>
+#include <zephyr/pm/device_runtime.h>
+#include <zephyr/sys/util.h>
+
+#ifdef CONFIG_FT6336_LIGHT_SLEEP_WAKE
+#include <zephyr/init.h>
+#include <zephyr/pm/pm.h>
+
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#endif
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(ft6336, CONFIG_FT6336_LOG_LEVEL);
+
+#define DT_DRV_COMPAT focaltech_ft6336
+
+#define FT6336_REG_TD_STATUS 0x02
+#define FT6336_REG_G_CTRL 0x86
+#define FT6336_REG_G_PERIODMONITOR 0x89
+#define FT6336_REG_CHIP_ID 0xA3
+#define FT6336_REG_G_MODE 0xA4
+#define FT6336_REG_G_PMODE 0xA5
+
+#define FT6336_TD_STATUS_POINTS_MASK GENMASK(3, 0)
+#define FT6336_P1_EVENT_MASK GENMASK(7, 6)
+#define FT6336_P1_POSITION_H_MASK GENMASK(3, 0)
+
+#define FT6336_EVENT_PRESS_DOWN 0
+#define FT6336_EVENT_CONTACT 2
+
+#define FT6336_G_CTRL_KEEP_ACTIVE 0
+#define FT6336_G_MODE_TRIGGER 1
+#define FT6336_PMODE_ACTIVE 0
+#define FT6336_PMODE_MONITOR 1
+
+struct ft6336_config
+{
+    struct i2c_dt_spec i2c;
+    struct gpio_dt_spec int_gpio;
+    uint8_t monitor_period;
+    uint32_t idle_timeout_ms;
+};
+
+struct ft6336_data
+{
+    const struct device *dev;
+    struct k_work work;
+    struct gpio_callback int_cb;
+    // owned by the work item
+    bool pressed;
+
+    // The interrupt and the light sleep exit stamp the start of a wake,
+    // and the work item that reports it accounts for it. Set from the ISR
+    // and the idle thread, hence the spinlock.
+    struct k_spinlock lock;
+    bool monitor;
+    bool irq_pending;
+    uint32_t irq_at;
+    bool sleep_pending;
+    uint32_t sleep_at;
+    struct ft6336_stats stats;
+};
+
+static void ft6336_isr(const struct device *port, struct gpio_callback *cb, gpio_port_pins_t pins)
+{
+    ARG_UNUSED(port);
+    ARG_UNUSED(pins);
+    struct ft6336_data *data = CONTAINER_OF(cb, struct ft6336_data, int_cb);
+
+    K_SPINLOCK(&data->lock)
+    {
+        if (!data->irq_pending)
+        {
+            data->irq_at = k_cycle_get_32();
+            data->irq_pending = true;
+        }
+    }
+    k_work_submit(&data->work);
+}
+
+// Reads one report and passes it on. Returns 1 if it made an input event.
+static int ft6336_process(const struct device *dev)
+{
+    const struct ft6336_config *config = dev->config;
+    struct ft6336_data *data = dev->data;
+
+    // TD_STATUS, then the first point's P1_XH, P1_XL, P1_YH and P1_YL
+    uint8_t buf[5];
+    int ret = i2c_burst_read_dt(&config->i2c, FT6336_REG_TD_STATUS, buf, sizeof(buf));
+    if (ret < 0)
+    {
+        return ret;
+    }
+
+    K_SPINLOCK(&data->lock)
+    {
+        data->stats.reports++;
+    }
+
+    const uint8_t event = FIELD_GET(FT6336_P1_EVENT_MASK, buf[1]);
+    const bool pressed = FIELD_GET(FT6336_TD_STATUS_POINTS_MASK, buf[0]) > 0 &&
+                         (event == FT6336_EVENT_PRESS_DOWN || event == FT6336_EVENT_CONTACT);
+    const bool was_pressed = data->pressed;
+    data->pressed = pressed;
+
+    if (pressed)
+    {
+        // like Zephyr's ft5336 driver, X comes from the controller's Y
+        // registers and Y from its X registers, so the consumers' swap-xy
+        // still applies
+        const int32_t row = (FIELD_GET(FT6336_P1_POSITION_H_MASK, buf[1]) << 8) | buf[2];
+        const int32_t col = (FIELD_GET(FT6336_P1_POSITION_H_MASK, buf[3]) << 8) | buf[4];
+        input_report_abs(dev, INPUT_ABS_X, col, false, K_FOREVER);
+        input_report_abs(dev, INPUT_ABS_Y, row, false, K_FOREVER);
+        input_report_key(dev, INPUT_BTN_TOUCH, 1, true, K_FOREVER);
+        return 1;
+    }
+    if (was_pressed)
+    {
+        input_report_key(dev, INPUT_BTN_TOUCH, 0, true, K_FOREVER);
+        return 1;
+    }
+
+    return 0;
+}
+
+// Marks the device busy, resuming it if this is the contact that ended
+// monitor mode
+static int ft6336_get(const struct device *dev)
+{
+#ifdef CONFIG_PM_DEVICE
+    if (pm_device_runtime_is_enabled(dev))
+    {
+        return pm_device_runtime_get(dev);
+    }
+
+    // suspended by hand: the contact ends it all the same
+    enum pm_device_state state;
+    if (pm_device_state_get(dev, &state) == 0 && state == PM_DEVICE_STATE_SUSPENDED)
+    {
+        return pm_device_action_run(dev, PM_DEVICE_ACTION_RESUME);
+    }
+#endif
+
+    return 0;
+}
+
+// Suspends the device once no report has come for idle-timeout-ms
+static void ft6336_put(const struct device *dev)
+{
+    const struct ft6336_config *config = dev->config;
+
+    if (pm_device_runtime_is_enabled(dev))
+    {
+        (void)pm_device_runtime_put_async(dev, K_MSEC(config->idle_timeout_ms));
+    }
+}
+
+static void ft6336_work_handler(struct k_work *work)
+{
+    struct ft6336_data *data = CONTAINER_OF(work, struct ft6336_data, work);
+    const struct device *dev = data->dev;
+
+    bool from_monitor;
+    bool from_sleep;
+    uint32_t wake_at;
+    K_SPINLOCK(&data->lock)
+    {
+        from_monitor = data->monitor;
+        from_sleep = data->sleep_pending;
+        wake_at = from_sleep ? data->sleep_at : data->irq_at;
+        data->irq_pending = false;
+        data->sleep_pending = false;
+    }
+
+    const int ret = ft6336_process(dev);
+    if (ret <= 0)
+    {
+        if (ret < 0)
+        {
+            LOG_ERR("Failed to read the report: %d", ret);
+        }
+        // no contact (or a wake by some other pin): stay as suspended as we were
+        return;
+    }
+
+    if (from_monitor || from_sleep)
+    {
+        const uint32_t wake_us = k_cyc_to_us_floor32(k_cycle_get_32() - wake_at);
+        K_SPINLOCK(&data->lock)
+        {
+            data->stats.wakes += from_monitor;
+            data->stats.sleep_wakes += from_sleep;
+            data->stats.last_wake_us = wake_us;
+            data->stats.max_wake_us = MAX(data->stats.max_wake_us, wake_us);
+        }
+        LOG_DBG("First event %u us after the wake", wake_us);
+    }
+
+    // In monitor mode, the controller went back to full rate scanning by
+    // itself on contact. Resuming keeps it there until the device is idle.
+    const int held = ft6336_get(dev);
+    if (held < 0)
+    {
+        LOG_ERR("Failed to resume: %d", held);
+        return;
+    }
+    ft6336_put(dev);
+}
+
+void ft6336_stats_get(const struct device *dev, struct ft6336_stats *stats)
+{
+    struct ft6336_data *data = dev->data;
+
+    K_SPINLOCK(&data->lock)
+    {
+        *stats = data->stats;
+    }
+}
+
+void ft6336_stats_reset(const struct device *dev)
+{
+    struct ft6336_data *data = dev->data;
+
+    K_SPINLOCK(&data->lock)
+    {
+        data->stats = (struct ft6336_stats){0};
+    }
+}
+
+#ifdef CONFIG_PM_DEVICE
+static int ft6336_pm_action(const struct device *dev, enum pm_device_action action)
+{
+    const struct ft6336_config *config = dev->config;
+    struct ft6336_data *data = dev->data;
+    int ret;
+
+    switch (action)
+    {
+    case PM_DEVICE_ACTION_SUSPEND:
+        // the interrupt stays armed: a contact is what wakes it
+        ret = i2c_reg_write_byte_dt(&config->i2c, FT6336_REG_G_PMODE, FT6336_PMODE_MONITOR);
+        if (ret < 0)
+        {
+            return ret;
+        }
+        K_SPINLOCK(&data->lock)
+        {
+            data->monitor = true;
+            data->stats.suspends++;
+        }
+        break;
+    case PM_DEVICE_ACTION_RESUME:
+        ret = i2c_reg_write_byte_dt(&config->i2c, FT6336_REG_G_PMODE, FT6336_PMODE_ACTIVE);
+        if (ret < 0)
+        {
+            return ret;
+        }
+        K_SPINLOCK(&data->lock)
+        {
+            data->monitor = false;
+        }
+        break;
+    default:
+        return -ENOTSUP;
+    }
+
+    return 0;
+}
+#endif
+
+static int ft6336_init(const struct device *dev)
+{
+    const struct ft6336_config *config = dev->config;
+    struct ft6336_data *data = dev->data;
+    int ret;
+
+    if (!i2c_is_ready_dt(&config->i2c))
+    {
+        LOG_ERR("I2C bus not ready");
+        return -ENODEV;
+    }
+    if (!gpio_is_ready_dt(&config->int_gpio))
+    {
+        LOG_ERR("Interrupt GPIO not ready");
+        return -ENODEV;
+    }
+
+    k_work_init(&data->work, ft6336_work_handler);
+
+    uint8_t chip_id;
+    ret = i2c_reg_read_byte_dt(&config->i2c, FT6336_REG_CHIP_ID, &chip_id);
+    if (ret < 0)
+    {
+        LOG_ERR("No answer from the controller: %d", ret);
+        return ret;
+    }
+    LOG_DBG("Chip ID 0x%02x", chip_id);
+
+    // Pulse INT once per report, and never enter monitor mode on its own:
+    // the device's PM state is the controller's power mode
+    const uint8_t setup[][2] = {
+        {FT6336_REG_G_MODE, FT6336_G_MODE_TRIGGER},
+        {FT6336_REG_G_CTRL, FT6336_G_CTRL_KEEP_ACTIVE},
+        {FT6336_REG_G_PERIODMONITOR, config->monitor_period},
+        {FT6336_REG_G_PMODE, FT6336_PMODE_ACTIVE},
+    };
+    for (size_t i = 0; i < ARRAY_SIZE(setup); i++)
+    {
+        ret = i2c_reg_write_byte_dt(&config->i2c, setup[i][0], setup[i][1]);
+        if (ret < 0)
+        {
+            LOG_ERR("Failed to write 0x%02x: %d", setup[i][0], ret);
+            return ret;
+        }
+    }
+
+    ret = gpio_pin_configure_dt(&config->int_gpio, GPIO_INPUT);
+    if (ret < 0)
+    {
+        return ret;
+    }
+    gpio_init_callback(&data->int_cb, ft6336_isr, BIT(config->int_gpio.pin));
+    ret = gpio_add_callback_dt(&config->int_gpio, &data->int_cb);
+    if (ret < 0)
+    {
+        return ret;
+    }
+    ret = gpio_pin_interrupt_configure_dt(&config->int_gpio, GPIO_INT_EDGE_TO_ACTIVE);
+    if (ret < 0)
+    {
+        return ret;
+    }
+
+#ifdef CONFIG_PM_DEVICE
+    if (pm_device_wakeup_is_capable(dev))
+    {
+        (void)pm_device_wakeup_enable(dev, true);
+    }
+#endif
+
+    LOG_DBG("Initialized");
+    return 0;
+}
+
+#define FT6336_DEFINE(inst)                                                                                            \
+    BUILD_ASSERT(DT_INST_PROP(inst, monitor_period) > 0 && DT_INST_PROP(inst, monitor_period) <= UINT8_MAX,            \
+                 "monitor-period is a one byte register value");                                                       \
+    static const struct ft6336_config ft6336_config_##inst = {                                                         \
+        .i2c = I2C_DT_SPEC_INST_GET(inst),                                                                             \
+        .int_gpio = GPIO_DT_SPEC_INST_GET(inst, int_gpios),                                                            \
+        .monitor_period = DT_INST_PROP(inst, monitor_period),                                                          \
+        .idle_timeout_ms = DT_INST_PROP(inst, idle_timeout_ms),                                                        \
+    };                                                                                                                 \
+    static struct ft6336_data ft6336_data_##inst = {                                                                   \
+        .dev = DEVICE_DT_INST_GET(inst),                                                                               \
+    };                                                                                                                 \
+    PM_DEVICE_DT_INST_DEFINE(inst, ft6336_pm_action);                                                                  \
+    DEVICE_DT_INST_DEFINE(inst, ft6336_init, PM_DEVICE_DT_INST_GET(inst), &ft6336_data_##inst, &ft6336_config_##inst,  \
+                          POST_KERNEL, CONFIG_INPUT_INIT_PRIORITY, NULL);
+
+DT_INST_FOREACH_STATUS_OKAY(FT6336_DEFINE)
+
+#ifdef CONFIG_FT6336_LIGHT_SLEEP_WAKE
+#define FT6336_DEVICE_GET(inst) DEVICE_DT_INST_GET(inst),
+
+static const struct device *const ft6336_devices[] = {DT_INST_FOREACH_STATUS_OKAY(FT6336_DEVICE_GET)};
+
+static bool ft6336_wakes(const struct device *dev)
+{
+    return device_is_ready(dev) && pm_device_wakeup_is_enabled(dev);
+}
+
+// INT is a level wakeup while the SoC light sleeps. That setting replaces
+// the pin's edge interrupt, so it only holds for the duration of the
+// sleep, and the edge interrupt comes back afterwards.
+static void ft6336_state_entry(enum pm_state state)
+{
+    if (state != PM_STATE_STANDBY)
+    {
+        return;
+    }
+
+    bool armed = false;
+    ARRAY_FOR_EACH(ft6336_devices, i)
+    {
+        const struct ft6336_config *config = ft6336_devices[i]->config;
+        if (!ft6336_wakes(ft6336_devices[i]))
+        {
+            continue;
+        }
+
+        const bool active_low = config->int_gpio.dt_flags & GPIO_ACTIVE_LOW;
+        gpio_wakeup_enable(config->int_gpio.pin, active_low ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+        armed = true;
+    }
+
+    if (armed)
+    {
+        esp_sleep_enable_gpio_wakeup();
+    }
+}
+
+static void ft6336_state_exit(enum pm_state state)
+{
+    if (state != PM_STATE_STANDBY)
+    {
+        return;
+    }
+
+    const uint32_t now = k_cycle_get_32();
+    const bool by_gpio = esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO;
+
+    ARRAY_FOR_EACH(ft6336_devices, i)
+    {
+        const struct ft6336_config *config = ft6336_devices[i]->config;
+        struct ft6336_data *data = ft6336_devices[i]->data;
+        if (!ft6336_wakes(ft6336_devices[i]))
+        {
+            continue;
+        }
+
+        gpio_wakeup_disable(config->int_gpio.pin);
+        (void)gpio_pin_interrupt_configure_dt(&config->int_gpio, GPIO_INT_EDGE_TO_ACTIVE);
+
+        if (by_gpio)
+        {
+            // The pulse that woke the SoC was spent on the wake, and may
+            // be over already: read the report regardless
+            K_SPINLOCK(&data->lock)
+            {
+                data->sleep_at = now;
+                data->sleep_pending = true;
+            }
+            k_work_submit(&data->work);
+        }
+    }
+}
+
+static struct pm_notifier ft6336_notifier = {
+    .state_entry = ft6336_state_entry,
+    .state_exit = ft6336_state_exit,
+};
+
+static int ft6336_light_sleep_init(void)
+{
+    pm_notifier_register(&ft6336_notifier);
+    return 0;
+}
+
+SYS_INIT(ft6336_light_sleep_init, POST_KERNEL, CONFIG_INPUT_INIT_PRIORITY);
+#endif
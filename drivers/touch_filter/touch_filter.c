@@ -0,0 +1,293 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <t_watch_s3/touch_filter.h>
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/input/input.h>
+#include <zephyr/sys/util.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(touch_filter, CONFIG_TOUCH_FILTER_LOG_LEVEL);
+
+#define DT_DRV_COMPAT lilygo_touch_filter
+
+struct touch_filter_config
+{
+    uint16_t report_interval_ms;
+    uint16_t tap_slop;
+    uint16_t long_press_ms;
+    uint16_t swipe_min;
+    uint16_t swipe_max_ms;
+    bool swap_xy;
+};
+
+struct touch_filter_point
+{
+    int32_t x;
+    int32_t y;
+};
+
+struct touch_filter_data
+{
+    const struct device *dev;
+    // held by the input callback and the long press work, which both run
+    // in threads, while they report
+    struct k_mutex lock;
+    struct k_work_delayable long_press_work;
+
+    // the controller's report being put together
+    struct touch_filter_point raw;
+    bool raw_pressed;
+
+    // what was last passed on
+    struct touch_filter_point reported;
+    bool pressed;
+    uint32_t reported_ms;
+
+    // the touch so far
+    struct touch_filter_point start;
+    uint32_t start_ms;
+    bool in_slop;
+    bool long_pressed;
+
+    struct touch_filter_stats stats;
+    uint32_t cpu_cycles;
+    uint32_t cpu_max_cycles;
+};
+
+static void touch_filter_report(struct touch_filter_data *data, uint8_t type, uint16_t code, int32_t value, bool sync)
+{
+    // the input thread may be the one calling: never wait on its queue
+    if (input_report(data->dev, type, code, value, sync, K_NO_WAIT) != 0)
+    {
+        data->stats.dropped++;
+        return;
+    }
+    data->stats.events_out++;
+    if (sync)
+    {
+        data->stats.reports_out++;
+    }
+}
+
+static void touch_filter_gesture(struct touch_filter_data *data, enum touch_gesture gesture)
+{
+    LOG_DBG("gesture %d", gesture);
+    data->stats.gestures[gesture]++;
+    touch_filter_report(data, INPUT_EV_KEY, TOUCH_GESTURE_INPUT_CODE(gesture), 1, true);
+    touch_filter_report(data, INPUT_EV_KEY, TOUCH_GESTURE_INPUT_CODE(gesture), 0, true);
+}
+
+static void touch_filter_report_position(struct touch_filter_data *data, bool sync)
+{
+    touch_filter_report(data, INPUT_EV_ABS, INPUT_ABS_X, data->raw.x, false);
+    touch_filter_report(data, INPUT_EV_ABS, INPUT_ABS_Y, data->raw.y, sync);
+    data->reported = data->raw;
+}
+
+static enum touch_gesture touch_filter_swipe(const struct touch_filter_config *config, int32_t dx, int32_t dy)
+{
+    if (config->swap_xy)
+    {
+        const int32_t tmp = dx;
+        dx = dy;
+        dy = tmp;
+    }
+    if (ABS(dx) > ABS(dy))
+    {
+        return dx > 0 ? TOUCH_GESTURE_SWIPE_RIGHT : TOUCH_GESTURE_SWIPE_LEFT;
+    }
+    return dy > 0 ? TOUCH_GESTURE_SWIPE_DOWN : TOUCH_GESTURE_SWIPE_UP;
+}
+
+static void touch_filter_press(const struct touch_filter_config *config, struct touch_filter_data *data, uint32_t now)
+{
+    touch_filter_report_position(data, false);
+    touch_filter_report(data, INPUT_EV_KEY, INPUT_BTN_TOUCH, 1, true);
+    data->pressed = true;
+    data->reported_ms = now;
+
+    data->start = data->raw;
+    data->start_ms = now;
+    data->in_slop = true;
+    data->long_pressed = false;
+    k_work_reschedule(&data->long_press_work, K_MSEC(config->long_press_ms));
+}
+
+static void touch_filter_move(const struct touch_filter_config *config, struct touch_filter_data *data, uint32_t now)
+{
+    if (data->in_slop &&
+        (ABS(data->raw.x - data->start.x) > config->tap_slop || ABS(data->raw.y - data->start.y) > config->tap_slop))
+    {
+        // neither a tap nor a long press any more
+        data->in_slop = false;
+        k_work_cancel_delayable(&data->long_press_work);
+    }
+
+    if (data->raw.x == data->reported.x && data->raw.y == data->reported.y)
+    {
+        data->stats.duplicates++;
+        return;
+    }
+    if (now - data->reported_ms < config->report_interval_ms)
+    {
+        // the latest position goes out with the next report, or the release
+        data->stats.rate_limited++;
+        return;
+    }
+    touch_filter_report_position(data, true);
+    data->reported_ms = now;
+}
+
+static void touch_filter_release(const struct touch_filter_config *config, struct touch_filter_data *data,
+                                 uint32_t now)
+{
+    k_work_cancel_delayable(&data->long_press_work);
+
+    // where the finger left the panel, even if that move was rate limited
+    if (data->raw.x != data->reported.x || data->raw.y != data->reported.y)
+    {
+        touch_filter_report_position(data, false);
+    }
+    touch_filter_report(data, INPUT_EV_KEY, INPUT_BTN_TOUCH, 0, true);
+    data->pressed = false;
+
+    const uint32_t duration = now - data->start_ms;
+    const int32_t dx = data->raw.x - data->start.x;
+    const int32_t dy = data->raw.y - data->start.y;
+    if (data->long_pressed)
+    {
+        return;
+    }
+    if (data->in_slop)
+    {
+        touch_filter_gesture(data, TOUCH_GESTURE_TAP);
+    }
+    else if (MAX(ABS(dx), ABS(dy)) >= config->swipe_min && duration <= config->swipe_max_ms)
+    {
+        touch_filter_gesture(data, touch_filter_swipe(config, dx, dy));
+    }
+}
+
+static void touch_filter_long_press(struct k_work *work)
+{
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct touch_filter_data *data = CONTAINER_OF(dwork, struct touch_filter_data, long_press_work);
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    if (data->pressed && data->in_slop && !data->long_pressed)
+    {
+        data->long_pressed = true;
+        touch_filter_gesture(data, TOUCH_GESTURE_LONG_PRESS);
+    }
+    k_mutex_unlock(&data->lock);
+}
+
+// Runs for every event the controller reports, so everything here is O(1)
+// and nothing waits on the input queue
+static void touch_filter_input_cb(struct input_event *evt, void *user_data)
+{
+    const struct device *dev = user_data;
+    const struct touch_filter_config *config = dev->config;
+    struct touch_filter_data *data = dev->data;
+    const uint32_t start = k_cycle_get_32();
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    data->stats.events_in++;
+    if (evt->type == INPUT_EV_ABS && evt->code == INPUT_ABS_X)
+    {
+        data->raw.x = evt->value;
+    }
+    else if (evt->type == INPUT_EV_ABS && evt->code == INPUT_ABS_Y)
+    {
+        data->raw.y = evt->value;
+    }
+    else if (evt->type == INPUT_EV_KEY && evt->code == INPUT_BTN_TOUCH)
+    {
+        data->raw_pressed = evt->value != 0;
+    }
+
+    if (evt->sync)
+    {
+        data->stats.reports_in++;
+        const uint32_t now = k_uptime_get_32();
+        if (data->raw_pressed && !data->pressed)
+        {
+            touch_filter_press(config, data, now);
+        }
+        else if (data->raw_pressed)
+        {
+            touch_filter_move(config, data, now);
+        }
+        else if (data->pressed)
+        {
+            touch_filter_release(config, data, now);
+        }
+        else
+        {
+            // a release without a press
+            data->stats.duplicates++;
+        }
+    }
+
+    const uint32_t cycles = k_cycle_get_32() - start;
+    data->cpu_cycles += cycles;
+    data->cpu_max_cycles = MAX(data->cpu_max_cycles, cycles);
+    k_mutex_unlock(&data->lock);
+}
+
+void touch_filter_stats_get(const struct device *dev, struct touch_filter_stats *stats)
+{
+    struct touch_filter_data *data = dev->data;
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    *stats = data->stats;
+    stats->cpu_us = k_cyc_to_us_floor32(data->cpu_cycles);
+    stats->cpu_max_ns = k_cyc_to_ns_floor32(data->cpu_max_cycles);
+    k_mutex_unlock(&data->lock);
+}
+
+void touch_filter_stats_reset(const struct device *dev)
+{
+    struct touch_filter_data *data = dev->data;
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    memset(&data->stats, 0, sizeof(data->stats));
+    data->cpu_cycles = 0;
+    data->cpu_max_cycles = 0;
+    k_mutex_unlock(&data->lock);
+}
+
+static int touch_filter_init(const struct device *dev)
+{
+    struct touch_filter_data *data = dev->data;
+
+    k_mutex_init(&data->lock);
+    k_work_init_delayable(&data->long_press_work, touch_filter_long_press);
+    return 0;
+}
+
+#define TOUCH_FILTER_DEFINE(inst)                                                                                      \
+    BUILD_ASSERT(DT_INST_PROP(inst, long_press_ms) > 0, "long-press-ms must be positive");                             \
+    static const struct touch_filter_config touch_filter_config_##inst = {                                             \
+        .report_interval_ms = DT_INST_PROP(inst, report_interval_ms),                                                  \
+        .tap_slop = DT_INST_PROP(inst, tap_slop_px),                                                                   \
+        .long_press_ms = DT_INST_PROP(inst, long_press_ms),                                                            \
+        .swipe_min = DT_INST_PROP(inst, swipe_min_px),                                                                 \
+        .swipe_max_ms = DT_INST_PROP(inst, swipe_max_ms),                                                              \
+        .swap_xy = DT_INST_PROP(inst, swap_xy),                                                                        \
+    };                                                                                                                 \
+    static struct touch_filter_data touch_filter_data_##inst = {                                                       \
+        .dev = DEVICE_DT_INST_GET(inst),                                                                               \
+    };                                                                                                                 \
+    INPUT_CALLBACK_DEFINE_NAMED(DEVICE_DT_GET(DT_INST_PHANDLE(inst, input)), touch_filter_input_cb,                    \
+                                (void *)DEVICE_DT_INST_GET(inst), touch_filter_cb_##inst);                             \
+    DEVICE_DT_INST_DEFINE(inst, touch_filter_init, NULL, &touch_filter_data_##inst, &touch_filter_config_##inst,       \
+                          POST_KERNEL, CONFIG_INPUT_INIT_PRIORITY, NULL);
+
+DT_INST_FOREACH_STATUS_OKAY(TOUCH_FILTER_DEFINE)
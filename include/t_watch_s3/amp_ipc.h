@@ -0,0 +1,53 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef T_WATCH_S3_AMP_IPC_H
+#define T_WATCH_S3_AMP_IPC_H
+
+#include <stddef.h>
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Zero-copy messaging between PROCPU and APPCPU.
+//
+// Sending: amp_ipc_alloc() a buffer in shared memory, fill it in place,
+// then amp_ipc_send() it. Receiving: amp_ipc_claim() the oldest message,
+// use it in place, then amp_ipc_release() it. Each direction is a single
+// producer/single consumer ring, so on each core only one thread may send
+// and only one thread may receive at a time. Received messages must be
+// released in the order they were claimed, one at a time.
+//
+// Either core may restart on its own. The other one notices, starts its
+// outgoing ring again for the new boot and drops whatever was in flight;
+// amp_ipc_wait_ready() waits for that on both sides.
+
+// Wait for the other core to come up and attach to the channel
+int amp_ipc_wait_ready(k_timeout_t timeout);
+
+// Reserve len bytes in the outgoing ring. Blocks until there is room or
+// the timeout expires (-EAGAIN). -EMSGSIZE if len can never fit.
+int amp_ipc_alloc(void **buf, size_t len, k_timeout_t timeout);
+
+// Hand a buffer from amp_ipc_alloc() over to the other core. len may be
+// smaller than what was allocated. Every successful amp_ipc_alloc() must be
+// followed by this, from the same thread: the ring is held in between.
+int amp_ipc_send(void *buf, size_t len);
+
+// Get the oldest incoming message. Returns its length, or -EAGAIN.
+int amp_ipc_claim(void **buf, k_timeout_t timeout);
+
+// Give a claimed message back to the sender
+void amp_ipc_release(void *buf, size_t len);
+
+// Largest message that can ever be allocated in one go
+size_t amp_ipc_max_len(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // T_WATCH_S3_AMP_IPC_H
@@ -0,0 +1,67 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef T_WATCH_S3_DISPLAY_IDLE_H
+#define T_WATCH_S3_DISPLAY_IDLE_H
+
+#include <stdint.h>
+#include <zephyr/sys/slist.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Ordered from most to least awake. Each state includes everything
+// done by the ones before it (e.g. SLEEP is also blanked and dark).
+enum display_idle_state
+{
+    DISPLAY_IDLE_ACTIVE,
+    DISPLAY_IDLE_DIM,
+    DISPLAY_IDLE_BLANK,
+    DISPLAY_IDLE_SLEEP,
+    DISPLAY_IDLE_OFF,
+};
+
+struct display_idle_stats
+{
+    uint32_t wakes;
+    uint32_t budget_misses;
+    uint32_t last_wake_us;
+    uint32_t max_wake_us;
+};
+
+struct display_idle_callback;
+
+// Called from the system workqueue on every state change. When waking
+// from DISPLAY_IDLE_OFF the frame memory is gone: the callback must redraw
+// before returning, since the backlight comes back on right after.
+typedef void (*display_idle_callback_handler_t)(struct display_idle_callback *cb,
+                                                enum display_idle_state from,
+                                                enum display_idle_state to);
+
+struct display_idle_callback
+{
+    sys_snode_t node;
+    display_idle_callback_handler_t handler;
+};
+
+// Report user activity. Cheap enough to call from input callbacks. The
+// touch and buttons aliases are already hooked up by the idle manager.
+void display_idle_kick(void);
+
+// Jump straight to a state (e.g. blank on wrist-down). Going up wakes
+// the panel synchronously, going down ignores the hold-off time.
+int display_idle_enter(enum display_idle_state state);
+
+enum display_idle_state display_idle_state_get(void);
+
+void display_idle_stats_get(struct display_idle_stats *stats);
+
+void display_idle_add_callback(struct display_idle_callback *cb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // T_WATCH_S3_DISPLAY_IDLE_H
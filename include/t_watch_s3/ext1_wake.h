@@ -0,0 +1,30 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef T_WATCH_S3_EXT1_WAKE_H
+#define T_WATCH_S3_EXT1_WAKE_H
+
+#include <stdbool.h>
+#include <zephyr/drivers/gpio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Wake from deep sleep when pin goes active. The ESP32-S3 has one EXT1
+// mask and one level for all of its pins, so pins are only added, never
+// replaced, and all of them must be active low.
+int ext1_wake_add(const struct gpio_dt_spec *pin);
+
+// Arm every pin added so far, right before sys_poweroff()
+void ext1_wake_enable(void);
+
+// True if this boot is a deep sleep wake by pin
+bool ext1_wake_from(const struct gpio_dt_spec *pin);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // T_WATCH_S3_EXT1_WAKE_H
@@ -0,0 +1,75 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef T_WATCH_S3_FLASH_ASSETS_H
+#define T_WATCH_S3_FLASH_ASSETS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The image in assets_partition, as lib/flash_assets/mkassets.py writes it,
+// little endian:
+//
+//   | header | entry | entry | ... | asset data ...
+//
+// Entries are sorted by name, and their data is aligned to 4 bytes. The
+// header's CRC covers the header before it and the entries; each entry's
+// CRC covers its data.
+#define FLASH_ASSETS_MAGIC    0x53415754 // "TWAS"
+#define FLASH_ASSETS_VERSION  1
+#define FLASH_ASSETS_NAME_LEN 20
+
+struct flash_assets_header
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+    // of the whole image
+    uint32_t size;
+    uint32_t crc32;
+};
+
+struct flash_assets_entry
+{
+    // NUL padded, so at most FLASH_ASSETS_NAME_LEN - 1 characters
+    char name[FLASH_ASSETS_NAME_LEN];
+    // from the start of the image
+    uint32_t offset;
+    uint32_t size;
+    uint32_t crc32;
+};
+
+struct flash_asset
+{
+    // read-only, straight out of flash through the cache
+    const void *data;
+    size_t size;
+    uint32_t crc32;
+};
+
+// Map the image in assets_partition and check its header. Runs at boot.
+// After the partition has been rewritten (an update over the air), call
+// flash_assets_unmap() before writing and this again after.
+int flash_assets_init(void);
+
+// Pointers from flash_assets_get() are not valid after this
+void flash_assets_unmap(void);
+
+// Find an asset by name. -ENOENT if there is none, -ENODEV if no image is
+// mapped. The data is not checked: see flash_assets_check().
+int flash_assets_get(const char *name, struct flash_asset *asset);
+
+// Check an asset's data against its CRC, reading all of it: -EBADMSG if it
+// doesn't match
+int flash_assets_check(const struct flash_asset *asset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // T_WATCH_S3_FLASH_ASSETS_H
@@ -0,0 +1,69 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef T_WATCH_S3_FRAME_PACER_H
+#define T_WATCH_S3_FRAME_PACER_H
+
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/display.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Marks the last rectangle of a frame. Nothing is flushed until a frame is complete.
+#define FRAME_PACER_FLAG_LAST BIT(0)
+// Set together with FRAME_PACER_FLAG_LAST when the frame covers the whole
+// screen, so any older frame still waiting can be dropped
+#define FRAME_PACER_FLAG_FULL BIT(1)
+
+struct frame_pacer_rect;
+
+// Called from the pacer thread once the rectangle's buffer is no longer needed.
+// status is 0 if it was written, -ECANCELED if the frame was dropped, or the
+// error returned by display_write().
+typedef void (*frame_pacer_done_t)(const struct frame_pacer_rect *rect, int status, void *user_data);
+
+struct frame_pacer_rect
+{
+    uint16_t x;
+    uint16_t y;
+    struct display_buffer_descriptor desc;
+    const void *buf;
+    uint8_t flags;
+    frame_pacer_done_t done;
+    void *user_data;
+};
+
+struct frame_pacer_stats
+{
+    uint32_t presented;
+    uint32_t dropped;
+    // frames that became ready late and were flushed in the same slot as another
+    uint32_t merged;
+    // slots that passed while a flush was still running
+    uint32_t missed_slots;
+    // time between the start of two consecutive flushes
+    uint32_t interval_ms[CONFIG_T_WATCH_S3_FRAME_PACER_HISTOGRAM_BINS];
+    // time from the start to the end of a flush
+    uint32_t flush_ms[CONFIG_T_WATCH_S3_FRAME_PACER_HISTOGRAM_BINS];
+};
+
+// Queue one rectangle. The rectangle is copied, but buf must stay valid
+// until its done callback runs.
+int frame_pacer_submit(const struct frame_pacer_rect *rect, k_timeout_t timeout);
+
+// Panel refresh period, and the flush period (refresh period times the divider)
+uint32_t frame_pacer_panel_period_ns(void);
+uint32_t frame_pacer_period_ns(void);
+
+void frame_pacer_stats_get(struct frame_pacer_stats *stats);
+void frame_pacer_stats_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // T_WATCH_S3_FRAME_PACER_H
@@ -0,0 +1,107 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef T_WATCH_S3_HAPTIC_QUEUE_H
+#define T_WATCH_S3_HAPTIC_QUEUE_H
+
+#include <stdint.h>
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Sequences of the DRV2605's ROM effects (ERM library TS2200 D)
+enum haptic_effect
+{
+    HAPTIC_EFFECT_CLICK,
+    HAPTIC_EFFECT_DOUBLE_CLICK,
+    HAPTIC_EFFECT_TICK,
+    HAPTIC_EFFECT_BUZZ,
+    // four sharp clicks, 330ms apart
+    HAPTIC_EFFECT_NOTIFY,
+    // one second long
+    HAPTIC_EFFECT_ALERT,
+    // a custom envelope, see haptic_queue_play_envelope()
+    HAPTIC_EFFECT_ENVELOPE,
+    HAPTIC_EFFECT_COUNT,
+};
+
+// Amplitudes streamed to the DRV2605's real-time playback (RTP) register,
+// one per 1/rate_hz seconds, 0 (off) to 255 (full drive)
+struct haptic_envelope
+{
+    const uint8_t *samples;
+    size_t len;
+    uint16_t rate_hz;
+};
+
+// One piece of a piecewise linear envelope: a ramp from wherever the one
+// before ended (0 for the first) to level, over ms. Equal levels hold.
+struct haptic_envelope_point
+{
+    uint8_t level;
+    uint16_t ms;
+};
+
+// Called from the system workqueue once the effect is over. status is 0 if
+// it played to the end, -ECANCELED if haptic_queue_cancel() stopped it or
+// dropped it from the queue, or the error from talking to the DRV2605.
+typedef void (*haptic_queue_done_t)(enum haptic_effect effect, int status, void *user_data);
+
+struct haptic_queue_stats
+{
+    uint32_t played;
+    uint32_t cancelled;
+    // waveform sequence registers written, and left as they were because
+    // the effect before had the same value there
+    uint32_t seq_writes;
+    uint32_t seq_skips;
+    // GO bit reads while an effect played
+    uint32_t polls;
+    // from the GO write until GO was found cleared, for the last effect
+    uint32_t last_play_ms;
+
+    // RTP streaming: samples written, and skipped because their timer
+    // period had passed already
+    uint32_t rtp_samples;
+    uint32_t rtp_missed;
+    // time spent in RTP register writes, and time spent streaming, for
+    // the bus load on i2c0
+    uint32_t rtp_bus_us;
+    uint32_t rtp_elapsed_us;
+    // how late writes started after their slot, in total and at worst
+    uint32_t rtp_total_jitter_us;
+    uint32_t rtp_max_jitter_us;
+    // the sample period of the last envelope, once rounded to kernel ticks
+    uint32_t rtp_period_us;
+};
+
+// Queue an effect behind the ones already queued, without waiting for any
+// of them. done may be NULL. Fails with -ENOMEM when the queue is full.
+int haptic_queue_play(enum haptic_effect effect, haptic_queue_done_t done, void *user_data);
+
+// Queue a custom envelope, streamed through RTP at envelope->rate_hz by a
+// timer driven thread. The envelope and its samples must stay valid until
+// done is called.
+int haptic_queue_play_envelope(const struct haptic_envelope *envelope, haptic_queue_done_t done, void *user_data);
+
+// Precompute an envelope from ramps, so nothing is left to compute while
+// it streams. Returns the number of samples written, at most max.
+size_t haptic_envelope_render(const struct haptic_envelope_point *points, size_t n_points, uint16_t rate_hz,
+                              uint8_t *samples, size_t max);
+
+// Stop the effect playing and drop every queued one
+void haptic_queue_cancel(void);
+
+const char *haptic_effect_name(enum haptic_effect effect);
+
+void haptic_queue_stats_get(struct haptic_queue_stats *stats);
+void haptic_queue_stats_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // T_WATCH_S3_HAPTIC_QUEUE_H
@@ -0,0 +1,56 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef T_WATCH_S3_LORAWAN_SESSION_H
+#define T_WATCH_S3_LORAWAN_SESSION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/lorawan/lorawan.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct lorawan_session_stats
+{
+    // a session for these EUIs was saved in flash, and whether it came
+    // back from there, so no join was needed
+    bool found;
+    bool restored;
+    // join requests sent, and how long joining took in all
+    uint32_t join_attempts;
+    uint32_t join_ms;
+    // the DevNonce of the last join request
+    uint16_t dev_nonce;
+    // uplinks through lorawan_session_send(), and saves of the session
+    uint32_t uplinks;
+    uint32_t saves;
+};
+
+// Start the stack with the session saved in flash, or join with OTAA if
+// there is none (or it is for other EUIs), retrying up to
+// CONFIG_T_WATCH_S3_LORAWAN_SESSION_JOIN_ATTEMPTS times. DevNonce is kept in
+// flash: join_cfg's only counts if it is higher than the saved one. Call it
+// instead of lorawan_start() and lorawan_join().
+int lorawan_session_start(const struct lorawan_join_config *join_cfg);
+
+// lorawan_send(), then save the session every
+// CONFIG_T_WATCH_S3_LORAWAN_SESSION_SAVE_INTERVAL uplinks, or right away if
+// the network changed the MAC's settings
+int lorawan_session_send(uint8_t port, uint8_t *data, uint8_t len, enum lorawan_message_type type);
+
+// Save the session now, before powering off for instance
+int lorawan_session_save(void);
+
+// Drop the saved session, so the next start joins again. DevNonce is kept.
+int lorawan_session_forget(void);
+
+void lorawan_session_stats_get(struct lorawan_session_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // T_WATCH_S3_LORAWAN_SESSION_H
@@ -0,0 +1,67 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef T_WATCH_S3_MOTION_GESTURE_H
+#define T_WATCH_S3_MOTION_GESTURE_H
+
+#include <stdint.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/sensor_data_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum motion_gesture
+{
+    // the arm came up and the watch face turned towards the wearer
+    MOTION_GESTURE_WRIST_RAISE,
+    // a second or so of vigorous back and forth
+    MOTION_GESTURE_SHAKE,
+    // two sharp knocks on the watch
+    MOTION_GESTURE_DOUBLE_TAP,
+    MOTION_GESTURE_COUNT,
+};
+
+// Gestures are reported as INPUT_EV_KEY on motion_gesture_device(), a press
+// immediately followed by a release, with these codes (Linux's
+// BTN_TRIGGER_HAPPY range, which nothing else on the board uses)
+#define MOTION_GESTURE_INPUT_CODE(gesture) (0x2c0 + (gesture))
+
+struct motion_gesture_stats
+{
+    uint32_t samples;
+    // CONFIG_T_WATCH_S3_MOTION_GESTURE_RATE_HZ samples each
+    uint32_t windows;
+    uint32_t events[MOTION_GESTURE_COUNT];
+    // events the input queue had no room for
+    uint32_t dropped;
+    // CPU time spent in motion_gesture_feed() for the last full window,
+    // and the worst one
+    uint32_t last_window_us;
+    uint32_t max_window_us;
+};
+
+const struct device *motion_gesture_device(void);
+
+// Run decoded IMU samples through the pipeline, at
+// CONFIG_T_WATCH_S3_MOTION_GESTURE_RATE_HZ. Any source works: the stream
+// below, or an application that already streams the IMU for itself.
+void motion_gesture_feed(const struct sensor_three_axis_data *data);
+
+// Stream the IMU's FIFO into the pipeline from a thread of its own
+// (CONFIG_T_WATCH_S3_MOTION_GESTURE_STREAM)
+int motion_gesture_start(void);
+int motion_gesture_stop(void);
+
+void motion_gesture_stats_get(struct motion_gesture_stats *stats);
+
+// Forget the filters' history and the stats, as if no sample had been seen
+void motion_gesture_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // T_WATCH_S3_MOTION_GESTURE_H
@@ -0,0 +1,56 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef T_WATCH_S3_MOTION_WAKE_H
+#define T_WATCH_S3_MOTION_WAKE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct motion_wake_stats
+{
+    uint32_t motion_events;
+    uint32_t stationary_events;
+    // light sleep exits caused by the IMU
+    uint32_t sleep_wakes;
+    // from the SoC leaving light sleep to the motion handler, which
+    // includes reading the interrupt status over I2C
+    uint32_t last_wake_us;
+    uint32_t max_wake_us;
+    // from the motion handler to motion_wake_wait() returning
+    uint32_t last_dispatch_us;
+};
+
+// Watch for motion. The IMU's any-motion and no-motion features take turns
+// on INT1: while the watch lies still only motion is armed, and while it
+// moves only stillness is, so neither keeps interrupting.
+int motion_wake_start(void);
+int motion_wake_stop(void);
+
+// Block until the watch starts moving. In between, nothing runs and the
+// SoC is free to light sleep: INT1 (GPIO14) wakes it. Motion that nobody
+// waited for counts until the watch is still again.
+int motion_wake_wait(k_timeout_t timeout);
+
+bool motion_wake_is_moving(void);
+
+// Deep sleep until the watch moves. The wake is a reset, see
+// motion_wake_from_poweroff().
+FUNC_NORETURN void motion_wake_poweroff(void);
+
+// True if this boot is a wake from motion_wake_poweroff()
+bool motion_wake_from_poweroff(void);
+
+void motion_wake_stats_get(struct motion_wake_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // T_WATCH_S3_MOTION_WAKE_H
@@ -0,0 +1,80 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef T_WATCH_S3_SERIES_CODEC_H
+#define T_WATCH_S3_SERIES_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Blocks of evenly spaced samples of up to SERIES_CODEC_MAX_CHANNELS
+// channels (3 for the BMA423, 1 for the battery voltage):
+//
+//   | version, channels | count (2 bytes) | timestamp | period | samples ...
+//
+// The timestamp (ms, e.g. Unix time) and period (ms) are varints. Each
+// sample is the difference from the one before, channel by channel
+// (from 0 for the first), zig-zag mapped so small negative differences
+// stay small too, and stored as a varint: 7 bits a byte, low bits first.
+// A block is self contained, so it can go in a telemetry log record or an
+// uplink on its own, and blocks can be stored back to back.
+#define SERIES_CODEC_VERSION      1
+#define SERIES_CODEC_MAX_CHANNELS 8
+// version and channels, count, 64 bit timestamp, 32 bit period
+#define SERIES_CODEC_HEADER_MAX (1 + 2 + 10 + 5)
+// the worst case for a sample, a 32 bit difference in every channel
+#define SERIES_CODEC_SAMPLE_MAX(channels) ((channels) * 5)
+
+struct series_encoder
+{
+    uint8_t *buf;
+    size_t size;
+    size_t len;
+    uint8_t channels;
+    uint16_t count;
+    int32_t prev[SERIES_CODEC_MAX_CHANNELS];
+};
+
+struct series_decoder
+{
+    const uint8_t *buf;
+    size_t len;
+    // once every sample has been read, the length of the block, which is
+    // where the next one starts
+    size_t pos;
+    uint8_t channels;
+    uint16_t count;
+    uint16_t index;
+    uint64_t timestamp_ms;
+    uint32_t period_ms;
+    int32_t prev[SERIES_CODEC_MAX_CHANNELS];
+};
+
+// Start a block in buf, for samples period_ms apart from timestamp_ms on
+int series_encoder_start(struct series_encoder *enc, uint8_t *buf, size_t size, uint8_t channels,
+                         uint64_t timestamp_ms, uint32_t period_ms);
+
+// Add a sample, one value per channel. Fails with -ENOSPC, leaving the
+// block as it was, once it doesn't fit: finish the block and start another.
+int series_encoder_add(struct series_encoder *enc, const int32_t *sample);
+
+// Close the block, and return its length
+size_t series_encoder_finish(struct series_encoder *enc);
+
+// Read a block's header. Fails with -EBADMSG if it is cut short or not a
+// block, and -ENOTSUP if it is from another version.
+int series_decoder_start(struct series_decoder *dec, const uint8_t *buf, size_t len);
+
+// The next sample, and when it was taken. -ENODATA after the last one.
+int series_decoder_next(struct series_decoder *dec, int32_t *sample, uint64_t *timestamp_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // T_WATCH_S3_SERIES_CODEC_H
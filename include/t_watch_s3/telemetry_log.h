@@ -0,0 +1,71 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef T_WATCH_S3_TELEMETRY_LOG_H
+#define T_WATCH_S3_TELEMETRY_LOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/sys/util.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Largest record: a whole batch, less its header and the record's own
+#define TELEMETRY_LOG_MAX_RECORD MIN(CONFIG_T_WATCH_S3_TELEMETRY_LOG_BATCH_SIZE - 10, UINT8_MAX)
+
+struct telemetry_log_stats
+{
+    // appended, and the bytes of data in them
+    uint32_t records;
+    uint32_t record_bytes;
+    // batches and sector headers written, in flash bytes: over
+    // record_bytes, this is the write amplification
+    uint32_t batches;
+    uint32_t flash_bytes_written;
+    uint32_t sectors_erased;
+    // sectors erased while they still held the oldest records
+    uint32_t sectors_dropped;
+    // batches skipped by telemetry_log_walk(), as their CRC did not match
+    uint32_t crc_errors;
+
+    // the last telemetry_log_init(): headers read to find where the log
+    // left off, how long it took, and the wear it found on the sectors
+    uint32_t recovery_reads;
+    uint32_t recovery_us;
+    uint32_t min_erase_count;
+    uint32_t max_erase_count;
+};
+
+// Called for every record, oldest first. Return false to stop.
+typedef bool (*telemetry_log_walk_t)(uint8_t type, const void *data, size_t len, void *user_data);
+
+// Find where the log left off in storage_partition. Runs at boot; calling it
+// again drops the records not flushed yet, like a reset would.
+int telemetry_log_init(void);
+
+// Add a record to the batch in RAM. The batch is written out when the
+// next record doesn't fit, on telemetry_log_flush(), or
+// CONFIG_T_WATCH_S3_TELEMETRY_LOG_FLUSH_INTERVAL_S after its first record.
+int telemetry_log_append(uint8_t type, const void *data, size_t len);
+
+int telemetry_log_flush(void);
+
+// Every record in flash, oldest first: unflushed ones are not included. The
+// callback runs with the log locked, so it must not append.
+int telemetry_log_walk(telemetry_log_walk_t cb, void *user_data);
+
+// Erase every record, flushed or not
+int telemetry_log_clear(void);
+
+void telemetry_log_stats_get(struct telemetry_log_stats *stats);
+void telemetry_log_stats_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // T_WATCH_S3_TELEMETRY_LOG_H
@@ -0,0 +1,89 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef T_WATCH_S3_TIME_SERVICE_H
+#define T_WATCH_S3_TIME_SERVICE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/rtc.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct time_service_stats
+{
+    // PCF8563 time reads, at boot and at the start of every sync
+    uint32_t rtc_reads;
+    // seconds register reads while looking for the seconds edge
+    uint32_t edge_polls;
+    // searches that started too late or missed the edge, and were retried
+    uint32_t edge_misses;
+    uint32_t syncs;
+    // corrections worked off gradually, and ones too big for that that
+    // stepped wall time (see CONFIG_T_WATCH_S3_TIME_SERVICE_MAX_SLEW_MS)
+    uint32_t slews;
+    uint32_t steps;
+    // wall time minus the RTC at the last seconds edge, before correcting
+    int32_t last_error_us;
+    // how closely the last edge was pinned down: it happened within half
+    // of this either side of where it was taken to be
+    uint32_t edge_window_us;
+    // how much faster the RTC runs than uptime, in parts per billion, and
+    // how many edge pairs went into that
+    int32_t drift_ppb;
+    uint32_t drift_estimates;
+    // alarms seen while running
+    uint32_t alarms;
+};
+
+// Wall time as Unix time, from the uptime counter: no I/O, and never going
+// back unless time_service_set() (or something else) sets the RTC. Before
+// the RTC has ever been set (or after it lost power) this counts from 1970.
+//
+// After the first sync, wall time is lined up with the RTC's seconds edge
+// to within edge_window_us / 2, and kept there between syncs by the drift
+// estimate. Corrections are slewed at up to
+// CONFIG_T_WATCH_S3_TIME_SERVICE_SLEW_PPM.
+int64_t time_service_now(void);
+int64_t time_service_now_ms(void);
+
+// Wall time at an earlier k_uptime_ticks(), e.g. stamped in an interrupt
+int64_t time_service_ms_at(int64_t uptime_ticks);
+
+// The same, broken down (UTC)
+int time_service_get_rtc_time(struct rtc_time *time);
+
+// True if the RTC had kept the time, or time_service_set() was called
+bool time_service_is_set(void);
+
+// Set wall time, and the RTC along with it
+int time_service_set(int64_t unix_s);
+
+// Line wall time up with the RTC's seconds edge now, instead of at the next
+// interval. Takes about two seconds, and must not be called from the
+// system workqueue, which runs the search.
+int time_service_sync(void);
+
+// Program the RTC alarm. The PCF8563 has no alarm seconds, so it goes
+// off at the start of the minute at or after unix_s.
+int time_service_alarm_set(int64_t unix_s);
+int time_service_alarm_cancel(void);
+
+// Deep sleep until the RTC alarm. The wake is a reset, see
+// time_service_from_alarm().
+FUNC_NORETURN void time_service_poweroff(void);
+
+// True if this boot is a wake by the RTC alarm
+bool time_service_from_alarm(void);
+
+void time_service_stats_get(struct time_service_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // T_WATCH_S3_TIME_SERVICE_H
@@ -0,0 +1,59 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef T_WATCH_S3_TOUCH_FILTER_H
+#define T_WATCH_S3_TOUCH_FILTER_H
+
+#include <stdint.h>
+#include <zephyr/device.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A lilygo,touch-filter node reports INPUT_ABS_X/INPUT_ABS_Y/INPUT_BTN_TOUCH
+// like the controller it sits on, one synced report per position, plus
+// these gestures as INPUT_EV_KEY, a press immediately followed by a release
+enum touch_gesture
+{
+    TOUCH_GESTURE_TAP,
+    TOUCH_GESTURE_LONG_PRESS,
+    TOUCH_GESTURE_SWIPE_UP,
+    TOUCH_GESTURE_SWIPE_DOWN,
+    TOUCH_GESTURE_SWIPE_LEFT,
+    TOUCH_GESTURE_SWIPE_RIGHT,
+    TOUCH_GESTURE_COUNT,
+};
+
+// Right after the motion gestures' codes, in Linux's BTN_TRIGGER_HAPPY range
+#define TOUCH_GESTURE_INPUT_CODE(gesture) (0x2d0 + (gesture))
+
+struct touch_filter_stats
+{
+    // what the controller reported: events, and synced reports
+    uint32_t events_in;
+    uint32_t reports_in;
+    // what the filter passed on, gestures included
+    uint32_t events_out;
+    uint32_t reports_out;
+    // reports dropped as repeats of the last position
+    uint32_t duplicates;
+    // moves dropped because one was reported less than a frame ago
+    uint32_t rate_limited;
+    // events the input queue had no room for
+    uint32_t dropped;
+    uint32_t gestures[TOUCH_GESTURE_COUNT];
+    // CPU time spent in the filter's input callback
+    uint32_t cpu_us;
+    uint32_t cpu_max_ns;
+};
+
+void touch_filter_stats_get(const struct device *dev, struct touch_filter_stats *stats);
+void touch_filter_stats_reset(const struct device *dev);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // T_WATCH_S3_TOUCH_FILTER_H
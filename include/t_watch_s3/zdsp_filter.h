@@ -0,0 +1,110 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef T_WATCH_S3_ZDSP_FILTER_H
+#define T_WATCH_S3_ZDSP_FILTER_H
+
+#include <stdint.h>
+#include <zephyr/dsp/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Filters for the zdsp backend in lib/zdsp. Nothing is allocated: the
+// caller owns the coefficients and the state, and the state carries the
+// history from one block to the next.
+
+// FIR: y[n] = sum(coeffs[k] * x[n - k]), with coeffs[0] applied to the
+// newest sample. Q15 and Q31 accumulate the full products in 64 bits and
+// shift them back at the end (Q15 saturates, Q31 does not: scale the input
+// down by log2(num_taps) if the sum can reach 1).
+#define ZDSP_FIR_STATE_LEN(num_taps, max_block) ((num_taps) - 1 + (max_block))
+
+struct zdsp_fir_q15
+{
+    const q15_t *coeffs;
+    q15_t *state;
+    uint16_t num_taps;
+    uint16_t max_block;
+};
+
+struct zdsp_fir_q31
+{
+    const q31_t *coeffs;
+    q31_t *state;
+    uint16_t num_taps;
+    uint16_t max_block;
+};
+
+struct zdsp_fir_f32
+{
+    const float32_t *coeffs;
+    float32_t *state;
+    uint16_t num_taps;
+    uint16_t max_block;
+};
+
+// state holds ZDSP_FIR_STATE_LEN(num_taps, max_block) samples, and every
+// block processed is at most max_block long
+void zdsp_fir_q15_init(struct zdsp_fir_q15 *fir, const q15_t *coeffs, uint16_t num_taps, q15_t *state,
+                       uint16_t max_block);
+void zdsp_fir_q31_init(struct zdsp_fir_q31 *fir, const q31_t *coeffs, uint16_t num_taps, q31_t *state,
+                       uint16_t max_block);
+void zdsp_fir_f32_init(struct zdsp_fir_f32 *fir, const float32_t *coeffs, uint16_t num_taps, float32_t *state,
+                       uint16_t max_block);
+
+void zdsp_fir_q15(struct zdsp_fir_q15 *fir, const q15_t *src, q15_t *dst, uint32_t block_size);
+void zdsp_fir_q31(struct zdsp_fir_q31 *fir, const q31_t *src, q31_t *dst, uint32_t block_size);
+void zdsp_fir_f32(struct zdsp_fir_f32 *fir, const float32_t *src, float32_t *dst, uint32_t block_size);
+
+// Cascaded biquads, each stage {b0, b1, b2, a1, a2} with the feedback
+// coefficients negated, as in CMSIS-DSP:
+// y[n] = b0 * x[n] + b1 * x[n-1] + b2 * x[n-2] + a1 * y[n-1] + a2 * y[n-2]
+// Q15 and Q31 coefficients are scaled down by 2^post_shift so they fit, and
+// run in direct form I. F32 runs in direct form II transposed.
+#define ZDSP_BIQUAD_COEFFS_LEN(num_stages) (5 * (num_stages))
+#define ZDSP_BIQUAD_Q_STATE_LEN(num_stages) (4 * (num_stages))
+#define ZDSP_BIQUAD_F32_STATE_LEN(num_stages) (2 * (num_stages))
+
+struct zdsp_biquad_q15
+{
+    const q15_t *coeffs;
+    q15_t *state;
+    uint8_t num_stages;
+    uint8_t post_shift;
+};
+
+struct zdsp_biquad_q31
+{
+    const q31_t *coeffs;
+    q31_t *state;
+    uint8_t num_stages;
+    uint8_t post_shift;
+};
+
+struct zdsp_biquad_f32
+{
+    const float32_t *coeffs;
+    float32_t *state;
+    uint8_t num_stages;
+};
+
+void zdsp_biquad_q15_init(struct zdsp_biquad_q15 *biquad, uint8_t num_stages, const q15_t *coeffs, q15_t *state,
+                          uint8_t post_shift);
+void zdsp_biquad_q31_init(struct zdsp_biquad_q31 *biquad, uint8_t num_stages, const q31_t *coeffs, q31_t *state,
+                          uint8_t post_shift);
+void zdsp_biquad_f32_init(struct zdsp_biquad_f32 *biquad, uint8_t num_stages, const float32_t *coeffs,
+                          float32_t *state);
+
+// src and dst may be the same buffer
+void zdsp_biquad_q15(struct zdsp_biquad_q15 *biquad, const q15_t *src, q15_t *dst, uint32_t block_size);
+void zdsp_biquad_q31(struct zdsp_biquad_q31 *biquad, const q31_t *src, q31_t *dst, uint32_t block_size);
+void zdsp_biquad_f32(struct zdsp_biquad_f32 *biquad, const float32_t *src, float32_t *dst, uint32_t block_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // T_WATCH_S3_ZDSP_FILTER_H
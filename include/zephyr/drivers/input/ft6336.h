@@ -0,0 +1,41 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef ZEPHYR_DRIVERS_INPUT_FT6336_H
+#define ZEPHYR_DRIVERS_INPUT_FT6336_H
+
+#include <stdint.h>
+#include <zephyr/device.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// FT6336 extensions to the input API (compatible "focaltech,ft6336")
+
+struct ft6336_stats
+{
+    // reports read from the controller
+    uint32_t reports;
+    // times the controller was put in monitor mode (device PM suspend)
+    uint32_t suspends;
+    // contacts in monitor mode, each one resuming the device
+    uint32_t wakes;
+    // light sleep exits on the touch interrupt
+    uint32_t sleep_wakes;
+    // from the wake (the light sleep exit if there was one, or else the
+    // interrupt) to the first input event, which includes resuming the
+    // controller and reading the report over I2C
+    uint32_t last_wake_us;
+    uint32_t max_wake_us;
+};
+
+void ft6336_stats_get(const struct device *dev, struct ft6336_stats *stats);
+void ft6336_stats_reset(const struct device *dev);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ZEPHYR_DRIVERS_INPUT_FT6336_H
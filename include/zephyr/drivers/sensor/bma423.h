@@ -0,0 +1,115 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef ZEPHYR_DRIVERS_SENSOR_BMA423_H
+#define ZEPHYR_DRIVERS_SENSOR_BMA423_H
+
+#include <stdint.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/sensor.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// BMA423 extensions to the sensor API (compatible "bosch,bma423")
+
+// Steps counted by the feature engine (CONFIG_BMA423_STEP_COUNTER). Decodes
+// as struct sensor_q31_data with a shift of 31, so the reading's value is
+// the step count itself.
+enum sensor_channel_bma423
+{
+    SENSOR_CHAN_BMA423_STEPS = SENSOR_CHAN_PRIV_START,
+};
+
+// Feature engine triggers on INT1 (CONFIG_BMA423_TRIGGER), alongside
+// SENSOR_TRIG_TAP, SENSOR_TRIG_DOUBLE_TAP, SENSOR_TRIG_MOTION (any motion)
+// and SENSOR_TRIG_STATIONARY (no motion)
+enum sensor_trigger_type_bma423
+{
+    // the wrist was turned towards the face
+    SENSOR_TRIG_BMA423_WRIST_TILT = SENSOR_TRIG_PRIV_START,
+};
+
+// No motion settings, next to SENSOR_ATTR_SLOPE_TH and SENSOR_ATTR_SLOPE_DUR
+// for any motion. Thresholds are in m/s^2, durations in milliseconds (val1),
+// all of them on SENSOR_CHAN_ACCEL_XYZ.
+//
+// SENSOR_ATTR_BMA423_LOW_POWER (val1 0 or 1) duty cycles the accelerometer,
+// and then SENSOR_ATTR_OVERSAMPLING (val1, 1 to 128) is how many samples the
+// chip averages into each one. More samples cost more current and less
+// noise, without the host filtering anything.
+//
+// Offsets are applied on the chip as well:
+// - SENSOR_ATTR_OFFSET gets or sets them in m/s^2, one value per axis, or
+//   three for SENSOR_CHAN_ACCEL_XYZ
+// - SENSOR_ATTR_CALIB_TARGET, on SENSOR_CHAN_ACCEL_XYZ, takes the three
+//   readings the watch should give where it lies, and sets the offsets that
+//   make it so. It fails with -EAGAIN if the watch moves meanwhile.
+// Both last until reset, see bma423_offset_store().
+enum sensor_attribute_bma423
+{
+    SENSOR_ATTR_BMA423_NO_MOTION_TH = SENSOR_ATTR_PRIV_START,
+    SENSOR_ATTR_BMA423_NO_MOTION_DUR,
+    SENSOR_ATTR_BMA423_LOW_POWER,
+};
+
+// Where the accelerometer costs the host its time
+struct bma423_stats
+{
+    // INT1 interrupts serviced, for the FIFO and the feature engine
+    uint32_t wakeups;
+    // feature engine events handed to trigger handlers
+    uint32_t feature_events;
+    // one-shot reads (each one is a host wake-up when polling)
+    uint32_t reads;
+    // accelerometer frames handed to the application
+    uint32_t frames;
+    // time spent in I2C transfers
+    uint32_t bus_us;
+    // time it took to load the feature engine at boot (kept across resets)
+    uint32_t config_upload_us;
+};
+
+#define BMA423_BRINGUP_MAX_ATTEMPTS 16
+
+// How the chip came up at boot: a soft reset, then CHIP_ID polls with
+// exponential backoff until it answers (and again, up to
+// CONFIG_BMA423_BRINGUP_RESETS times, if it never does)
+struct bma423_bringup
+{
+    // from the first reset to the chip answering, or to giving up
+    uint32_t total_us;
+    uint8_t resets;
+    uint8_t attempts;
+    struct
+    {
+        // time of the poll since the first reset
+        uint32_t at_us;
+        // 0 once the chip answered, -ENODEV for a wrong chip id or a fatal
+        // error, or the bus error
+        int32_t result;
+    } attempt[BMA423_BRINGUP_MAX_ATTEMPTS];
+};
+
+// Also available after a failed init, when the device is not ready
+void bma423_bringup_get(const struct device *dev, struct bma423_bringup *bringup);
+
+// Write the current offsets to the chip's NVM, where every reset loads them
+// from. The NVM only takes so many writes, so this does nothing if it
+// already holds them.
+int bma423_offset_store(const struct device *dev);
+
+void bma423_stats_get(const struct device *dev, struct bma423_stats *stats);
+void bma423_stats_reset(const struct device *dev);
+
+// Reclaim INT1 after something else owned the pin, like the SoC's sleep
+// wakeup logic, and service any event that latched in the meantime
+void bma423_int1_resync(const struct device *dev);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ZEPHYR_DRIVERS_SENSOR_BMA423_H
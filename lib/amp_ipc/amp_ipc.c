@@ -0,0 +1,319 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <t_watch_s3/amp_ipc.h>
+
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/drivers/ipm.h>
+#include <zephyr/sys/barrier.h>
+#include <zephyr/sys/spsc_pbuf.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(amp_ipc, CONFIG_AMP_IPC_LOG_LEVEL);
+
+#define SHM_NODE DT_CHOSEN(zephyr_ipc_shm)
+#define IPM_NODE DT_CHOSEN(zephyr_ipc)
+
+// The ESP32 IPM driver keeps its own mailbox at the start of the shared
+// memory region, so the rings go after it
+#define SHM_OFFSET DT_PROP_OR(IPM_NODE, shared_memory_size, 0)
+#define SHM_BASE (DT_REG_ADDR(SHM_NODE) + SHM_OFFSET)
+#define SHM_SIZE (DT_REG_SIZE(SHM_NODE) - SHM_OFFSET)
+
+#define CTRL_SIZE 32
+#define RING_SIZE ROUND_DOWN((SHM_SIZE - CTRL_SIZE) / 2, 32)
+
+BUILD_ASSERT(DT_REG_SIZE(SHM_NODE) > SHM_OFFSET + CTRL_SIZE + 2 * 128,
+             "zephyr,ipc_shm is too small for the AMP IPC rings");
+
+#define AMP_IPC_MAGIC 0x41495043 // "AIPC"
+
+#define PROCPU 0
+#define APPCPU 1
+#define LOCAL (IS_ENABLED(CONFIG_SOC_ESP32S3_APPCPU) ? APPCPU : PROCPU)
+#define REMOTE (1 - LOCAL)
+
+// Everything is indexed by the core that writes it. Either core can be
+// reset on its own (a panic, a software reset, a new image), leaving its
+// old flags and rings in shared memory, so each core publishes a
+// generation, new on every boot. A core only reads the other's ring once
+// the other has acknowledged its current generation, which it does after
+// starting that ring afresh: ring[c] is good for the other core r while
+// ready[c] is the magic and ack[c] == gen[r].
+struct amp_ipc_ctrl
+{
+    volatile uint32_t ready[2];
+    volatile uint32_t gen[2];
+    // the other core's generation this core's ring was last started for
+    volatile uint32_t ack[2];
+};
+
+BUILD_ASSERT(sizeof(struct amp_ipc_ctrl) <= CTRL_SIZE);
+
+static struct amp_ipc_ctrl *const ctrl = (struct amp_ipc_ctrl *)SHM_BASE;
+static uint8_t *const rings[2] = {
+    (uint8_t *)SHM_BASE + CTRL_SIZE,
+    (uint8_t *)SHM_BASE + CTRL_SIZE + RING_SIZE,
+};
+
+static const struct device *const ipm = DEVICE_DT_GET(IPM_NODE);
+
+static struct spsc_pbuf *tx;
+static struct spsc_pbuf *rx;
+// the remote generation rx belongs to
+static uint32_t rx_gen;
+
+// Held from amp_ipc_alloc() to amp_ipc_send(), so the outgoing ring is
+// never restarted under a message being written. Whoever holds it restarts
+// the ring if the remote came back.
+static K_MUTEX_DEFINE(tx_lock);
+static void amp_ipc_sync_work_handler(struct k_work *work);
+static K_WORK_DEFINE(sync_work, amp_ipc_sync_work_handler);
+
+// Every doorbell means "look again": the IPM holds only one pending message
+// per direction, so data and free-space notifications share it
+static K_SEM_DEFINE(rx_sem, 0, 1);
+static K_SEM_DEFINE(tx_sem, 0, 1);
+static K_SEM_DEFINE(ready_sem, 0, 1);
+
+static void amp_ipc_doorbell(const struct device *dev, void *user_data, uint32_t id, volatile void *data)
+{
+    ARG_UNUSED(dev);
+    ARG_UNUSED(user_data);
+    ARG_UNUSED(id);
+    ARG_UNUSED(data);
+
+    k_sem_give(&rx_sem);
+    k_sem_give(&tx_sem);
+    k_sem_give(&ready_sem);
+    k_work_submit(&sync_work);
+}
+
+static void amp_ipc_ring_doorbell(void)
+{
+    // -EBUSY means the other core has not taken the previous doorbell yet.
+    // It will look at the rings when it does, which covers this one too.
+    int ret = ipm_send(ipm, 0, 0, NULL, 0);
+    if (ret < 0 && ret != -EBUSY)
+    {
+        LOG_ERR("Doorbell failed: %d", ret);
+    }
+}
+
+// The remote booted (again) since the outgoing ring was started: start it
+// afresh, as the remote's read index in it is gone, and acknowledge
+static void amp_ipc_sync_tx_locked(void)
+{
+    if (ctrl->ready[REMOTE] != AMP_IPC_MAGIC)
+    {
+        return;
+    }
+    barrier_dmem_fence_full();
+    const uint32_t remote_gen = ctrl->gen[REMOTE];
+    if (ctrl->ack[LOCAL] == remote_gen)
+    {
+        return;
+    }
+
+    tx = spsc_pbuf_init(rings[LOCAL], RING_SIZE, 0);
+    barrier_dmem_fence_full();
+    ctrl->ack[LOCAL] = remote_gen;
+    barrier_dmem_fence_full();
+    LOG_DBG("Remote generation %u", remote_gen);
+    amp_ipc_ring_doorbell();
+}
+
+static void amp_ipc_sync_work_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    // if a sender holds the ring, it syncs before letting go
+    if (k_mutex_lock(&tx_lock, K_NO_WAIT) == 0)
+    {
+        amp_ipc_sync_tx_locked();
+        k_mutex_unlock(&tx_lock);
+    }
+}
+
+// Whether the remote's ring was started for this boot of ours
+static bool amp_ipc_remote_ready(uint32_t *remote_gen)
+{
+    if (ctrl->ready[REMOTE] != AMP_IPC_MAGIC || ctrl->ack[REMOTE] != ctrl->gen[LOCAL])
+    {
+        return false;
+    }
+    barrier_dmem_fence_full();
+    *remote_gen = ctrl->gen[REMOTE];
+    return true;
+}
+
+static bool amp_ipc_attach(void)
+{
+    uint32_t remote_gen;
+
+    if (!amp_ipc_remote_ready(&remote_gen))
+    {
+        rx = NULL;
+        return false;
+    }
+    if (rx == NULL || rx_gen != remote_gen)
+    {
+        rx = (struct spsc_pbuf *)rings[REMOTE];
+        rx_gen = remote_gen;
+    }
+    return true;
+}
+
+int amp_ipc_wait_ready(k_timeout_t timeout)
+{
+    const k_timepoint_t end = sys_timepoint_calc(timeout);
+    uint32_t remote_gen;
+
+    // both ways: the remote's ring is started for us, and ours for it
+    while (!amp_ipc_remote_ready(&remote_gen) || ctrl->ack[LOCAL] != remote_gen)
+    {
+        k_work_submit(&sync_work);
+        if (k_sem_take(&ready_sem, sys_timepoint_timeout(end)) < 0)
+        {
+            return -EAGAIN;
+        }
+    }
+
+    return 0;
+}
+
+size_t amp_ipc_max_len(void)
+{
+    // An empty ring can always fit at least half its capacity contiguously,
+    // wherever its indices happen to be. Leave room for the pbuf header and
+    // the per-packet length word.
+    return MIN(RING_SIZE / 2 - 32, UINT16_MAX);
+}
+
+int amp_ipc_alloc(void **buf, size_t len, k_timeout_t timeout)
+{
+    if (len == 0 || len > amp_ipc_max_len())
+    {
+        return -EMSGSIZE;
+    }
+
+    const k_timepoint_t end = sys_timepoint_calc(timeout);
+    if (k_mutex_lock(&tx_lock, sys_timepoint_timeout(end)) < 0)
+    {
+        return -EAGAIN;
+    }
+    while (true)
+    {
+        amp_ipc_sync_tx_locked();
+
+        char *ptr;
+        int ret = spsc_pbuf_alloc(tx, len, &ptr);
+        if (ret >= (int)len)
+        {
+            // held until amp_ipc_send()
+            *buf = ptr;
+            return 0;
+        }
+
+        if (k_sem_take(&tx_sem, sys_timepoint_timeout(end)) < 0)
+        {
+            k_mutex_unlock(&tx_lock);
+            return -EAGAIN;
+        }
+    }
+}
+
+int amp_ipc_send(void *buf, size_t len)
+{
+    ARG_UNUSED(buf);
+
+    spsc_pbuf_commit(tx, len);
+    amp_ipc_ring_doorbell();
+    // the remote may have restarted meanwhile, dropping this message
+    amp_ipc_sync_tx_locked();
+    k_mutex_unlock(&tx_lock);
+    return 0;
+}
+
+int amp_ipc_claim(void **buf, k_timeout_t timeout)
+{
+    const k_timepoint_t end = sys_timepoint_calc(timeout);
+
+    while (true)
+    {
+        if (amp_ipc_attach())
+        {
+            char *ptr;
+            uint16_t len = spsc_pbuf_claim(rx, &ptr);
+            if (len > 0)
+            {
+                *buf = ptr;
+                return len;
+            }
+        }
+
+        if (k_sem_take(&rx_sem, sys_timepoint_timeout(end)) < 0)
+        {
+            return -EAGAIN;
+        }
+    }
+}
+
+void amp_ipc_release(void *buf, size_t len)
+{
+    ARG_UNUSED(buf);
+
+    // a remote that restarted has started the ring again, without this
+    if (ctrl->gen[REMOTE] != rx_gen)
+    {
+        return;
+    }
+    spsc_pbuf_free(rx, len);
+    // the sender may be waiting for room
+    amp_ipc_ring_doorbell();
+}
+
+// Each core only ever writes its own flags and its own outgoing ring. The
+// other core may be up already, from before a reset of this one, or not.
+static int amp_ipc_init(void)
+{
+    if (!device_is_ready(ipm))
+    {
+        LOG_ERR("IPM not ready");
+        return -ENODEV;
+    }
+
+    // withdrawn while the ring and the generation change
+    ctrl->ready[LOCAL] = 0;
+    barrier_dmem_fence_full();
+
+    // a new generation before the ring is touched, so a remote still
+    // holding a message from the old ring can tell
+    const uint32_t gen = ctrl->gen[LOCAL] + 1;
+    ctrl->gen[LOCAL] = gen;
+    barrier_dmem_fence_full();
+    tx = spsc_pbuf_init(rings[LOCAL], RING_SIZE, 0);
+    ctrl->ack[LOCAL] = ctrl->gen[REMOTE];
+
+    ipm_register_callback(ipm, amp_ipc_doorbell, NULL);
+    int ret = ipm_set_enabled(ipm, 1);
+    if (ret < 0)
+    {
+        LOG_ERR("Failed to enable IPM: %d", ret);
+        return ret;
+    }
+
+    barrier_dmem_fence_full();
+    ctrl->ready[LOCAL] = AMP_IPC_MAGIC;
+    barrier_dmem_fence_full();
+
+    amp_ipc_ring_doorbell();
+    LOG_DBG("%u byte rings at %p, generation %u", RING_SIZE, (void *)rings[LOCAL], gen);
+    return 0;
+}
+
+SYS_INIT(amp_ipc_init, POST_KERNEL, CONFIG_T_WATCH_S3_AMP_IPC_INIT_PRIORITY);
@@ -0,0 +1,474 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <t_watch_s3/display_idle.h>
+
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/drivers/display.h>
+#include <zephyr/drivers/mipi_dbi.h>
+#include <zephyr/drivers/pwm.h>
+#include <zephyr/drivers/regulator.h>
+#include <zephyr/input/input.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(display_idle, CONFIG_DISPLAY_IDLE_LOG_LEVEL);
+
+#define DISPLAY_NODE DT_CHOSEN(zephyr_display)
+
+BUILD_ASSERT(DT_NODE_HAS_COMPAT(DISPLAY_NODE, sitronix_st7789v), "Display idle manager expects an ST7789V");
+
+// Timeouts are measured from the last activity, so they have to nest
+BUILD_ASSERT(CONFIG_T_WATCH_S3_DISPLAY_IDLE_DIM_MS <= CONFIG_T_WATCH_S3_DISPLAY_IDLE_BLANK_MS);
+BUILD_ASSERT(CONFIG_T_WATCH_S3_DISPLAY_IDLE_BLANK_MS <= CONFIG_T_WATCH_S3_DISPLAY_IDLE_SLEEP_MS);
+#ifdef CONFIG_T_WATCH_S3_DISPLAY_IDLE_RAIL_CUT
+BUILD_ASSERT(CONFIG_T_WATCH_S3_DISPLAY_IDLE_SLEEP_MS <= CONFIG_T_WATCH_S3_DISPLAY_IDLE_OFF_MS);
+#define DISPLAY_IDLE_DEEPEST DISPLAY_IDLE_OFF
+#else
+#define DISPLAY_IDLE_DEEPEST DISPLAY_IDLE_SLEEP
+#endif
+
+// The ST7789V ignores a sleep-in less than 120ms after a sleep-out
+#define ST7789V_SLEEP_IN_GUARD_MS 120
+BUILD_ASSERT(CONFIG_T_WATCH_S3_DISPLAY_IDLE_HOLD_MS >= ST7789V_SLEEP_IN_GUARD_MS);
+
+// ST7789V commands not issued through the display API
+#define ST7789V_CMD_SW_RESET 0x01
+#define ST7789V_CMD_SLEEP_IN 0x10
+#define ST7789V_CMD_SLEEP_OUT 0x11
+#define ST7789V_CMD_INV_OFF 0x20
+#define ST7789V_CMD_INV_ON 0x21
+#define ST7789V_CMD_GAMSET 0x26
+#define ST7789V_CMD_MADCTL 0x36
+#define ST7789V_CMD_COLMOD 0x3A
+#define ST7789V_CMD_RAMCTRL 0xB0
+#define ST7789V_CMD_RGBCTRL 0xB1
+#define ST7789V_CMD_PORCTRL 0xB2
+#define ST7789V_CMD_GCTRL 0xB7
+#define ST7789V_CMD_VCOMS 0xBB
+#define ST7789V_CMD_LCMCTRL 0xC0
+#define ST7789V_CMD_VDVVRHEN 0xC2
+#define ST7789V_CMD_VRHS 0xC3
+#define ST7789V_CMD_VDVS 0xC4
+#define ST7789V_CMD_PWCTRL1 0xD0
+#define ST7789V_CMD_CMD2EN 0xDF
+#define ST7789V_CMD_PVGAMCTRL 0xE0
+#define ST7789V_CMD_NVGAMCTRL 0xE1
+
+// Datasheet delays (section 9.1): 5ms after a reset or sleep-out before
+// the next command is accepted while the panel is in sleep-in mode.
+#define ST7789V_RESET_DELAY_MS 5
+#define ST7789V_SLEEP_OUT_DELAY_MS 5
+
+// AXP2101 LDOs are up well within this, the panel wants VDD stable first
+#define LCD_VDD_RAMP_US 500
+
+struct st7789v_cmd
+{
+    uint8_t cmd;
+    uint8_t len;
+    const uint8_t *data;
+};
+
+// The panel configuration after a rail cut is the same one the in-tree driver
+// sends at boot, so it is built once from the devicetree at compile time and
+// replayed as-is. No parsing or allocation on the wake path.
+static const uint8_t porch_param[] = DT_PROP(DISPLAY_NODE, porch_param);
+static const uint8_t cmd2en_param[] = DT_PROP(DISPLAY_NODE, cmd2en_param);
+static const uint8_t pwctrl1_param[] = DT_PROP(DISPLAY_NODE, pwctrl1_param);
+static const uint8_t pvgam_param[] = DT_PROP(DISPLAY_NODE, pvgam_param);
+static const uint8_t nvgam_param[] = DT_PROP(DISPLAY_NODE, nvgam_param);
+static const uint8_t ram_param[] = DT_PROP(DISPLAY_NODE, ram_param);
+static const uint8_t rgb_param[] = DT_PROP(DISPLAY_NODE, rgb_param);
+static const uint8_t gctrl[] = {DT_PROP(DISPLAY_NODE, gctrl)};
+static const uint8_t vcom[] = {DT_PROP(DISPLAY_NODE, vcom)};
+static const uint8_t vdvvrhen[] = {0x01};
+static const uint8_t vrhs[] = {DT_PROP(DISPLAY_NODE, vrhs)};
+static const uint8_t vdvs[] = {DT_PROP(DISPLAY_NODE, vdvs)};
+static const uint8_t mdac[] = {DT_PROP(DISPLAY_NODE, mdac)};
+static const uint8_t colmod[] = {DT_PROP(DISPLAY_NODE, colmod)};
+static const uint8_t lcm[] = {DT_PROP(DISPLAY_NODE, lcm)};
+static const uint8_t gamset[] = {DT_PROP(DISPLAY_NODE, gamma)};
+
+#define ST7789V_CMD(_cmd, _param) {.cmd = (_cmd), .len = sizeof(_param), .data = (_param)}
+
+static const struct st7789v_cmd init_sequence[] = {
+    ST7789V_CMD(ST7789V_CMD_PORCTRL, porch_param),
+    ST7789V_CMD(ST7789V_CMD_CMD2EN, cmd2en_param),
+    ST7789V_CMD(ST7789V_CMD_GCTRL, gctrl),
+    ST7789V_CMD(ST7789V_CMD_VCOMS, vcom),
+    ST7789V_CMD(ST7789V_CMD_VDVVRHEN, vdvvrhen),
+    ST7789V_CMD(ST7789V_CMD_VRHS, vrhs),
+    ST7789V_CMD(ST7789V_CMD_VDVS, vdvs),
+    ST7789V_CMD(ST7789V_CMD_PWCTRL1, pwctrl1_param),
+    ST7789V_CMD(ST7789V_CMD_MADCTL, mdac),
+    ST7789V_CMD(ST7789V_CMD_COLMOD, colmod),
+    ST7789V_CMD(ST7789V_CMD_LCMCTRL, lcm),
+    ST7789V_CMD(ST7789V_CMD_GAMSET, gamset),
+    {.cmd = DT_PROP_OR(DISPLAY_NODE, inversion_off, 0) ? ST7789V_CMD_INV_OFF : ST7789V_CMD_INV_ON},
+    ST7789V_CMD(ST7789V_CMD_PVGAMCTRL, pvgam_param),
+    ST7789V_CMD(ST7789V_CMD_NVGAMCTRL, nvgam_param),
+    ST7789V_CMD(ST7789V_CMD_RAMCTRL, ram_param),
+    ST7789V_CMD(ST7789V_CMD_RGBCTRL, rgb_param),
+};
+
+static const struct device *const display = DEVICE_DT_GET(DISPLAY_NODE);
+static const struct device *const dbi = DEVICE_DT_GET(DT_PARENT(DISPLAY_NODE));
+static const struct mipi_dbi_config dbi_config =
+    MIPI_DBI_CONFIG_DT(DISPLAY_NODE, SPI_OP_MODE_MASTER | SPI_WORD_SET(8), 0);
+static const struct device *const lcd_vdd = DEVICE_DT_GET(DT_NODELABEL(lcd_vdd));
+static const struct pwm_dt_spec backlight = PWM_DT_SPEC_GET(DT_ALIAS(backlight));
+
+static const uint32_t state_timeout_ms[] = {
+    [DISPLAY_IDLE_ACTIVE] = 0,
+    [DISPLAY_IDLE_DIM] = CONFIG_T_WATCH_S3_DISPLAY_IDLE_DIM_MS,
+    [DISPLAY_IDLE_BLANK] = CONFIG_T_WATCH_S3_DISPLAY_IDLE_BLANK_MS,
+    [DISPLAY_IDLE_SLEEP] = CONFIG_T_WATCH_S3_DISPLAY_IDLE_SLEEP_MS,
+#ifdef CONFIG_T_WATCH_S3_DISPLAY_IDLE_RAIL_CUT
+    [DISPLAY_IDLE_OFF] = CONFIG_T_WATCH_S3_DISPLAY_IDLE_OFF_MS,
+#endif
+};
+
+static K_MUTEX_DEFINE(lock);
+static sys_slist_t callbacks = SYS_SLIST_STATIC_INIT(&callbacks);
+
+// written under the lock, but read locklessly from input callbacks
+static atomic_t state = ATOMIC_INIT(DISPLAY_IDLE_ACTIVE);
+static atomic_t last_activity_ms;
+static atomic_t wake_start_cycles;
+
+// protected by the lock
+static uint32_t hold_until_ms;
+static uint32_t sleep_out_ms;
+static struct display_idle_stats stats;
+
+static void display_idle_step_handler(struct k_work *work);
+static void display_idle_wake_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(step_work, display_idle_step_handler);
+static K_WORK_DEFINE(wake_work, display_idle_wake_handler);
+
+static int display_idle_backlight(uint8_t percent)
+{
+    return pwm_set_pulse_dt(&backlight, (uint64_t)backlight.period * percent / 100U);
+}
+
+static int display_idle_command(uint8_t cmd, const uint8_t *data, size_t len)
+{
+    return mipi_dbi_command_write(dbi, &dbi_config, cmd, data, len);
+}
+
+// Bring the controller back from a cold rail and configure it. The software
+// reset leaves it in sleep-in, display-off, and so does this: the caller
+// sends SLEEP_OUT. Frame memory content is undefined until redrawn.
+static int display_idle_panel_reinit(void)
+{
+    int ret = regulator_enable(lcd_vdd);
+    if (ret < 0)
+    {
+        LOG_ERR("Failed to enable lcd_vdd: %d", ret);
+        return ret;
+    }
+    k_busy_wait(LCD_VDD_RAMP_US);
+
+    ret = display_idle_command(ST7789V_CMD_SW_RESET, NULL, 0);
+    if (ret < 0)
+    {
+        return ret;
+    }
+    k_msleep(ST7789V_RESET_DELAY_MS);
+
+    for (size_t i = 0; i < ARRAY_SIZE(init_sequence); i++)
+    {
+        ret = display_idle_command(init_sequence[i].cmd, init_sequence[i].data, init_sequence[i].len);
+        if (ret < 0)
+        {
+            LOG_ERR("Init command 0x%02x failed: %d", init_sequence[i].cmd, ret);
+            return ret;
+        }
+    }
+
+    return 0;
+}
+
+static int display_idle_step_down(enum display_idle_state to)
+{
+    switch (to)
+    {
+    case DISPLAY_IDLE_DIM:
+        return display_idle_backlight(CONFIG_T_WATCH_S3_DISPLAY_IDLE_DIM_PERCENT);
+    case DISPLAY_IDLE_BLANK:
+    {
+        int ret = display_idle_backlight(0);
+        if (ret < 0)
+        {
+            return ret;
+        }
+        return display_blanking_on(display);
+    }
+    case DISPLAY_IDLE_SLEEP:
+    {
+        // only reachable this early through display_idle_enter()
+        const int32_t guard = (int32_t)(sleep_out_ms + ST7789V_SLEEP_IN_GUARD_MS - k_uptime_get_32());
+        if (guard > 0)
+        {
+            k_msleep(guard);
+        }
+        return display_idle_command(ST7789V_CMD_SLEEP_IN, NULL, 0);
+    }
+    case DISPLAY_IDLE_OFF:
+        return regulator_disable(lcd_vdd);
+    default:
+        return -EINVAL;
+    }
+}
+
+static void display_idle_notify(enum display_idle_state from, enum display_idle_state to)
+{
+    struct display_idle_callback *cb, *tmp;
+    SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&callbacks, cb, tmp, node)
+    {
+        cb->handler(cb, from, to);
+    }
+}
+
+static void display_idle_record_wake(void)
+{
+    const uint32_t start = (uint32_t)atomic_get(&wake_start_cycles);
+    const uint32_t wake_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+    stats.wakes++;
+    stats.last_wake_us = wake_us;
+    stats.max_wake_us = MAX(stats.max_wake_us, wake_us);
+    if (wake_us > CONFIG_T_WATCH_S3_DISPLAY_IDLE_WAKE_BUDGET_MS * USEC_PER_MSEC)
+    {
+        stats.budget_misses++;
+        LOG_WRN("Wake took %u us (budget %u ms)", wake_us, CONFIG_T_WATCH_S3_DISPLAY_IDLE_WAKE_BUDGET_MS);
+    }
+}
+
+// Must hold the lock
+static int display_idle_transition(enum display_idle_state to)
+{
+    const enum display_idle_state from = atomic_get(&state);
+    int ret = 0;
+
+    if (to == from)
+    {
+        return 0;
+    }
+
+    if (to > from)
+    {
+        // Going down one step at a time, so every intermediate state gets applied
+        for (enum display_idle_state s = from + 1; s <= to; s++)
+        {
+            ret = display_idle_step_down(s);
+            if (ret < 0)
+            {
+                LOG_ERR("Failed to enter state %d: %d", s, ret);
+                to = s - 1;
+                break;
+            }
+        }
+        atomic_set(&state, to);
+        LOG_DBG("Display idle %d -> %d", from, to);
+        display_idle_notify(from, to);
+        return ret;
+    }
+
+    // Waking up. The order matters: panel first, then let the listeners
+    // draw into it, and only then show it so there's never a stale frame.
+    if (from == DISPLAY_IDLE_OFF)
+    {
+        ret = display_idle_panel_reinit();
+    }
+
+    if (ret == 0 && from >= DISPLAY_IDLE_SLEEP)
+    {
+        ret = display_idle_command(ST7789V_CMD_SLEEP_OUT, NULL, 0);
+        k_msleep(ST7789V_SLEEP_OUT_DELAY_MS);
+        sleep_out_ms = k_uptime_get_32();
+        hold_until_ms = sleep_out_ms + CONFIG_T_WATCH_S3_DISPLAY_IDLE_HOLD_MS;
+    }
+
+    if (ret < 0)
+    {
+        LOG_ERR("Failed to wake panel: %d", ret);
+        return ret;
+    }
+
+    atomic_set(&state, to);
+    display_idle_notify(from, to);
+
+    if (from >= DISPLAY_IDLE_BLANK && to < DISPLAY_IDLE_BLANK)
+    {
+        ret = display_blanking_off(display);
+    }
+
+    if (ret == 0 && to < DISPLAY_IDLE_BLANK)
+    {
+        ret = display_idle_backlight(to == DISPLAY_IDLE_DIM ? CONFIG_T_WATCH_S3_DISPLAY_IDLE_DIM_PERCENT
+                                                            : CONFIG_T_WATCH_S3_DISPLAY_IDLE_ACTIVE_PERCENT);
+    }
+
+    if (from >= DISPLAY_IDLE_BLANK)
+    {
+        display_idle_record_wake();
+    }
+
+    LOG_DBG("Display idle %d -> %d", from, to);
+    return ret;
+}
+
+// Must hold the lock. Arms the step timer for the next deeper state.
+static void display_idle_schedule(void)
+{
+    const enum display_idle_state current = atomic_get(&state);
+    if (current >= DISPLAY_IDLE_DEEPEST)
+    {
+        return;
+    }
+
+    const uint32_t now = k_uptime_get_32();
+    const uint32_t idle = now - (uint32_t)atomic_get(&last_activity_ms);
+    const enum display_idle_state next = current + 1;
+
+    int32_t delay = (int32_t)(state_timeout_ms[next] - idle);
+    if (next >= DISPLAY_IDLE_SLEEP)
+    {
+        delay = MAX(delay, (int32_t)(hold_until_ms - now));
+    }
+
+    k_work_reschedule(&step_work, K_MSEC(MAX(delay, 0)));
+}
+
+static void display_idle_step_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+    k_mutex_lock(&lock, K_FOREVER);
+
+    const uint32_t now = k_uptime_get_32();
+    const uint32_t idle = now - (uint32_t)atomic_get(&last_activity_ms);
+    const bool holding = (int32_t)(hold_until_ms - now) > 0;
+
+    enum display_idle_state target = DISPLAY_IDLE_ACTIVE;
+    for (enum display_idle_state s = DISPLAY_IDLE_DIM; s <= DISPLAY_IDLE_DEEPEST; s++)
+    {
+        if (idle >= state_timeout_ms[s] && !(holding && s >= DISPLAY_IDLE_SLEEP))
+        {
+            target = s;
+        }
+    }
+
+    // Only ever steps down here, activity is handled by the wake work
+    if (target > atomic_get(&state))
+    {
+        (void)display_idle_transition(target);
+    }
+
+    display_idle_schedule();
+    k_mutex_unlock(&lock);
+}
+
+static void display_idle_wake_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+    k_mutex_lock(&lock, K_FOREVER);
+    (void)display_idle_transition(DISPLAY_IDLE_ACTIVE);
+    display_idle_schedule();
+    k_mutex_unlock(&lock);
+}
+
+void display_idle_kick(void)
+{
+    atomic_set(&last_activity_ms, k_uptime_get_32());
+
+    if (atomic_get(&state) != DISPLAY_IDLE_ACTIVE)
+    {
+        // the first kick of a wake-up starts the clock
+        if (!k_work_is_pending(&wake_work))
+        {
+            atomic_set(&wake_start_cycles, k_cycle_get_32());
+        }
+        k_work_submit(&wake_work);
+    }
+}
+
+int display_idle_enter(enum display_idle_state to)
+{
+    if (to > DISPLAY_IDLE_DEEPEST)
+    {
+        return -ENOTSUP;
+    }
+
+    k_mutex_lock(&lock, K_FOREVER);
+    if (to < atomic_get(&state))
+    {
+        atomic_set(&last_activity_ms, k_uptime_get_32());
+        atomic_set(&wake_start_cycles, k_cycle_get_32());
+    }
+    int ret = display_idle_transition(to);
+    display_idle_schedule();
+    k_mutex_unlock(&lock);
+
+    return ret;
+}
+
+enum display_idle_state display_idle_state_get(void)
+{
+    return atomic_get(&state);
+}
+
+void display_idle_stats_get(struct display_idle_stats *out)
+{
+    k_mutex_lock(&lock, K_FOREVER);
+    *out = stats;
+    k_mutex_unlock(&lock);
+}
+
+void display_idle_add_callback(struct display_idle_callback *cb)
+{
+    k_mutex_lock(&lock, K_FOREVER);
+    sys_slist_append(&callbacks, &cb->node);
+    k_mutex_unlock(&lock);
+}
+
+static void display_idle_touch_cb(struct input_event *evt, void *user_data)
+{
+    ARG_UNUSED(evt);
+    ARG_UNUSED(user_data);
+    display_idle_kick();
+}
+
+static void display_idle_button_cb(struct input_event *evt, void *user_data)
+{
+    ARG_UNUSED(evt);
+    ARG_UNUSED(user_data);
+    display_idle_kick();
+}
+
+INPUT_CALLBACK_DEFINE(DEVICE_DT_GET(DT_ALIAS(touch)), display_idle_touch_cb, NULL);
+INPUT_CALLBACK_DEFINE(DEVICE_DT_GET(DT_ALIAS(buttons)), display_idle_button_cb, NULL);
+
+static int display_idle_init(void)
+{
+    if (!device_is_ready(display) || !device_is_ready(dbi) || !device_is_ready(lcd_vdd) ||
+        !pwm_is_ready_dt(&backlight))
+    {
+        LOG_ERR("Display, lcd_vdd or backlight not ready");
+        return -ENODEV;
+    }
+
+    k_mutex_lock(&lock, K_FOREVER);
+    atomic_set(&last_activity_ms, k_uptime_get_32());
+    display_idle_schedule();
+    k_mutex_unlock(&lock);
+
+    return 0;
+}
+
+SYS_INIT(display_idle_init, APPLICATION, CONFIG_T_WATCH_S3_DISPLAY_IDLE_INIT_PRIORITY);
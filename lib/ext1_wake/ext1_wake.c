@@ -0,0 +1,46 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <t_watch_s3/ext1_wake.h>
+
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include <esp_sleep.h>
+
+static struct k_spinlock lock;
+static uint64_t mask;
+
+int ext1_wake_add(const struct gpio_dt_spec *pin)
+{
+    if (!(pin->dt_flags & GPIO_ACTIVE_LOW) || !esp_sleep_is_valid_wakeup_gpio(pin->pin))
+    {
+        return -EINVAL;
+    }
+
+    K_SPINLOCK(&lock)
+    {
+        mask |= BIT64(pin->pin);
+    }
+    return 0;
+}
+
+void ext1_wake_enable(void)
+{
+    uint64_t pins;
+    K_SPINLOCK(&lock)
+    {
+        pins = mask;
+    }
+
+    esp_sleep_enable_ext1_wakeup(pins, ESP_EXT1_WAKEUP_ANY_LOW);
+}
+
+bool ext1_wake_from(const struct gpio_dt_spec *pin)
+{
+    return esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_EXT1 &&
+           (esp_sleep_get_ext1_wakeup_status() & BIT64(pin->pin));
+}
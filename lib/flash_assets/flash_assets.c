@@ -0,0 +1,213 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <t_watch_s3/flash_assets.h>
+
+#include <errno.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/crc.h>
+
+#if defined(CONFIG_SOC_SERIES_ESP32S3)
+#include <spi_flash_mmap.h>
+#elif defined(CONFIG_FLASH_SIMULATOR)
+#include <zephyr/drivers/flash/flash_simulator.h>
+#endif
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(flash_assets, CONFIG_FLASH_ASSETS_LOG_LEVEL);
+
+BUILD_ASSERT(sizeof(struct flash_assets_header) == 16 && sizeof(struct flash_assets_entry) == 32);
+
+// the image, where the partition is mapped, or NULL
+static const uint8_t *image;
+static const struct flash_assets_entry *entries;
+static uint16_t entry_count;
+
+#if defined(CONFIG_SOC_SERIES_ESP32S3)
+
+// The data MMU maps flash in 64 KB pages, so the partition should start on
+// one: spi_flash_mmap() would round down otherwise.
+BUILD_ASSERT(FIXED_PARTITION_OFFSET(assets_partition) % SPI_FLASH_MMU_PAGE_SIZE == 0);
+
+static spi_flash_mmap_handle_t handle;
+
+static const void *flash_assets_map(const struct flash_area *area, size_t size)
+{
+    const void *mapped;
+    if (spi_flash_mmap(area->fa_off, size, SPI_FLASH_MMAP_DATA, &mapped, &handle) != ESP_OK)
+    {
+        return NULL;
+    }
+    return mapped;
+}
+
+static void flash_assets_release(void)
+{
+    spi_flash_munmap(handle);
+}
+
+#elif defined(CONFIG_FLASH_SIMULATOR)
+
+// The simulated flash is RAM already
+static const void *flash_assets_map(const struct flash_area *area, size_t size)
+{
+    size_t flash_size;
+    const uint8_t *memory = flash_simulator_get_memory(flash_area_get_device(area), &flash_size);
+    return area->fa_off + size <= flash_size ? memory + area->fa_off : NULL;
+}
+
+static void flash_assets_release(void)
+{
+}
+
+#endif
+
+// Check the header and entry table of the mapped image
+static int flash_assets_check_table(const uint8_t *mapped, size_t partition_size)
+{
+    const struct flash_assets_header *header = (const void *)mapped;
+    const size_t table_end = sizeof(*header) + header->count * sizeof(struct flash_assets_entry);
+
+    if (header->version != FLASH_ASSETS_VERSION || header->size > partition_size || table_end > header->size)
+    {
+        return -EBADMSG;
+    }
+    uint32_t crc = crc32_ieee(mapped, offsetof(struct flash_assets_header, crc32));
+    crc = crc32_ieee_update(crc, mapped + sizeof(*header), table_end - sizeof(*header));
+    if (crc != header->crc32)
+    {
+        return -EBADMSG;
+    }
+
+    const struct flash_assets_entry *table = (const void *)(mapped + sizeof(*header));
+    for (uint16_t i = 0; i < header->count; i++)
+    {
+        if (table[i].name[FLASH_ASSETS_NAME_LEN - 1] != '\0' || table[i].offset < table_end ||
+            table[i].offset > header->size || table[i].size > header->size - table[i].offset)
+        {
+            return -EBADMSG;
+        }
+        // flash_assets_get() bisects
+        if (i > 0 && strncmp(table[i - 1].name, table[i].name, FLASH_ASSETS_NAME_LEN) >= 0)
+        {
+            return -EBADMSG;
+        }
+    }
+    return 0;
+}
+
+int flash_assets_init(void)
+{
+    const struct flash_area *area;
+    struct flash_assets_header header;
+
+    flash_assets_unmap();
+
+    int ret = flash_area_open(FIXED_PARTITION_ID(assets_partition), &area);
+    if (ret < 0)
+    {
+        LOG_ERR("Failed to open assets_partition: %d", ret);
+        return ret;
+    }
+
+    // the header tells how much to map
+    ret = flash_area_read(area, 0, &header, sizeof(header));
+    if (ret < 0)
+    {
+        goto out;
+    }
+    if (header.magic != FLASH_ASSETS_MAGIC || header.size < sizeof(header) || header.size > area->fa_size)
+    {
+        LOG_INF("No asset image");
+        ret = -ENOENT;
+        goto out;
+    }
+
+    const uint8_t *mapped = flash_assets_map(area, header.size);
+    if (mapped == NULL)
+    {
+        LOG_ERR("Failed to map %u bytes", header.size);
+        ret = -ENOMEM;
+        goto out;
+    }
+    ret = flash_assets_check_table(mapped, area->fa_size);
+    if (ret < 0)
+    {
+        LOG_ERR("Asset image is damaged");
+        flash_assets_release();
+        goto out;
+    }
+
+    image = mapped;
+    entries = (const void *)(mapped + sizeof(header));
+    entry_count = header.count;
+    LOG_INF("%u assets, %u bytes mapped at %p", header.count, header.size, (const void *)image);
+
+out:
+    flash_area_close(area);
+    return ret;
+}
+
+void flash_assets_unmap(void)
+{
+    if (image != NULL)
+    {
+        image = NULL;
+        entries = NULL;
+        entry_count = 0;
+        flash_assets_release();
+    }
+}
+
+int flash_assets_get(const char *name, struct flash_asset *asset)
+{
+    if (image == NULL)
+    {
+        return -ENODEV;
+    }
+
+    size_t lo = 0;
+    size_t hi = entry_count;
+    while (lo < hi)
+    {
+        const size_t mid = lo + (hi - lo) / 2;
+        const int cmp = strncmp(name, entries[mid].name, FLASH_ASSETS_NAME_LEN);
+        if (cmp == 0)
+        {
+            *asset = (struct flash_asset){
+                .data = image + entries[mid].offset,
+                .size = entries[mid].size,
+                .crc32 = entries[mid].crc32,
+            };
+            return 0;
+        }
+        if (cmp < 0)
+        {
+            hi = mid;
+        }
+        else
+        {
+            lo = mid + 1;
+        }
+    }
+    return -ENOENT;
+}
+
+int flash_assets_check(const struct flash_asset *asset)
+{
+    return crc32_ieee(asset->data, asset->size) == asset->crc32 ? 0 : -EBADMSG;
+}
+
+static int flash_assets_sys_init(void)
+{
+    (void)flash_assets_init();
+    return 0;
+}
+
+SYS_INIT(flash_assets_sys_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
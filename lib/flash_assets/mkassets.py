@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+# SPDX-License-Identifier: Apache-2.0
+
+"""Pack files into an image for assets_partition.
+
+Each file is an asset named after it (without its directory), or NAME=PATH
+to name it explicitly. The layout is described in
+include/t_watch_s3/flash_assets.h. Flash the image at the partition's
+offset, for instance:
+
+    esptool.py write_flash 0xf00000 assets.bin
+"""
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+MAGIC = 0x53415754
+VERSION = 1
+NAME_LEN = 20
+HEADER = struct.Struct("<IHHI")
+ENTRY = struct.Struct(f"<{NAME_LEN}sIII")
+ALIGN = 4
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("output", help="image to write")
+    parser.add_argument("assets", nargs="+", help="PATH or NAME=PATH")
+    parser.add_argument("--partition-size", type=lambda x: int(x, 0), default=0x100000,
+                        help="size of assets_partition (default: 1 MB)")
+    args = parser.parse_args()
+
+    assets = {}
+    for arg in args.assets:
+        name, _, path = arg.rpartition("=")
+        name = name or os.path.basename(path)
+        encoded = name.encode("utf-8")
+        if len(encoded) >= NAME_LEN:
+            sys.exit(f"{name}: names are at most {NAME_LEN - 1} bytes")
+        if encoded in assets:
+            sys.exit(f"{name}: given twice")
+        with open(path, "rb") as f:
+            assets[encoded] = f.read()
+
+    # flash_assets_get() bisects the entries, comparing names like strncmp()
+    names = sorted(assets)
+    offset = HEADER.size + 4 + len(names) * ENTRY.size
+    table = b""
+    data = b""
+    for name in names:
+        pad = -(offset + len(data)) % ALIGN
+        data += b"\xff" * pad
+        table += ENTRY.pack(name, offset + len(data), len(assets[name]), zlib.crc32(assets[name]))
+        data += assets[name]
+
+    size = offset + len(data)
+    if size > args.partition_size:
+        sys.exit(f"image is {size} bytes, the partition {args.partition_size}")
+
+    header = HEADER.pack(MAGIC, VERSION, len(names), size)
+    crc = zlib.crc32(header + table)
+    with open(args.output, "wb") as f:
+        f.write(header + struct.pack("<I", crc) + table + data)
+
+    for name in names:
+        print(f"  {name.decode('utf-8'):<{NAME_LEN}} {len(assets[name]):>8} bytes")
+    print(f"{args.output}: {len(names)} assets, {size} bytes")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,244 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <t_watch_s3/frame_pacer.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/display.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(frame_pacer, CONFIG_FRAME_PACER_LOG_LEVEL);
+
+#define DISPLAY_NODE DT_CHOSEN(zephyr_display)
+
+BUILD_ASSERT(DT_NODE_HAS_COMPAT(DISPLAY_NODE, sitronix_st7789v), "Frame pacer expects an ST7789V");
+
+// ST7789V datasheet, FRCTRL2 (C6h): in normal mode the panel refreshes at
+//   10MHz / ((320 + FPA + BPA) * (250 + RTNA * 16))
+// where BPA and FPA are the first two PORCTRL (B2h) parameters. The
+// controller always scans all 320 lines, even though only 240 are visible.
+// LCMCTRL (the lcm property) only flips/inverts lines and has no effect on timing.
+#define ST7789V_LINES 320U
+#define ST7789V_BPA DT_PROP_BY_IDX(DISPLAY_NODE, porch_param, 0)
+#define ST7789V_FPA DT_PROP_BY_IDX(DISPLAY_NODE, porch_param, 1)
+#define ST7789V_LINE_CLOCKS (250U + CONFIG_T_WATCH_S3_FRAME_PACER_RTNA * 16U)
+#define ST7789V_PERIOD_NS ((ST7789V_LINES + ST7789V_BPA + ST7789V_FPA) * ST7789V_LINE_CLOCKS * 100U)
+
+#define FRAME_PACER_PERIOD_NS (ST7789V_PERIOD_NS * CONFIG_T_WATCH_S3_FRAME_PACER_DIVIDER)
+#define QUEUE_DEPTH CONFIG_T_WATCH_S3_FRAME_PACER_QUEUE_DEPTH
+#define HISTOGRAM_BINS CONFIG_T_WATCH_S3_FRAME_PACER_HISTOGRAM_BINS
+
+static const struct device *const display = DEVICE_DT_GET(DISPLAY_NODE);
+
+// Single consumer ring. Producers append at the tail under the lock, only
+// the pacer thread moves the head, so complete frames can be read without it.
+static struct frame_pacer_rect queue[QUEUE_DEPTH];
+static size_t head;
+static size_t tail;
+static size_t ready_frames;
+static struct k_spinlock lock;
+
+static K_SEM_DEFINE(free_slots, QUEUE_DEPTH, QUEUE_DEPTH);
+static K_SEM_DEFINE(frame_ready, 0, 1);
+static K_TIMER_DEFINE(slot_timer, NULL, NULL);
+
+static struct frame_pacer_stats stats;
+static uint32_t last_flush_start;
+static bool have_last_flush;
+
+static void frame_pacer_histogram_add(uint32_t *histogram, uint32_t cycles)
+{
+    const uint32_t ms = k_cyc_to_ms_floor32(cycles);
+    histogram[MIN(ms, HISTOGRAM_BINS - 1)]++;
+}
+
+static const struct frame_pacer_rect *frame_pacer_pop(void)
+{
+    const struct frame_pacer_rect *rect = &queue[head];
+    head = (head + 1) % QUEUE_DEPTH;
+    return rect;
+}
+
+// Flush every frame that was complete when the slot started. Returns the
+// number of frames that were taken off the queue.
+static size_t frame_pacer_flush(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    const size_t frames = ready_frames;
+    k_spin_unlock(&lock, key);
+
+    if (frames == 0)
+    {
+        return 0;
+    }
+
+    // Anything older than the newest full-screen frame would be overdrawn
+    // anyway, so skip writing it
+    size_t drop = 0;
+    for (size_t i = head, frame = 0; frame < frames; i = (i + 1) % QUEUE_DEPTH)
+    {
+        if (queue[i].flags & FRAME_PACER_FLAG_LAST)
+        {
+            if (queue[i].flags & FRAME_PACER_FLAG_FULL)
+            {
+                drop = frame;
+            }
+            frame++;
+        }
+    }
+
+    const uint32_t start = k_cycle_get_32();
+    if (have_last_flush)
+    {
+        frame_pacer_histogram_add(stats.interval_ms, start - last_flush_start);
+    }
+    last_flush_start = start;
+    have_last_flush = true;
+
+    for (size_t frame = 0; frame < frames;)
+    {
+        const struct frame_pacer_rect *rect = frame_pacer_pop();
+        int status = -ECANCELED;
+
+        if (frame >= drop)
+        {
+            status = display_write(display, rect->x, rect->y, &rect->desc, rect->buf);
+            if (status < 0)
+            {
+                LOG_ERR("display_write failed: %d", status);
+            }
+        }
+
+        if (rect->flags & FRAME_PACER_FLAG_LAST)
+        {
+            frame++;
+        }
+
+        if (rect->done != NULL)
+        {
+            rect->done(rect, status, rect->user_data);
+        }
+        k_sem_give(&free_slots);
+    }
+
+    frame_pacer_histogram_add(stats.flush_ms, k_cycle_get_32() - start);
+    stats.presented += frames - drop;
+    stats.dropped += drop;
+    stats.merged += frames - drop - 1;
+
+    key = k_spin_lock(&lock);
+    ready_frames -= frames;
+    k_spin_unlock(&lock, key);
+
+    return frames;
+}
+
+static void frame_pacer_thread(void *p1, void *p2, void *p3)
+{
+    ARG_UNUSED(p1);
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    bool running = false;
+    uint32_t idle_slots = 0;
+
+    while (true)
+    {
+        if (!running)
+        {
+            k_sem_take(&frame_ready, K_FOREVER);
+
+            // The first frame after idle goes out right away. Without a TE line
+            // there's no phase to preserve, only the spacing between frames.
+            k_timer_start(&slot_timer, K_NO_WAIT, K_NSEC(FRAME_PACER_PERIOD_NS));
+            have_last_flush = false;
+            running = true;
+            idle_slots = 0;
+        }
+
+        const uint32_t expired = k_timer_status_sync(&slot_timer);
+        if (expired > 1)
+        {
+            stats.missed_slots += expired - 1;
+        }
+
+        if (frame_pacer_flush() > 0)
+        {
+            idle_slots = 0;
+            continue;
+        }
+
+        if (++idle_slots >= CONFIG_T_WATCH_S3_FRAME_PACER_IDLE_FRAMES)
+        {
+            k_sem_reset(&frame_ready);
+
+            k_spinlock_key_t key = k_spin_lock(&lock);
+            running = ready_frames > 0;
+            k_spin_unlock(&lock, key);
+
+            if (!running)
+            {
+                k_timer_stop(&slot_timer);
+            }
+        }
+    }
+}
+
+K_THREAD_DEFINE(frame_pacer_tid, CONFIG_T_WATCH_S3_FRAME_PACER_STACK_SIZE, frame_pacer_thread, NULL, NULL, NULL,
+                CONFIG_T_WATCH_S3_FRAME_PACER_THREAD_PRIORITY, 0, 0);
+
+int frame_pacer_submit(const struct frame_pacer_rect *rect, k_timeout_t timeout)
+{
+    if (rect == NULL || rect->buf == NULL)
+    {
+        return -EINVAL;
+    }
+
+    int ret = k_sem_take(&free_slots, timeout);
+    if (ret < 0)
+    {
+        return ret;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    queue[tail] = *rect;
+    tail = (tail + 1) % QUEUE_DEPTH;
+    if (rect->flags & FRAME_PACER_FLAG_LAST)
+    {
+        ready_frames++;
+    }
+    k_spin_unlock(&lock, key);
+
+    if (rect->flags & FRAME_PACER_FLAG_LAST)
+    {
+        k_sem_give(&frame_ready);
+    }
+
+    return 0;
+}
+
+uint32_t frame_pacer_panel_period_ns(void)
+{
+    return ST7789V_PERIOD_NS;
+}
+
+uint32_t frame_pacer_period_ns(void)
+{
+    return FRAME_PACER_PERIOD_NS;
+}
+
+// The counters are only written by the pacer thread. A snapshot taken
+// mid-flush may be off by one frame, which is fine for statistics.
+void frame_pacer_stats_get(struct frame_pacer_stats *out)
+{
+    *out = stats;
+}
+
+void frame_pacer_stats_reset(void)
+{
+    memset(&stats, 0, sizeof(stats));
+}
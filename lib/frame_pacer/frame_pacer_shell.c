@@ -0,0 +1,55 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <t_watch_s3/frame_pacer.h>
+
+#include <zephyr/shell/shell.h>
+
+static void frame_pacer_print_histogram(const struct shell *sh, const char *name, const uint32_t *histogram)
+{
+    shell_print(sh, "%s (ms: count)", name);
+    for (size_t i = 0; i < CONFIG_T_WATCH_S3_FRAME_PACER_HISTOGRAM_BINS; i++)
+    {
+        if (histogram[i] == 0)
+        {
+            continue;
+        }
+        const bool overflow = i == CONFIG_T_WATCH_S3_FRAME_PACER_HISTOGRAM_BINS - 1;
+        shell_print(sh, "  %s%2u: %u", overflow ? ">=" : "", (unsigned int)i, histogram[i]);
+    }
+}
+
+static int cmd_frame_pacer_stats(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    static struct frame_pacer_stats stats;
+    frame_pacer_stats_get(&stats);
+
+    shell_print(sh, "panel period %u ns, flush period %u ns", frame_pacer_panel_period_ns(),
+                frame_pacer_period_ns());
+    shell_print(sh, "presented %u, dropped %u, merged %u, missed slots %u", stats.presented, stats.dropped,
+                stats.merged, stats.missed_slots);
+    frame_pacer_print_histogram(sh, "frame interval", stats.interval_ms);
+    frame_pacer_print_histogram(sh, "flush time", stats.flush_ms);
+    return 0;
+}
+
+static int cmd_frame_pacer_reset(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(sh);
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    frame_pacer_stats_reset();
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(frame_pacer_cmds,
+                               SHELL_CMD(stats, NULL, "Show frame timing statistics", cmd_frame_pacer_stats),
+                               SHELL_CMD(reset, NULL, "Reset frame timing statistics", cmd_frame_pacer_reset),
+                               SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(frame_pacer, &frame_pacer_cmds, "Display frame pacer", NULL);
@@ -0,0 +1,30 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <t_watch_s3/haptic_queue.h>
+
+size_t haptic_envelope_render(const struct haptic_envelope_point *points, size_t n_points, uint16_t rate_hz,
+                              uint8_t *samples, size_t max)
+{
+    size_t len = 0;
+    int32_t level = 0;
+
+    for (size_t p = 0; p < n_points; p++)
+    {
+        // a ramp too short for a single sample is a step
+        const int32_t steps = (int32_t)points[p].ms * rate_hz / MSEC_PER_SEC;
+        const int32_t delta = points[p].level - level;
+        for (int32_t s = 1; s <= steps; s++)
+        {
+            if (len == max)
+            {
+                return len;
+            }
+            samples[len++] = level + delta * s / steps;
+        }
+        level = points[p].level;
+    }
+
+    return len;
+}
@@ -0,0 +1,476 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <t_watch_s3/haptic_queue.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/haptics.h>
+#include <zephyr/drivers/haptics/drv2605.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(haptic_queue, CONFIG_HAPTIC_QUEUE_LOG_LEVEL);
+
+#define HAPTIC_NODE DT_ALIAS(haptic)
+
+BUILD_ASSERT(DT_NODE_HAS_COMPAT(HAPTIC_NODE, ti_drv2605), "The haptic queue expects a DRV2605");
+
+// Registers the driver has no API for: the waveform sequencer, written
+// directly so unchanged entries can be skipped, GO, which the DRV2605
+// clears at the end of the sequence, and everything RTP streaming needs
+#define HAPTIC_REG_MODE 0x01
+#define HAPTIC_REG_RTP_INPUT 0x02
+#define HAPTIC_REG_WAV_FRM_SEQ1 0x04
+#define HAPTIC_REG_GO 0x0C
+#define HAPTIC_REG_CONTROL3 0x1D
+#define HAPTIC_GO BIT(0)
+#define HAPTIC_MODE_INTERNAL_TRIGGER 0x00
+#define HAPTIC_MODE_RTP 0x05
+#define HAPTIC_CONTROL3_DATA_FORMAT_RTP_UNSIGNED BIT(3)
+
+#define HAPTIC_RTP_MAX_RATE_HZ 1000
+
+#define HAPTIC_SEQ_LEN DRV2605_WAVEFORM_SEQUENCER_MAX
+// A sequence entry that waits instead of playing, in steps of 10ms
+#define HAPTIC_WAIT(ms) (BIT(7) | ((ms) / 10))
+
+struct haptic_effect_def
+{
+    const char *name;
+    // ROM effect numbers, ended by 0 when shorter than the sequencer
+    uint8_t seq[HAPTIC_SEQ_LEN];
+};
+
+static const struct haptic_effect_def effects[HAPTIC_EFFECT_COUNT] = {
+    [HAPTIC_EFFECT_CLICK] = {"click", {1}},
+    [HAPTIC_EFFECT_DOUBLE_CLICK] = {"double click", {10}},
+    [HAPTIC_EFFECT_TICK] = {"tick", {24}},
+    [HAPTIC_EFFECT_BUZZ] = {"buzz", {47}},
+    [HAPTIC_EFFECT_NOTIFY] = {"notify", {4, HAPTIC_WAIT(330), 4, HAPTIC_WAIT(330), 4, HAPTIC_WAIT(330), 4}},
+    [HAPTIC_EFFECT_ALERT] = {"alert", {16}},
+    [HAPTIC_EFFECT_ENVELOPE] = {"envelope"},
+};
+
+struct haptic_queue_item
+{
+    enum haptic_effect effect;
+    const struct haptic_envelope *envelope;
+    haptic_queue_done_t done;
+    void *user_data;
+};
+
+static const struct device *const haptic = DEVICE_DT_GET(HAPTIC_NODE);
+static const struct i2c_dt_spec i2c = I2C_DT_SPEC_GET(HAPTIC_NODE);
+
+K_MSGQ_DEFINE(haptic_queue, sizeof(struct haptic_queue_item), CONFIG_T_WATCH_S3_HAPTIC_QUEUE_DEPTH, 4);
+
+static void haptic_queue_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(haptic_queue_work, haptic_queue_work_handler);
+
+static K_MUTEX_DEFINE(lock);
+static bool ready;
+static bool playing;
+static struct haptic_queue_item current;
+static uint32_t started_ms;
+// what the DRV2605's sequencer holds, once known
+static uint8_t seq[HAPTIC_SEQ_LEN];
+static bool seq_known;
+static struct haptic_queue_stats stats;
+
+// handed to the RTP thread, which sets rtp_finished and kicks the work
+// item once the envelope is over
+static K_SEM_DEFINE(rtp_start_sem, 0, 1);
+static K_TIMER_DEFINE(rtp_timer, NULL, NULL);
+static const struct haptic_envelope *rtp_envelope;
+static bool rtp_finished;
+static int rtp_status;
+static atomic_t rtp_cancel;
+
+const char *haptic_effect_name(enum haptic_effect effect)
+{
+    return effect < HAPTIC_EFFECT_COUNT ? effects[effect].name : "unknown";
+}
+
+// Rewrites the span of the sequencer that differs from the effect, then
+// sets GO
+static int haptic_queue_start(enum haptic_effect effect)
+{
+    const uint8_t *want = effects[effect].seq;
+    size_t first = 0;
+    size_t last = HAPTIC_SEQ_LEN;
+    if (seq_known)
+    {
+        while (first < HAPTIC_SEQ_LEN && want[first] == seq[first])
+        {
+            first++;
+        }
+        while (last > first && want[last - 1] == seq[last - 1])
+        {
+            last--;
+        }
+    }
+
+    if (last > first)
+    {
+        int ret = i2c_burst_write_dt(&i2c, HAPTIC_REG_WAV_FRM_SEQ1 + first, &want[first], last - first);
+        if (ret < 0)
+        {
+            seq_known = false;
+            return ret;
+        }
+        memcpy(&seq[first], &want[first], last - first);
+        seq_known = true;
+    }
+    stats.seq_writes += last - first;
+    stats.seq_skips += HAPTIC_SEQ_LEN - (last - first);
+
+    return haptics_start_output(haptic);
+}
+
+static void haptic_queue_work_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    // callbacks run with the lock released, so they can queue more
+    struct haptic_queue_item done[2];
+    int status[2];
+    size_t n_done = 0;
+
+    k_mutex_lock(&lock, K_FOREVER);
+    if (playing)
+    {
+        int ret;
+        if (current.envelope != NULL)
+        {
+            if (!rtp_finished)
+            {
+                k_mutex_unlock(&lock);
+                return;
+            }
+            rtp_finished = false;
+            ret = rtp_status;
+        }
+        else
+        {
+            uint8_t go;
+            ret = i2c_reg_read_byte_dt(&i2c, HAPTIC_REG_GO, &go);
+            stats.polls++;
+            if (ret == 0 && (go & HAPTIC_GO))
+            {
+                k_work_schedule(&haptic_queue_work, K_MSEC(CONFIG_T_WATCH_S3_HAPTIC_QUEUE_POLL_MS));
+                k_mutex_unlock(&lock);
+                return;
+            }
+        }
+
+        playing = false;
+        if (ret == 0)
+        {
+            stats.played++;
+            stats.last_play_ms = k_uptime_get_32() - started_ms;
+        }
+        else if (ret == -ECANCELED)
+        {
+            stats.cancelled++;
+        }
+        done[n_done] = current;
+        status[n_done++] = ret;
+    }
+
+    if (k_msgq_get(&haptic_queue, &current, K_NO_WAIT) == 0)
+    {
+        int ret = 0;
+        if (current.envelope != NULL)
+        {
+            rtp_envelope = current.envelope;
+            atomic_clear(&rtp_cancel);
+            k_sem_give(&rtp_start_sem);
+        }
+        else
+        {
+            ret = haptic_queue_start(current.effect);
+        }
+
+        if (ret == 0)
+        {
+            LOG_DBG("Playing %s", effects[current.effect].name);
+            playing = true;
+            started_ms = k_uptime_get_32();
+            if (current.envelope == NULL)
+            {
+                k_work_schedule(&haptic_queue_work, K_MSEC(CONFIG_T_WATCH_S3_HAPTIC_QUEUE_POLL_MS));
+            }
+        }
+        else
+        {
+            LOG_ERR("Failed to play %s: %d", effects[current.effect].name, ret);
+            done[n_done] = current;
+            status[n_done++] = ret;
+            // on to the next one, if any
+            k_work_schedule(&haptic_queue_work, K_NO_WAIT);
+        }
+    }
+    k_mutex_unlock(&lock);
+
+    for (size_t i = 0; i < n_done; i++)
+    {
+        if (done[i].done != NULL)
+        {
+            done[i].done(done[i].effect, status[i], done[i].user_data);
+        }
+    }
+}
+
+static int haptic_queue_push(const struct haptic_queue_item *item)
+{
+    if (!ready)
+    {
+        return -ENODEV;
+    }
+    if (k_msgq_put(&haptic_queue, item, K_NO_WAIT) != 0)
+    {
+        return -ENOMEM;
+    }
+
+    // while an effect plays, the next one starts once it is over
+    k_mutex_lock(&lock, K_FOREVER);
+    if (!playing)
+    {
+        k_work_schedule(&haptic_queue_work, K_NO_WAIT);
+    }
+    k_mutex_unlock(&lock);
+
+    return 0;
+}
+
+int haptic_queue_play(enum haptic_effect effect, haptic_queue_done_t done, void *user_data)
+{
+    if (effect >= HAPTIC_EFFECT_ENVELOPE)
+    {
+        return -EINVAL;
+    }
+
+    const struct haptic_queue_item item = {
+        .effect = effect,
+        .done = done,
+        .user_data = user_data,
+    };
+    return haptic_queue_push(&item);
+}
+
+int haptic_queue_play_envelope(const struct haptic_envelope *envelope, haptic_queue_done_t done, void *user_data)
+{
+    if (envelope == NULL || envelope->samples == NULL || envelope->len == 0 || envelope->rate_hz == 0 ||
+        envelope->rate_hz > HAPTIC_RTP_MAX_RATE_HZ)
+    {
+        return -EINVAL;
+    }
+
+    const struct haptic_queue_item item = {
+        .effect = HAPTIC_EFFECT_ENVELOPE,
+        .envelope = envelope,
+        .done = done,
+        .user_data = user_data,
+    };
+    return haptic_queue_push(&item);
+}
+
+void haptic_queue_cancel(void)
+{
+    struct haptic_queue_item cancelled[CONFIG_T_WATCH_S3_HAPTIC_QUEUE_DEPTH + 1];
+    size_t n = 0;
+
+    k_mutex_lock(&lock, K_FOREVER);
+    if (playing && current.envelope != NULL)
+    {
+        // the RTP thread stops at its next sample, and the work item calls
+        // back with -ECANCELED
+        atomic_set(&rtp_cancel, 1);
+    }
+    else if (playing)
+    {
+        int ret = haptics_stop_output(haptic);
+        if (ret < 0)
+        {
+            LOG_ERR("Failed to stop %s: %d", effects[current.effect].name, ret);
+        }
+        (void)k_work_cancel_delayable(&haptic_queue_work);
+        playing = false;
+        cancelled[n++] = current;
+    }
+    while (n < ARRAY_SIZE(cancelled) && k_msgq_get(&haptic_queue, &cancelled[n], K_NO_WAIT) == 0)
+    {
+        n++;
+    }
+    stats.cancelled += n;
+    k_mutex_unlock(&lock);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        if (cancelled[i].done != NULL)
+        {
+            cancelled[i].done(cancelled[i].effect, -ECANCELED, cancelled[i].user_data);
+        }
+    }
+}
+
+// Streams one envelope, a sample per timer period. A write that starts late
+// is measured against its slot; one whose slot has passed entirely is
+// skipped, so the envelope keeps its length in time.
+static int haptic_rtp_play(const struct haptic_envelope *envelope)
+{
+    int ret = i2c_reg_update_byte_dt(&i2c, HAPTIC_REG_CONTROL3, HAPTIC_CONTROL3_DATA_FORMAT_RTP_UNSIGNED,
+                                     HAPTIC_CONTROL3_DATA_FORMAT_RTP_UNSIGNED);
+    if (ret == 0)
+    {
+        ret = i2c_reg_write_byte_dt(&i2c, HAPTIC_REG_MODE, HAPTIC_MODE_RTP);
+    }
+    if (ret < 0)
+    {
+        return ret;
+    }
+
+    const uint32_t period_ticks = k_us_to_ticks_ceil32(USEC_PER_SEC / envelope->rate_hz);
+    const uint32_t period_cycles = k_ticks_to_cyc_floor32(period_ticks);
+    uint32_t samples = 0;
+    uint32_t missed = 0;
+    uint32_t bus_cycles = 0;
+    uint32_t total_jitter_cycles = 0;
+    uint32_t max_jitter_cycles = 0;
+    uint32_t start = 0;
+
+    k_timer_start(&rtp_timer, K_NO_WAIT, K_TICKS(period_ticks));
+    for (size_t i = 0; i < envelope->len; i++)
+    {
+        if (atomic_get(&rtp_cancel))
+        {
+            ret = -ECANCELED;
+            break;
+        }
+
+        const uint32_t expired = k_timer_status_sync(&rtp_timer);
+        const uint32_t now = k_cycle_get_32();
+        if (i == 0)
+        {
+            start = now;
+        }
+        else if (expired > 1)
+        {
+            // late: skip what is overdue, but nothing past the end
+            const size_t skip = MIN(expired - 1, envelope->len - i);
+            missed += skip;
+            i += skip;
+            if (i >= envelope->len)
+            {
+                break;
+            }
+        }
+
+        // the first expiry is the reference, so a write can look a few
+        // cycles early
+        const uint32_t jitter = MAX((int32_t)(now - (start + i * period_cycles)), 0);
+        total_jitter_cycles += jitter;
+        max_jitter_cycles = MAX(max_jitter_cycles, jitter);
+
+        ret = i2c_reg_write_byte_dt(&i2c, HAPTIC_REG_RTP_INPUT, envelope->samples[i]);
+        bus_cycles += k_cycle_get_32() - now;
+        if (ret < 0)
+        {
+            break;
+        }
+        samples++;
+    }
+    k_timer_stop(&rtp_timer);
+    const uint32_t elapsed_cycles = k_cycle_get_32() - start;
+
+    // silent, and back to the ROM effects, whatever happened
+    int stop = i2c_reg_write_byte_dt(&i2c, HAPTIC_REG_RTP_INPUT, 0);
+    if (stop == 0)
+    {
+        stop = i2c_reg_write_byte_dt(&i2c, HAPTIC_REG_MODE, HAPTIC_MODE_INTERNAL_TRIGGER);
+    }
+
+    k_mutex_lock(&lock, K_FOREVER);
+    stats.rtp_samples += samples;
+    stats.rtp_missed += missed;
+    stats.rtp_bus_us += k_cyc_to_us_floor32(bus_cycles);
+    stats.rtp_elapsed_us += k_cyc_to_us_floor32(elapsed_cycles);
+    stats.rtp_total_jitter_us += k_cyc_to_us_floor32(total_jitter_cycles);
+    stats.rtp_max_jitter_us = MAX(stats.rtp_max_jitter_us, k_cyc_to_us_floor32(max_jitter_cycles));
+    stats.rtp_period_us = k_ticks_to_us_floor32(period_ticks);
+    k_mutex_unlock(&lock);
+
+    return ret < 0 ? ret : stop;
+}
+
+static void haptic_rtp_thread(void *p1, void *p2, void *p3)
+{
+    ARG_UNUSED(p1);
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    while (true)
+    {
+        k_sem_take(&rtp_start_sem, K_FOREVER);
+        const int ret = haptic_rtp_play(rtp_envelope);
+
+        k_mutex_lock(&lock, K_FOREVER);
+        rtp_status = ret;
+        rtp_finished = true;
+        k_work_reschedule(&haptic_queue_work, K_NO_WAIT);
+        k_mutex_unlock(&lock);
+    }
+}
+
+K_THREAD_DEFINE(haptic_rtp_tid, CONFIG_T_WATCH_S3_HAPTIC_QUEUE_RTP_STACK_SIZE, haptic_rtp_thread, NULL, NULL, NULL,
+                CONFIG_T_WATCH_S3_HAPTIC_QUEUE_RTP_THREAD_PRIORITY, 0, 0);
+
+void haptic_queue_stats_get(struct haptic_queue_stats *out)
+{
+    k_mutex_lock(&lock, K_FOREVER);
+    *out = stats;
+    k_mutex_unlock(&lock);
+}
+
+void haptic_queue_stats_reset(void)
+{
+    k_mutex_lock(&lock, K_FOREVER);
+    memset(&stats, 0, sizeof(stats));
+    k_mutex_unlock(&lock);
+}
+
+static int haptic_queue_init(void)
+{
+    if (!device_is_ready(haptic) || !i2c_is_ready_dt(&i2c))
+    {
+        LOG_ERR("DRV2605 not ready");
+        return -ENODEV;
+    }
+
+    // The library and the internal trigger (GO) stay as they are from
+    // here on. The sequencer is written by the first effect.
+    static struct drv2605_rom_data rom_data = {
+        .library = DRV2605_LIBRARY_TS2200_D,
+        .trigger = DRV2605_MODE_INTERNAL_TRIGGER,
+    };
+    union drv2605_config_data config = {
+        .rom_data = &rom_data,
+    };
+    int ret = drv2605_haptic_config(haptic, DRV2605_HAPTICS_SOURCE_ROM, &config);
+    if (ret < 0)
+    {
+        LOG_ERR("Failed to configure the DRV2605: %d", ret);
+        return ret;
+    }
+
+    ready = true;
+    return 0;
+}
+
+SYS_INIT(haptic_queue_init, APPLICATION, CONFIG_T_WATCH_S3_HAPTIC_QUEUE_INIT_PRIORITY);
@@ -0,0 +1,274 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <t_watch_s3/lorawan_session.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/crc.h>
+
+#include <LoRaMac.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(lorawan_session, CONFIG_LORAWAN_SESSION_LOG_LEVEL);
+
+// Two settings under SUBTREE:
+//
+//   ctx   - the MAC's whole NVM context (keys, counters, channels), after
+//           a join and then every SAVE_INTERVAL uplinks
+//   nonce - the last DevNonce sent, saved before every join request so
+//           one is never used twice, whatever happens to the session
+//
+// Frame counters may be up to SAVE_INTERVAL uplinks ahead of the saved
+// context, so a restored session skips FCntUp that far ahead: the network
+// only accepts counters that go up, and never seeing a few of them is fine.
+// Downlink counters restored behind are caught up by the next downlink.
+
+#define SUBTREE       "t_watch_s3/lorawan"
+#define SAVE_INTERVAL CONFIG_T_WATCH_S3_LORAWAN_SESSION_SAVE_INTERVAL
+
+struct saved_session
+{
+    // rejects a context from a build with another LoRaMac or region
+    uint32_t size;
+    LoRaMacNvmData_t nvm;
+};
+
+static K_MUTEX_DEFINE(lock);
+static struct saved_session saved;
+static bool have_saved;
+static uint16_t saved_nonce;
+// FCntUp and the MAC settings as of the last save
+static uint32_t saved_fcnt;
+static uint32_t saved_group2_crc;
+static struct lorawan_session_stats stats;
+
+static int lorawan_session_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg)
+{
+    const char *next;
+
+    if (settings_name_steq(name, "ctx", &next) && next == NULL)
+    {
+        have_saved = len == sizeof(saved) && read_cb(cb_arg, &saved, sizeof(saved)) == sizeof(saved) &&
+                     saved.size == sizeof(saved);
+        return 0;
+    }
+    if (settings_name_steq(name, "nonce", &next) && next == NULL)
+    {
+        if (len != sizeof(saved_nonce) || read_cb(cb_arg, &saved_nonce, sizeof(saved_nonce)) != sizeof(saved_nonce))
+        {
+            saved_nonce = 0;
+        }
+        return 0;
+    }
+    return -ENOENT;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(lorawan_session, SUBTREE, NULL, lorawan_session_set, NULL, NULL);
+
+static LoRaMacNvmData_t *lorawan_session_nvm(void)
+{
+    MibRequestConfirm_t mib = {.Type = MIB_NVM_CTXS};
+    return LoRaMacMibGetRequestConfirm(&mib) == LORAMAC_STATUS_OK ? mib.Param.Contexts : NULL;
+}
+
+static int lorawan_session_save_locked(void)
+{
+    const LoRaMacNvmData_t *nvm = lorawan_session_nvm();
+    if (nvm == NULL)
+    {
+        return -EIO;
+    }
+
+    saved.size = sizeof(saved);
+    saved.nvm = *nvm;
+    int ret = settings_save_one(SUBTREE "/ctx", &saved, sizeof(saved));
+    if (ret < 0)
+    {
+        LOG_ERR("Failed to save the session: %d", ret);
+        return ret;
+    }
+    have_saved = true;
+    saved_fcnt = nvm->Crypto.FCntList.FCntUp;
+    saved_group2_crc = nvm->MacGroup2.Crc32;
+    stats.saves++;
+    return 0;
+}
+
+// Hand the saved context to the MAC. lorawan_start() initializes the MAC,
+// which resets its contexts, and the MAC only takes new ones while stopped,
+// so this goes between lorawan_start() and the first join or uplink.
+static bool lorawan_session_restore(const struct lorawan_join_config *join_cfg)
+{
+    LoRaMacNvmData_t *nvm = &saved.nvm;
+
+    if (!have_saved || nvm->MacGroup2.NetworkActivation != ACTIVATION_TYPE_OTAA ||
+        memcmp(nvm->SecureElement.DevEui, join_cfg->dev_eui, SE_EUI_SIZE) != 0 ||
+        memcmp(nvm->SecureElement.JoinEui, join_cfg->otaa.join_eui, SE_EUI_SIZE) != 0)
+    {
+        return false;
+    }
+    stats.found = true;
+
+    saved_fcnt = nvm->Crypto.FCntList.FCntUp;
+    saved_group2_crc = nvm->MacGroup2.Crc32;
+    // the MAC only takes groups whose CRC matches, and LoRaMac's Crc32() is
+    // CRC-32/IEEE
+    nvm->Crypto.FCntList.FCntUp += SAVE_INTERVAL;
+    nvm->Crypto.Crc32 = crc32_ieee((const uint8_t *)&nvm->Crypto, sizeof(nvm->Crypto) - sizeof(nvm->Crypto.Crc32));
+
+    LoRaMacStatus_t status = LoRaMacStop();
+    if (status != LORAMAC_STATUS_OK)
+    {
+        LOG_WRN("Failed to stop the MAC for the restore: %d", status);
+        return false;
+    }
+
+    MibRequestConfirm_t mib = {.Type = MIB_NVM_CTXS, .Param.Contexts = nvm};
+    status = LoRaMacMibSetRequestConfirm(&mib);
+    if (status != LORAMAC_STATUS_OK)
+    {
+        LOG_WRN("The MAC refused the saved session: %d", status);
+    }
+
+    // whether or not it took the session, the MAC has to run again
+    const LoRaMacStatus_t start = LoRaMacStart();
+    if (start != LORAMAC_STATUS_OK)
+    {
+        LOG_ERR("Failed to restart the MAC: %d", start);
+        return false;
+    }
+    if (status != LORAMAC_STATUS_OK)
+    {
+        return false;
+    }
+
+    mib.Type = MIB_NETWORK_ACTIVATION;
+    return LoRaMacMibGetRequestConfirm(&mib) == LORAMAC_STATUS_OK &&
+           mib.Param.NetworkActivation == ACTIVATION_TYPE_OTAA;
+}
+
+static int lorawan_session_join(const struct lorawan_join_config *join_cfg)
+{
+    struct lorawan_join_config cfg = *join_cfg;
+    const int64_t start = k_uptime_get();
+    int ret = -EAGAIN;
+
+    for (int attempt = 0; attempt < CONFIG_T_WATCH_S3_LORAWAN_SESSION_JOIN_ATTEMPTS && ret < 0; attempt++)
+    {
+        // the MAC sends one more than this, and keeps that as the last one
+        cfg.otaa.dev_nonce = MAX(saved_nonce, join_cfg->otaa.dev_nonce);
+        const uint16_t next = cfg.otaa.dev_nonce + 1;
+        ret = settings_save_one(SUBTREE "/nonce", &next, sizeof(next));
+        if (ret < 0)
+        {
+            LOG_ERR("Failed to save DevNonce: %d", ret);
+            break;
+        }
+        saved_nonce = next;
+        stats.dev_nonce = next;
+        stats.join_attempts++;
+
+        ret = lorawan_join(&cfg);
+        if (ret < 0)
+        {
+            LOG_WRN("Join with DevNonce %u failed: %d", next, ret);
+        }
+    }
+    stats.join_ms = k_uptime_get() - start;
+    return ret;
+}
+
+int lorawan_session_start(const struct lorawan_join_config *join_cfg)
+{
+    if (join_cfg->mode != LORAWAN_ACT_OTAA)
+    {
+        return -ENOTSUP;
+    }
+
+    k_mutex_lock(&lock, K_FOREVER);
+    int ret = settings_subsys_init();
+    if (ret == 0)
+    {
+        ret = settings_load_subtree(SUBTREE);
+    }
+    if (ret < 0)
+    {
+        LOG_ERR("Failed to load settings: %d", ret);
+        goto out;
+    }
+
+    ret = lorawan_start();
+    if (ret < 0)
+    {
+        LOG_ERR("Failed to start LoRaWAN: %d", ret);
+        goto out;
+    }
+    stats.restored = lorawan_session_restore(join_cfg);
+    if (stats.restored)
+    {
+        LOG_INF("Session restored at FCntUp %u", saved_fcnt + SAVE_INTERVAL);
+        // keep the skipped ahead FCntUp, or a reset before the next save
+        // would restore the same counters again
+        ret = lorawan_session_save_locked();
+        goto out;
+    }
+
+    ret = lorawan_session_join(join_cfg);
+    if (ret == 0)
+    {
+        ret = lorawan_session_save_locked();
+    }
+
+out:
+    k_mutex_unlock(&lock);
+    return ret;
+}
+
+int lorawan_session_send(uint8_t port, uint8_t *data, uint8_t len, enum lorawan_message_type type)
+{
+    int ret = lorawan_send(port, data, len, type);
+
+    k_mutex_lock(&lock, K_FOREVER);
+    const LoRaMacNvmData_t *nvm = lorawan_session_nvm();
+    if (ret == 0)
+    {
+        stats.uplinks++;
+    }
+    // a failed send may still have used a frame counter
+    if (nvm != NULL &&
+        (nvm->Crypto.FCntList.FCntUp - saved_fcnt >= SAVE_INTERVAL || nvm->MacGroup2.Crc32 != saved_group2_crc))
+    {
+        (void)lorawan_session_save_locked();
+    }
+    k_mutex_unlock(&lock);
+    return ret;
+}
+
+int lorawan_session_save(void)
+{
+    k_mutex_lock(&lock, K_FOREVER);
+    const int ret = lorawan_session_save_locked();
+    k_mutex_unlock(&lock);
+    return ret;
+}
+
+int lorawan_session_forget(void)
+{
+    k_mutex_lock(&lock, K_FOREVER);
+    have_saved = false;
+    const int ret = settings_delete(SUBTREE "/ctx");
+    k_mutex_unlock(&lock);
+    return ret;
+}
+
+void lorawan_session_stats_get(struct lorawan_session_stats *out)
+{
+    k_mutex_lock(&lock, K_FOREVER);
+    *out = stats;
+    k_mutex_unlock(&lock);
+}
@@ -0,0 +1,42 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <lvgl.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(lvgl_psram, CONFIG_LVGL_PSRAM_LOG_LEVEL);
+
+BUILD_ASSERT(CONFIG_T_WATCH_S3_LVGL_PSRAM_INIT_PRIORITY > CONFIG_APPLICATION_INIT_PRIORITY,
+             "PSRAM buffers must be set up after LVGL is initialized");
+
+#define DISPLAY_NODE DT_CHOSEN(zephyr_display)
+#define BUFFER_SIZE                                                                                                    \
+    (DT_PROP(DISPLAY_NODE, width) * CONFIG_T_WATCH_S3_LVGL_PSRAM_BUFFER_LINES * CONFIG_LV_Z_BITS_PER_PIXEL / 8)
+
+// .ext_ram.bss is collected into the PSRAM mapping by the ESP32-S3 linker script.
+// Cache line alignment keeps the DMA engine and the data cache from sharing lines.
+static uint8_t buf0[BUFFER_SIZE] __attribute__((section(".ext_ram.bss"), aligned(64)));
+static uint8_t buf1[BUFFER_SIZE] __attribute__((section(".ext_ram.bss"), aligned(64)));
+
+static int lvgl_psram_init(void)
+{
+    lv_display_t *display = lv_display_get_default();
+    if (display == NULL)
+    {
+        LOG_ERR("No LVGL display");
+        return -ENODEV;
+    }
+
+    // Nothing has been rendered yet, so the glue's own buffers can be swapped
+    // out without synchronizing with the flush thread
+    lv_display_set_buffers(display, buf0, buf1, BUFFER_SIZE, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    LOG_DBG("Using %u byte PSRAM draw buffers", BUFFER_SIZE);
+    return 0;
+}
+
+SYS_INIT(lvgl_psram_init, APPLICATION, CONFIG_T_WATCH_S3_LVGL_PSRAM_INIT_PRIORITY);
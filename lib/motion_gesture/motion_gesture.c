@@ -0,0 +1,311 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <t_watch_s3/motion_gesture.h>
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/input/input.h>
+#include <zephyr/sys/util.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(motion_gesture, CONFIG_MOTION_GESTURE_LOG_LEVEL);
+
+// Everything below works in 1/1024 g, in plain integers. At the ±2g..±16g
+// ranges the IMU supports that is 11 bits of fraction at worst, finer than
+// the BMA423's own LSB at ±4g and up.
+#define G 1024
+#define RATE CONFIG_T_WATCH_S3_MOTION_GESTURE_RATE_HZ
+#define MS_TO_SAMPLES(ms) (((ms) * RATE + 999) / 1000)
+
+// q31 << shift is in m/s^2. This is 2^(16 + 31) / 9.80665 m/s^2 in
+// 1/1024 g, so that (q * MPS2_TO_G) >> (47 - shift) is the reading in
+// 1/1024 g: one multiply and one shift per axis.
+#define MPS2_TO_G ((uint64_t)G * (1ULL << 16) * 100000 / 980665)
+
+// Gravity is a one pole low-pass at ~RATE / (2 pi 16), about 1Hz at
+// 100Hz, kept with 8 bits of extra fraction so it settles on the exact
+// value instead of a step short of it
+#define GRAVITY_SHIFT 4
+#define GRAVITY_FRAC 8
+
+// |high-passed|^2 below this is "still", above the tap threshold is a knock
+#define QUIET_G (3 * G / 10)
+#define TAP_G (3 * G / 2)
+// A tap rises out of stillness and is over quickly, so sustained motion,
+// or a shake through the tap threshold, is not mistaken for one
+#define TAP_QUIET_BEFORE MS_TO_SAMPLES(30)
+#define TAP_MAX_LEN MS_TO_SAMPLES(60)
+#define DOUBLE_TAP_MIN_GAP MS_TO_SAMPLES(80)
+#define DOUBLE_TAP_MAX_GAP MS_TO_SAMPLES(500)
+
+// A shake is SHAKE_REVERSALS swings of more than SHAKE_G along one axis,
+// within one window. Reversals closer than SHAKE_MIN_HALF_PERIOD are a
+// knock ringing out, not a shake (nobody shakes a wrist at over 10Hz).
+#define SHAKE_G (8 * G / 10)
+#define SHAKE_REVERSALS 4
+#define SHAKE_MIN_HALF_PERIOD MS_TO_SAMPLES(50)
+
+// The board reads -1g on Z face up. The arm hangs (screen vertical) before
+// a raise, and the face has to come up within RAISE_MAX of that and
+// stay there, still, for RAISE_STABLE.
+#define RAISE_DOWN_G (3 * G / 10)
+#define RAISE_UP_G (-6 * G / 10)
+#define RAISE_MAX MS_TO_SAMPLES(1000)
+#define RAISE_STABLE MS_TO_SAMPLES(200)
+
+BUILD_ASSERT(TAP_MAX_LEN < DOUBLE_TAP_MIN_GAP, "Tap thresholds do not nest");
+BUILD_ASSERT(RAISE_STABLE > 0 && TAP_QUIET_BEFORE > 0, "Sample rate is too low");
+
+struct axis_shake
+{
+    int8_t sign;
+    uint8_t reversals;
+    uint32_t first;
+    uint32_t last;
+};
+
+struct motion_gesture_state
+{
+    bool primed;
+    // sample count, wraps after a year and a bit at 100Hz
+    uint32_t now;
+    int32_t gravity[3];
+
+    struct axis_shake shake[3];
+    uint32_t shake_until;
+
+    uint16_t quiet;
+    uint16_t tap_len;
+    bool in_tap;
+    bool tap_pending;
+    uint32_t tap_start;
+    uint32_t last_tap;
+
+    bool raise_armed;
+    uint32_t down_at;
+    uint16_t up_stable;
+
+    uint16_t window_samples;
+    uint32_t window_cycles;
+};
+
+static K_MUTEX_DEFINE(lock);
+static struct motion_gesture_state state;
+static struct motion_gesture_stats stats;
+
+DEVICE_DEFINE(motion_gesture, "motion_gesture", NULL, NULL, NULL, NULL, POST_KERNEL,
+              CONFIG_KERNEL_INIT_PRIORITY_DEVICE, NULL);
+
+const struct device *motion_gesture_device(void)
+{
+    return DEVICE_GET(motion_gesture);
+}
+
+static void report(enum motion_gesture gesture)
+{
+    const struct device *dev = DEVICE_GET(motion_gesture);
+    const uint16_t code = MOTION_GESTURE_INPUT_CODE(gesture);
+
+    stats.events[gesture]++;
+    LOG_DBG("gesture %d at sample %u", gesture, state.now);
+
+    // never stall the sample path on a full input queue
+    if (input_report_key(dev, code, 1, true, K_NO_WAIT) != 0 || input_report_key(dev, code, 0, true, K_NO_WAIT) != 0)
+    {
+        stats.dropped++;
+    }
+}
+
+static void shake_step(const int32_t hp[3])
+{
+    for (int axis = 0; axis < 3; axis++)
+    {
+        struct axis_shake *s = &state.shake[axis];
+        const int8_t sign = hp[axis] > SHAKE_G ? 1 : hp[axis] < -SHAKE_G ? -1 : 0;
+        if (sign == 0 || sign == s->sign)
+        {
+            continue;
+        }
+
+        const bool reversal = s->sign != 0 && state.now - s->last >= SHAKE_MIN_HALF_PERIOD;
+        s->sign = sign;
+        if (!reversal)
+        {
+            continue;
+        }
+        s->last = state.now;
+
+        if (s->reversals == 0 || state.now - s->first > RATE)
+        {
+            s->first = state.now;
+            s->reversals = 0;
+        }
+        if (++s->reversals >= SHAKE_REVERSALS && (int32_t)(state.now - state.shake_until) >= 0)
+        {
+            report(MOTION_GESTURE_SHAKE);
+            // one shake per window, however long the user keeps at it
+            state.shake_until = state.now + RATE;
+            s->reversals = 0;
+        }
+    }
+}
+
+static void tap_step(uint32_t mag2)
+{
+    if (!state.in_tap)
+    {
+        if (mag2 > TAP_G * TAP_G && state.quiet >= TAP_QUIET_BEFORE)
+        {
+            state.in_tap = true;
+            state.tap_len = 0;
+            state.tap_start = state.now;
+        }
+        state.quiet = mag2 < QUIET_G * QUIET_G ? MIN(state.quiet + 1, UINT16_MAX) : 0;
+        return;
+    }
+
+    if (++state.tap_len > TAP_MAX_LEN)
+    {
+        // motion, not a knock: forget any first tap as well
+        state.in_tap = false;
+        state.tap_pending = false;
+        state.quiet = 0;
+        return;
+    }
+    if (mag2 >= QUIET_G * QUIET_G)
+    {
+        return;
+    }
+
+    state.in_tap = false;
+    state.quiet = 1;
+    // measured onset to onset: how long a knock takes to ring out depends
+    // on the strap and the wrist
+    const uint32_t gap = state.tap_start - state.last_tap;
+    if (state.tap_pending && gap >= DOUBLE_TAP_MIN_GAP && gap <= DOUBLE_TAP_MAX_GAP)
+    {
+        report(MOTION_GESTURE_DOUBLE_TAP);
+        state.tap_pending = false;
+        return;
+    }
+    state.tap_pending = true;
+    state.last_tap = state.tap_start;
+}
+
+static void raise_step(const int32_t gravity[3], uint32_t mag2)
+{
+    if (ABS(gravity[2]) < RAISE_DOWN_G)
+    {
+        state.raise_armed = true;
+        state.down_at = state.now;
+        state.up_stable = 0;
+        return;
+    }
+    if (!state.raise_armed)
+    {
+        return;
+    }
+    if (gravity[2] > RAISE_UP_G)
+    {
+        // somewhere in between, or face down
+        state.up_stable = 0;
+        return;
+    }
+    if (state.up_stable == 0 && state.now - state.down_at > RAISE_MAX)
+    {
+        // too slow to be a glance at the watch, wait for the arm to drop
+        state.raise_armed = false;
+        return;
+    }
+    if (mag2 < QUIET_G * QUIET_G && ++state.up_stable >= RAISE_STABLE)
+    {
+        report(MOTION_GESTURE_WRIST_RAISE);
+        state.raise_armed = false;
+    }
+}
+
+static void sample_step(const int32_t g[3])
+{
+    if (!state.primed)
+    {
+        // start from the first reading rather than from 0g, or the filter
+        // would spend its first second "falling" into place
+        for (int axis = 0; axis < 3; axis++)
+        {
+            state.gravity[axis] = g[axis] * (1 << GRAVITY_FRAC);
+        }
+        state.primed = true;
+    }
+
+    int32_t gravity[3];
+    int32_t hp[3];
+    uint32_t mag2 = 0;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        state.gravity[axis] += ((g[axis] * (1 << GRAVITY_FRAC)) - state.gravity[axis]) >> GRAVITY_SHIFT;
+        gravity[axis] = state.gravity[axis] >> GRAVITY_FRAC;
+        hp[axis] = CLAMP(g[axis] - gravity[axis], INT16_MIN, INT16_MAX);
+        mag2 += hp[axis] * hp[axis];
+    }
+
+    shake_step(hp);
+    tap_step(mag2);
+    raise_step(gravity, mag2);
+    state.now++;
+}
+
+void motion_gesture_feed(const struct sensor_three_axis_data *data)
+{
+    const uint32_t start = k_cycle_get_32();
+    const int rshift = 47 - data->shift;
+    if (rshift < 0 || rshift > 62)
+    {
+        LOG_WRN("Unsupported shift %d", data->shift);
+        return;
+    }
+
+    k_mutex_lock(&lock, K_FOREVER);
+    for (uint16_t i = 0; i < data->header.reading_count; i++)
+    {
+        int32_t g[3];
+        for (int axis = 0; axis < 3; axis++)
+        {
+            const int64_t q = data->readings[i].values[axis];
+            g[axis] = CLAMP((q * (int64_t)MPS2_TO_G) >> rshift, INT16_MIN, INT16_MAX);
+        }
+        sample_step(g);
+    }
+
+    stats.samples += data->header.reading_count;
+    state.window_samples += data->header.reading_count;
+    state.window_cycles += k_cycle_get_32() - start;
+    if (state.window_samples >= RATE)
+    {
+        // a batch may straddle windows: its whole cost lands in the one it ends
+        stats.windows++;
+        stats.last_window_us = k_cyc_to_us_floor32(state.window_cycles);
+        stats.max_window_us = MAX(stats.max_window_us, stats.last_window_us);
+        state.window_samples %= RATE;
+        state.window_cycles = 0;
+    }
+    k_mutex_unlock(&lock);
+}
+
+void motion_gesture_stats_get(struct motion_gesture_stats *out)
+{
+    k_mutex_lock(&lock, K_FOREVER);
+    *out = stats;
+    k_mutex_unlock(&lock);
+}
+
+void motion_gesture_reset(void)
+{
+    k_mutex_lock(&lock, K_FOREVER);
+    memset(&state, 0, sizeof(state));
+    memset(&stats, 0, sizeof(stats));
+    k_mutex_unlock(&lock);
+}
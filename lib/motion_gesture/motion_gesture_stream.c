@@ -0,0 +1,117 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <t_watch_s3/motion_gesture.h>
+
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/rtio/rtio.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(motion_gesture, CONFIG_MOTION_GESTURE_LOG_LEVEL);
+
+#define IMU_NODE DT_ALIAS(accel)
+
+// Frames decoded per call. The batch lives in static memory, like every
+// other buffer on this path.
+#define BATCH 32
+
+// Room for a few full FIFO drains (170 frames of 6 bytes, plus a header)
+RTIO_DEFINE_WITH_MEMPOOL(gesture_rtio, 4, 4, 64, 64, sizeof(void *));
+SENSOR_DT_STREAM_IODEV(gesture_iodev, IMU_NODE, {SENSOR_TRIG_FIFO_WATERMARK, SENSOR_STREAM_DATA_INCLUDE},
+                       {SENSOR_TRIG_FIFO_FULL, SENSOR_STREAM_DATA_INCLUDE});
+
+static const struct device *const imu = DEVICE_DT_GET(IMU_NODE);
+static K_MUTEX_DEFINE(stream_lock);
+static struct rtio_sqe *handle;
+
+static struct
+{
+    struct sensor_three_axis_data data;
+    struct sensor_three_axis_sample_data more[BATCH - 1];
+} batch;
+
+int motion_gesture_start(void)
+{
+    if (!device_is_ready(imu))
+    {
+        return -ENODEV;
+    }
+
+    const struct sensor_value odr = {.val1 = CONFIG_T_WATCH_S3_MOTION_GESTURE_RATE_HZ};
+    int res = 0;
+    k_mutex_lock(&stream_lock, K_FOREVER);
+    if (handle == NULL)
+    {
+        res = sensor_attr_set(imu, SENSOR_CHAN_ACCEL_XYZ, SENSOR_ATTR_SAMPLING_FREQUENCY, &odr);
+        if (res == 0)
+        {
+            motion_gesture_reset();
+            res = sensor_stream(&gesture_iodev, &gesture_rtio, (void *)imu, &handle);
+        }
+    }
+    k_mutex_unlock(&stream_lock);
+    return res;
+}
+
+int motion_gesture_stop(void)
+{
+    k_mutex_lock(&stream_lock, K_FOREVER);
+    if (handle != NULL)
+    {
+        rtio_sqe_cancel(handle);
+        handle = NULL;
+    }
+    k_mutex_unlock(&stream_lock);
+    return 0;
+}
+
+static void motion_gesture_thread(void *p1, void *p2, void *p3)
+{
+    ARG_UNUSED(p1);
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    const struct sensor_decoder_api *decoder;
+    if (sensor_get_decoder(imu, &decoder) != 0)
+    {
+        LOG_ERR("IMU has no decoder");
+        return;
+    }
+    const struct sensor_chan_spec ch_spec = {.chan_idx = 0, .chan_type = SENSOR_CHAN_ACCEL_XYZ};
+
+    while (true)
+    {
+        struct rtio_cqe *cqe = rtio_cqe_consume_block(&gesture_rtio);
+        const int result = cqe->result;
+        uint8_t *buf;
+        uint32_t buf_len;
+        const int res = rtio_cqe_get_mempool_buffer(&gesture_rtio, cqe, &buf, &buf_len);
+        rtio_cqe_release(&gesture_rtio, cqe);
+        if (res != 0)
+        {
+            // cancelled before the read got a buffer
+            continue;
+        }
+
+        if (result == 0)
+        {
+            uint32_t fit = 0;
+            while (decoder->decode(buf, ch_spec, &fit, BATCH, &batch.data) > 0)
+            {
+                motion_gesture_feed(&batch.data);
+            }
+        }
+        else
+        {
+            LOG_WRN("Stream read failed: %d", result);
+        }
+        rtio_release_buffer(&gesture_rtio, buf, buf_len);
+    }
+}
+
+K_THREAD_DEFINE(motion_gesture_tid, CONFIG_T_WATCH_S3_MOTION_GESTURE_STACK_SIZE, motion_gesture_thread, NULL, NULL,
+                NULL, CONFIG_T_WATCH_S3_MOTION_GESTURE_THREAD_PRIORITY, 0, 0);
@@ -0,0 +1,287 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <t_watch_s3/motion_wake.h>
+#include <t_watch_s3/ext1_wake.h>
+
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/poweroff.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/drivers/sensor/bma423.h>
+#include <zephyr/pm/pm.h>
+
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(motion_wake, CONFIG_MOTION_WAKE_LOG_LEVEL);
+
+#define IMU_NODE DT_ALIAS(accel)
+
+BUILD_ASSERT(DT_NODE_HAS_COMPAT(IMU_NODE, bosch_bma423), "Motion wake expects a BMA423");
+BUILD_ASSERT(DT_NODE_HAS_PROP(IMU_NODE, int1_gpios), "Motion wake needs the IMU's INT1");
+
+// How long the driver gets to clear a pending INT1 before powering off
+#define INT1_CLEAR_TIMEOUT_MS 10
+
+static const struct device *const imu = DEVICE_DT_GET(IMU_NODE);
+static const struct gpio_dt_spec int1 = GPIO_DT_SPEC_GET(IMU_NODE, int1_gpios);
+
+static const struct sensor_trigger motion_trigger = {
+    .type = SENSOR_TRIG_MOTION,
+    .chan = SENSOR_CHAN_ACCEL_XYZ,
+};
+static const struct sensor_trigger stationary_trigger = {
+    .type = SENSOR_TRIG_STATIONARY,
+    .chan = SENSOR_CHAN_ACCEL_XYZ,
+};
+
+static K_MUTEX_DEFINE(lock);
+static K_SEM_DEFINE(motion_sem, 0, 1);
+static atomic_t moving;
+static bool from_poweroff;
+static struct motion_wake_stats stats;
+
+// last light sleep exit on INT1, until the handler accounts for it. Set
+// from the idle thread, hence the spinlock.
+static struct k_spinlock wake_lock;
+static uint64_t wake_ns;
+static uint64_t motion_ns;
+
+static uint64_t now_ns(void)
+{
+    return k_ticks_to_ns_floor64(k_uptime_ticks());
+}
+
+static void motion_wake_handler(const struct device *dev, const struct sensor_trigger *trigger);
+
+// Arms the feature that ends the current state, and disarms the other
+static int motion_wake_arm(bool is_moving)
+{
+    const struct sensor_trigger *arm = is_moving ? &stationary_trigger : &motion_trigger;
+    const struct sensor_trigger *disarm = is_moving ? &motion_trigger : &stationary_trigger;
+
+    int ret = sensor_trigger_set(imu, disarm, NULL);
+    if (ret == 0)
+    {
+        ret = sensor_trigger_set(imu, arm, motion_wake_handler);
+    }
+
+    return ret;
+}
+
+static void motion_wake_handler(const struct device *dev, const struct sensor_trigger *trigger)
+{
+    ARG_UNUSED(dev);
+
+    const uint64_t now = now_ns();
+    const bool is_moving = trigger->type == SENSOR_TRIG_MOTION;
+
+    k_mutex_lock(&lock, K_FOREVER);
+    K_SPINLOCK(&wake_lock)
+    {
+        if (wake_ns != 0)
+        {
+            stats.last_wake_us = (now - wake_ns) / NSEC_PER_USEC;
+            stats.max_wake_us = MAX(stats.max_wake_us, stats.last_wake_us);
+            wake_ns = 0;
+        }
+    }
+
+    if (is_moving)
+    {
+        stats.motion_events++;
+        motion_ns = now;
+    }
+    else
+    {
+        stats.stationary_events++;
+        // motion nobody waited for is over: the next wait is for new motion
+        k_sem_reset(&motion_sem);
+    }
+
+    atomic_set(&moving, is_moving);
+    int ret = motion_wake_arm(is_moving);
+    k_mutex_unlock(&lock);
+
+    if (ret < 0)
+    {
+        LOG_ERR("Failed to re-arm the IMU: %d", ret);
+    }
+
+    LOG_DBG("%s", is_moving ? "Moving" : "Still");
+    if (is_moving)
+    {
+        k_sem_give(&motion_sem);
+    }
+}
+
+int motion_wake_start(void)
+{
+    if (!device_is_ready(imu))
+    {
+        return -ENODEV;
+    }
+
+    // Nothing is known yet, so both are armed until the first event
+    k_mutex_lock(&lock, K_FOREVER);
+    atomic_set(&moving, false);
+    k_sem_reset(&motion_sem);
+    int ret = sensor_trigger_set(imu, &motion_trigger, motion_wake_handler);
+    if (ret == 0)
+    {
+        ret = sensor_trigger_set(imu, &stationary_trigger, motion_wake_handler);
+    }
+    k_mutex_unlock(&lock);
+
+    return ret;
+}
+
+int motion_wake_stop(void)
+{
+    k_mutex_lock(&lock, K_FOREVER);
+    int ret = sensor_trigger_set(imu, &motion_trigger, NULL);
+    if (ret == 0)
+    {
+        ret = sensor_trigger_set(imu, &stationary_trigger, NULL);
+    }
+    k_mutex_unlock(&lock);
+
+    return ret;
+}
+
+int motion_wake_wait(k_timeout_t timeout)
+{
+    int ret = k_sem_take(&motion_sem, timeout);
+    if (ret < 0)
+    {
+        return ret;
+    }
+
+    k_mutex_lock(&lock, K_FOREVER);
+    stats.last_dispatch_us = (now_ns() - motion_ns) / NSEC_PER_USEC;
+    k_mutex_unlock(&lock);
+
+    return 0;
+}
+
+bool motion_wake_is_moving(void)
+{
+    return atomic_get(&moving);
+}
+
+void motion_wake_poweroff(void)
+{
+    // only motion may wake the watch, not it lying still
+    k_mutex_lock(&lock, K_FOREVER);
+    (void)sensor_trigger_set(imu, &stationary_trigger, NULL);
+    int ret = sensor_trigger_set(imu, &motion_trigger, motion_wake_handler);
+    k_mutex_unlock(&lock);
+    if (ret < 0)
+    {
+        LOG_ERR("Failed to arm the IMU (%d), powering off anyway", ret);
+    }
+
+    // a pending event would wake the watch straight back up: let the
+    // driver clear it first
+    for (int i = 0; i < INT1_CLEAR_TIMEOUT_MS && gpio_pin_get_dt(&int1) > 0; i++)
+    {
+        k_msleep(1);
+    }
+
+    // along with the other libraries' pins, such as the RTC alarm
+    ext1_wake_enable();
+
+    LOG_INF("Powering off until motion");
+    sys_poweroff();
+}
+
+bool motion_wake_from_poweroff(void)
+{
+    return from_poweroff;
+}
+
+void motion_wake_stats_get(struct motion_wake_stats *out)
+{
+    k_mutex_lock(&lock, K_FOREVER);
+    K_SPINLOCK(&wake_lock)
+    {
+        *out = stats;
+    }
+    k_mutex_unlock(&lock);
+}
+
+#ifdef CONFIG_T_WATCH_S3_MOTION_WAKE_LIGHT_SLEEP
+// INT1 is a level wakeup while the SoC light sleeps. That setting replaces
+// the pin's regular interrupt, so it only holds for the duration of the
+// sleep, and the driver takes the pin back afterwards.
+static void motion_wake_state_entry(enum pm_state state)
+{
+    if (state != PM_STATE_STANDBY)
+    {
+        return;
+    }
+
+    const bool active_low = int1.dt_flags & GPIO_ACTIVE_LOW;
+    gpio_wakeup_enable(int1.pin, active_low ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+}
+
+static void motion_wake_state_exit(enum pm_state state)
+{
+    if (state != PM_STATE_STANDBY)
+    {
+        return;
+    }
+
+    const uint64_t now = now_ns();
+    gpio_wakeup_disable(int1.pin);
+
+    if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO && gpio_pin_get_dt(&int1) > 0)
+    {
+        // the handler runs later, from the driver's work item
+        K_SPINLOCK(&wake_lock)
+        {
+            wake_ns = now;
+            stats.sleep_wakes++;
+        }
+    }
+
+    bma423_int1_resync(imu);
+}
+
+static struct pm_notifier motion_wake_notifier = {
+    .state_entry = motion_wake_state_entry,
+    .state_exit = motion_wake_state_exit,
+};
+#endif
+
+static int motion_wake_init(void)
+{
+    int ret = ext1_wake_add(&int1);
+    if (ret < 0)
+    {
+        LOG_WRN("Motion cannot wake from deep sleep (%d)", ret);
+    }
+
+    // EXT1 is shared, so a wake by another library's pin is not ours
+    from_poweroff = ext1_wake_from(&int1);
+    if (from_poweroff)
+    {
+        LOG_INF("Woken up by motion, %u ms after reset", k_uptime_get_32());
+    }
+
+#ifdef CONFIG_T_WATCH_S3_MOTION_WAKE_LIGHT_SLEEP
+    pm_notifier_register(&motion_wake_notifier);
+#endif
+
+    return 0;
+}
+
+SYS_INIT(motion_wake_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
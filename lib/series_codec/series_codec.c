@@ -0,0 +1,175 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <t_watch_s3/series_codec.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+
+#define COUNT_OFFSET 1
+
+static size_t put_varint(uint8_t *out, uint64_t value)
+{
+    size_t len = 0;
+    while (value >= 0x80)
+    {
+        out[len++] = (value & 0x7f) | 0x80;
+        value >>= 7;
+    }
+    out[len++] = value;
+    return len;
+}
+
+// Returns the bytes read, or 0 if the varint runs past end or max_bytes
+static size_t get_varint(const uint8_t *in, size_t avail, size_t max_bytes, uint64_t *value)
+{
+    uint64_t result = 0;
+    for (size_t i = 0; i < MIN(avail, max_bytes); i++)
+    {
+        result |= (uint64_t)(in[i] & 0x7f) << (7 * i);
+        if ((in[i] & 0x80) == 0)
+        {
+            *value = result;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+// Differences are taken modulo 2^32, so any two values round trip
+static uint32_t zigzag(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t unzigzag(uint32_t value)
+{
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+int series_encoder_start(struct series_encoder *enc, uint8_t *buf, size_t size, uint8_t channels,
+                         uint64_t timestamp_ms, uint32_t period_ms)
+{
+    if (channels == 0 || channels > SERIES_CODEC_MAX_CHANNELS)
+    {
+        return -EINVAL;
+    }
+    if (size < SERIES_CODEC_HEADER_MAX)
+    {
+        return -ENOSPC;
+    }
+
+    *enc = (struct series_encoder){
+        .buf = buf,
+        .size = size,
+        .channels = channels,
+    };
+    buf[0] = (SERIES_CODEC_VERSION << 4) | channels;
+    sys_put_le16(0, &buf[COUNT_OFFSET]);
+    enc->len = COUNT_OFFSET + sizeof(uint16_t);
+    enc->len += put_varint(&buf[enc->len], timestamp_ms);
+    enc->len += put_varint(&buf[enc->len], period_ms);
+    return 0;
+}
+
+int series_encoder_add(struct series_encoder *enc, const int32_t *sample)
+{
+    uint8_t coded[SERIES_CODEC_SAMPLE_MAX(SERIES_CODEC_MAX_CHANNELS)];
+    size_t len = 0;
+
+    if (enc->count == UINT16_MAX)
+    {
+        return -ENOSPC;
+    }
+
+    for (uint8_t ch = 0; ch < enc->channels; ch++)
+    {
+        len += put_varint(&coded[len], zigzag((uint32_t)sample[ch] - (uint32_t)enc->prev[ch]));
+    }
+    if (enc->len + len > enc->size)
+    {
+        return -ENOSPC;
+    }
+
+    memcpy(&enc->buf[enc->len], coded, len);
+    memcpy(enc->prev, sample, enc->channels * sizeof(*sample));
+    enc->len += len;
+    enc->count++;
+    return 0;
+}
+
+size_t series_encoder_finish(struct series_encoder *enc)
+{
+    sys_put_le16(enc->count, &enc->buf[COUNT_OFFSET]);
+    return enc->len;
+}
+
+int series_decoder_start(struct series_decoder *dec, const uint8_t *buf, size_t len)
+{
+    if (len < COUNT_OFFSET + sizeof(uint16_t))
+    {
+        return -EBADMSG;
+    }
+    if ((buf[0] >> 4) != SERIES_CODEC_VERSION)
+    {
+        return -ENOTSUP;
+    }
+
+    *dec = (struct series_decoder){
+        .buf = buf,
+        .len = len,
+        .channels = buf[0] & 0x0f,
+        .count = sys_get_le16(&buf[COUNT_OFFSET]),
+        .pos = COUNT_OFFSET + sizeof(uint16_t),
+    };
+    if (dec->channels == 0 || dec->channels > SERIES_CODEC_MAX_CHANNELS)
+    {
+        return -EBADMSG;
+    }
+
+    uint64_t period;
+    size_t n = get_varint(&buf[dec->pos], len - dec->pos, 10, &dec->timestamp_ms);
+    dec->pos += n;
+    const size_t m = n ? get_varint(&buf[dec->pos], len - dec->pos, 5, &period) : 0;
+    if (m == 0 || period > UINT32_MAX)
+    {
+        return -EBADMSG;
+    }
+    dec->pos += m;
+    dec->period_ms = period;
+    return 0;
+}
+
+int series_decoder_next(struct series_decoder *dec, int32_t *sample, uint64_t *timestamp_ms)
+{
+    if (dec->index == dec->count)
+    {
+        return -ENODATA;
+    }
+
+    size_t pos = dec->pos;
+    for (uint8_t ch = 0; ch < dec->channels; ch++)
+    {
+        uint64_t value;
+        const size_t n = get_varint(&dec->buf[pos], dec->len - pos, 5, &value);
+        if (n == 0 || value > UINT32_MAX)
+        {
+            return -EBADMSG;
+        }
+        pos += n;
+        sample[ch] = (uint32_t)dec->prev[ch] + (uint32_t)unzigzag(value);
+    }
+
+    memcpy(dec->prev, sample, dec->channels * sizeof(*sample));
+    if (timestamp_ms != NULL)
+    {
+        *timestamp_ms = dec->timestamp_ms + (uint64_t)dec->index * dec->period_ms;
+    }
+    dec->pos = pos;
+    dec->index++;
+    return 0;
+}
@@ -0,0 +1,485 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <t_watch_s3/telemetry_log.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/drivers/flash.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/crc.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(telemetry_log, CONFIG_TELEMETRY_LOG_LOG_LEVEL);
+
+// The log is a ring of the partition's erase sectors, each starting with a
+// sector header and then filled with batches written one after the other:
+//
+//   | sector header | batch header | record | record | ... | batch header | ...
+//
+// Sectors are used in turn, so every one of them is erased as often as the
+// others, and the oldest one is erased when the newest is full. At boot,
+// only the sector headers and the batch headers of the newest sector are
+// read to find where writing left off.
+
+#define SECTOR_MAGIC 0x474f4c54 // "TLOG"
+#define BATCH_MAGIC  0xb7c4
+
+#define BATCH_SIZE     CONFIG_T_WATCH_S3_TELEMETRY_LOG_BATCH_SIZE
+#define FLUSH_INTERVAL CONFIG_T_WATCH_S3_TELEMETRY_LOG_FLUSH_INTERVAL_S
+
+struct sector_header
+{
+    uint32_t magic;
+    // one more than the sector used before it
+    uint32_t seq;
+    uint32_t erase_count;
+    uint32_t crc;
+};
+
+struct batch_header
+{
+    uint16_t magic;
+    // bytes of records that follow
+    uint16_t len;
+    uint32_t crc;
+};
+
+struct record_header
+{
+    uint8_t type;
+    uint8_t len;
+};
+
+BUILD_ASSERT(sizeof(struct sector_header) == 16 && sizeof(struct batch_header) == 8);
+BUILD_ASSERT(TELEMETRY_LOG_MAX_RECORD ==
+             MIN(BATCH_SIZE - sizeof(struct batch_header) - sizeof(struct record_header), UINT8_MAX));
+
+static K_MUTEX_DEFINE(lock);
+static const struct flash_area *area;
+static bool mounted;
+static size_t sector_size;
+static uint32_t sector_count;
+static size_t write_block;
+
+// the newest sector, and where the next batch goes in it. Before the first
+// one, cur_off is sector_size so the first flush moves on to sector 0.
+static uint32_t cur_sector;
+static uint32_t cur_seq;
+static size_t cur_off;
+
+// the batch being filled, header first
+static uint8_t batch[BATCH_SIZE] __aligned(4);
+static size_t batch_len;
+// batches read back by telemetry_log_walk()
+static uint8_t read_buf[BATCH_SIZE] __aligned(4);
+
+static struct telemetry_log_stats stats;
+
+static void telemetry_log_flush_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(flush_work, telemetry_log_flush_handler);
+
+static off_t sector_offset(uint32_t sector)
+{
+    return (off_t)sector * sector_size;
+}
+
+static size_t batch_total(size_t len)
+{
+    return ROUND_UP(sizeof(struct batch_header) + len, write_block);
+}
+
+static bool read_sector_header(uint32_t sector, struct sector_header *header)
+{
+    if (flash_area_read(area, sector_offset(sector), header, sizeof(*header)) < 0)
+    {
+        return false;
+    }
+    return header->magic == SECTOR_MAGIC &&
+           header->crc == crc32_ieee((const uint8_t *)header, offsetof(struct sector_header, crc));
+}
+
+// Called with lock held
+static int telemetry_log_rotate(void)
+{
+    const uint32_t next = (cur_sector + 1) % sector_count;
+
+    struct sector_header header;
+    const bool in_use = read_sector_header(next, &header);
+    const uint32_t erase_count = in_use ? header.erase_count + 1 : 1;
+
+    int ret = flash_area_erase(area, sector_offset(next), sector_size);
+    if (ret < 0)
+    {
+        return ret;
+    }
+    stats.sectors_erased++;
+    stats.sectors_dropped += in_use;
+
+    header = (struct sector_header){
+        .magic = SECTOR_MAGIC,
+        .seq = cur_seq + 1,
+        .erase_count = erase_count,
+    };
+    header.crc = crc32_ieee((const uint8_t *)&header, offsetof(struct sector_header, crc));
+    ret = flash_area_write(area, sector_offset(next), &header, sizeof(header));
+    if (ret < 0)
+    {
+        return ret;
+    }
+    stats.flash_bytes_written += sizeof(header);
+
+    cur_sector = next;
+    cur_seq++;
+    cur_off = ROUND_UP(sizeof(header), write_block);
+    return 0;
+}
+
+// Called with lock held
+static int telemetry_log_flush_locked(void)
+{
+    if (!mounted)
+    {
+        return -ENODEV;
+    }
+    if (batch_len == 0)
+    {
+        return 0;
+    }
+
+    const size_t total = batch_total(batch_len);
+    if (cur_off + total > sector_size)
+    {
+        int ret = telemetry_log_rotate();
+        if (ret < 0)
+        {
+            LOG_ERR("Failed to move on to the next sector: %d", ret);
+            return ret;
+        }
+    }
+
+    struct batch_header *header = (struct batch_header *)batch;
+    *header = (struct batch_header){
+        .magic = BATCH_MAGIC,
+        .len = batch_len,
+        .crc = crc32_ieee(&batch[sizeof(*header)], batch_len),
+    };
+    memset(&batch[sizeof(*header) + batch_len], 0xff, total - sizeof(*header) - batch_len);
+
+    int ret = flash_area_write(area, sector_offset(cur_sector) + cur_off, batch, total);
+    if (ret < 0)
+    {
+        // part of it may have made it: keep the batch for the next sector
+        LOG_ERR("Failed to write a batch: %d", ret);
+        cur_off = sector_size;
+        return ret;
+    }
+
+    cur_off += total;
+    batch_len = 0;
+    stats.batches++;
+    stats.flash_bytes_written += total;
+    return 0;
+}
+
+int telemetry_log_append(uint8_t type, const void *data, size_t len)
+{
+    if (len > TELEMETRY_LOG_MAX_RECORD)
+    {
+        return -EINVAL;
+    }
+
+    const size_t size = sizeof(struct record_header) + len;
+    int ret = 0;
+
+    k_mutex_lock(&lock, K_FOREVER);
+    if (sizeof(struct batch_header) + batch_len + size > BATCH_SIZE)
+    {
+        ret = telemetry_log_flush_locked();
+    }
+    else if (!mounted)
+    {
+        ret = -ENODEV;
+    }
+
+    if (ret == 0)
+    {
+        if (batch_len == 0 && FLUSH_INTERVAL > 0)
+        {
+            k_work_reschedule(&flush_work, K_SECONDS(FLUSH_INTERVAL));
+        }
+
+        uint8_t *pos = &batch[sizeof(struct batch_header) + batch_len];
+        *(struct record_header *)pos = (struct record_header){.type = type, .len = len};
+        memcpy(pos + sizeof(struct record_header), data, len);
+        batch_len += size;
+        stats.records++;
+        stats.record_bytes += len;
+    }
+    k_mutex_unlock(&lock);
+
+    return ret;
+}
+
+int telemetry_log_flush(void)
+{
+    k_mutex_lock(&lock, K_FOREVER);
+    int ret = telemetry_log_flush_locked();
+    k_mutex_unlock(&lock);
+
+    return ret;
+}
+
+static void telemetry_log_flush_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+    (void)telemetry_log_flush();
+}
+
+// Called with lock held. Returns false if the callback stopped the walk.
+static bool telemetry_log_walk_sector(uint32_t sector, telemetry_log_walk_t cb, void *user_data)
+{
+    const size_t end = sector == cur_sector ? cur_off : sector_size;
+    size_t off = ROUND_UP(sizeof(struct sector_header), write_block);
+
+    while (off + sizeof(struct batch_header) <= end)
+    {
+        struct batch_header *header = (struct batch_header *)read_buf;
+        if (flash_area_read(area, sector_offset(sector) + off, header, sizeof(*header)) < 0 ||
+            header->magic != BATCH_MAGIC || header->len > BATCH_SIZE - sizeof(*header) ||
+            off + batch_total(header->len) > end)
+        {
+            // erased, or not a batch: the rest of the sector was never written
+            break;
+        }
+
+        const off_t records = sector_offset(sector) + off + sizeof(*header);
+        const size_t len = header->len;
+        const uint32_t crc = header->crc;
+        off += batch_total(len);
+        if (flash_area_read(area, records, read_buf, len) < 0 || crc32_ieee(read_buf, len) != crc)
+        {
+            stats.crc_errors++;
+            continue;
+        }
+
+        for (size_t pos = 0; pos + sizeof(struct record_header) <= len;)
+        {
+            const struct record_header *record = (const struct record_header *)&read_buf[pos];
+            pos += sizeof(*record);
+            if (pos + record->len > len)
+            {
+                break;
+            }
+            if (!cb(record->type, &read_buf[pos], record->len, user_data))
+            {
+                return false;
+            }
+            pos += record->len;
+        }
+    }
+
+    return true;
+}
+
+int telemetry_log_walk(telemetry_log_walk_t cb, void *user_data)
+{
+    int ret = 0;
+
+    k_mutex_lock(&lock, K_FOREVER);
+    if (!mounted)
+    {
+        ret = -ENODEV;
+    }
+
+    // from the sector after the newest, which is the oldest, round the ring
+    for (uint32_t i = 1; ret == 0 && i <= sector_count; i++)
+    {
+        const uint32_t sector = (cur_sector + i) % sector_count;
+        struct sector_header header;
+        if (!read_sector_header(sector, &header) || (cur_seq - header.seq) >= sector_count)
+        {
+            continue;
+        }
+        if (!telemetry_log_walk_sector(sector, cb, user_data))
+        {
+            break;
+        }
+    }
+    k_mutex_unlock(&lock);
+
+    return ret;
+}
+
+int telemetry_log_clear(void)
+{
+    int ret = 0;
+
+    k_mutex_lock(&lock, K_FOREVER);
+    (void)k_work_cancel_delayable(&flush_work);
+    batch_len = 0;
+    if (!mounted)
+    {
+        ret = -ENODEV;
+    }
+
+    for (uint32_t sector = 0; ret == 0 && sector < sector_count; sector++)
+    {
+        struct sector_header header;
+        if (read_sector_header(sector, &header))
+        {
+            ret = flash_area_erase(area, sector_offset(sector), sector_size);
+            stats.sectors_erased++;
+        }
+    }
+
+    // carry on round the ring from where it was, rather than wearing the
+    // first sectors more. Their erase counts start over.
+    cur_off = sector_size;
+    k_mutex_unlock(&lock);
+
+    return ret;
+}
+
+void telemetry_log_stats_get(struct telemetry_log_stats *out)
+{
+    k_mutex_lock(&lock, K_FOREVER);
+    *out = stats;
+    k_mutex_unlock(&lock);
+}
+
+void telemetry_log_stats_reset(void)
+{
+    k_mutex_lock(&lock, K_FOREVER);
+    // what the last telemetry_log_init() found stays
+    memset(&stats, 0, offsetof(struct telemetry_log_stats, recovery_reads));
+    k_mutex_unlock(&lock);
+}
+
+// Called with lock held. Walks the batch headers of the newest sector to
+// the first one not written yet.
+static void telemetry_log_recover_offset(void)
+{
+    size_t off = ROUND_UP(sizeof(struct sector_header), write_block);
+
+    while (off + sizeof(struct batch_header) <= sector_size)
+    {
+        struct batch_header header;
+        stats.recovery_reads++;
+        if (flash_area_read(area, sector_offset(cur_sector) + off, &header, sizeof(header)) < 0)
+        {
+            break;
+        }
+        if (header.magic == 0xffff && header.len == 0xffff && header.crc == 0xffffffff)
+        {
+            cur_off = off;
+            return;
+        }
+        if (header.magic != BATCH_MAGIC || header.len > BATCH_SIZE - sizeof(header) ||
+            off + batch_total(header.len) > sector_size)
+        {
+            // a write cut short: leave the rest of this sector alone
+            LOG_WRN("Sector %u is damaged at %zu", cur_sector, off);
+            break;
+        }
+        off += batch_total(header.len);
+    }
+
+    cur_off = sector_size;
+}
+
+int telemetry_log_init(void)
+{
+    const uint32_t start = k_cycle_get_32();
+
+    k_mutex_lock(&lock, K_FOREVER);
+    (void)k_work_cancel_delayable(&flush_work);
+    mounted = false;
+    batch_len = 0;
+
+    int ret = area ? 0 : flash_area_open(FIXED_PARTITION_ID(storage_partition), &area);
+    if (ret < 0)
+    {
+        LOG_ERR("Failed to open storage_partition: %d", ret);
+        goto out;
+    }
+
+    const struct device *flash = flash_area_get_device(area);
+    struct flash_pages_info info;
+    ret = flash_get_page_info_by_offs(flash, area->fa_off, &info);
+    if (ret < 0)
+    {
+        goto out;
+    }
+    sector_size = info.size;
+    sector_count = area->fa_size / sector_size;
+    write_block = flash_get_write_block_size(flash);
+    if (sector_count < 2 || write_block > sizeof(struct batch_header) || BATCH_SIZE % write_block != 0)
+    {
+        LOG_ERR("storage_partition is unsuitable: %u sectors of %zu, writes of %zu", sector_count, sector_size,
+                write_block);
+        ret = -ENOTSUP;
+        goto out;
+    }
+    if (BATCH_SIZE + ROUND_UP(sizeof(struct sector_header), write_block) > sector_size)
+    {
+        LOG_ERR("A batch of %d does not fit in a sector of %zu", BATCH_SIZE, sector_size);
+        ret = -EINVAL;
+        goto out;
+    }
+
+    // the newest sector is the one with the highest sequence number
+    bool found = false;
+    stats.recovery_reads = 0;
+    stats.min_erase_count = UINT32_MAX;
+    stats.max_erase_count = 0;
+    for (uint32_t sector = 0; sector < sector_count; sector++)
+    {
+        struct sector_header header;
+        stats.recovery_reads++;
+        if (!read_sector_header(sector, &header))
+        {
+            stats.min_erase_count = 0;
+            continue;
+        }
+        stats.min_erase_count = MIN(stats.min_erase_count, header.erase_count);
+        stats.max_erase_count = MAX(stats.max_erase_count, header.erase_count);
+        if (!found || (int32_t)(header.seq - cur_seq) > 0)
+        {
+            found = true;
+            cur_sector = sector;
+            cur_seq = header.seq;
+        }
+    }
+
+    if (found)
+    {
+        telemetry_log_recover_offset();
+    }
+    else
+    {
+        cur_sector = sector_count - 1;
+        cur_seq = 0;
+        cur_off = sector_size;
+    }
+    mounted = true;
+    stats.recovery_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+    LOG_INF("%u sectors of %zu, newest %u at %zu, %u header reads in %u us", sector_count, sector_size, cur_sector,
+            cur_off, stats.recovery_reads, stats.recovery_us);
+
+out:
+    k_mutex_unlock(&lock);
+    return ret;
+}
+
+static int telemetry_log_sys_init(void)
+{
+    (void)telemetry_log_init();
+    return 0;
+}
+
+SYS_INIT(telemetry_log_sys_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -0,0 +1,672 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <t_watch_s3/time_service.h>
+#include <t_watch_s3/ext1_wake.h>
+
+#include <errno.h>
+#include <time.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/rtc.h>
+#include <zephyr/sys/poweroff.h>
+#include <zephyr/sys/timeutil.h>
+#include <zephyr/sys/util.h>
+
+#ifdef CONFIG_POSIX_TIMERS
+#include <zephyr/posix/time.h>
+#endif
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(time_service, CONFIG_TIME_SERVICE_LOG_LEVEL);
+
+#define RTC_NODE DT_ALIAS(rtc)
+
+BUILD_ASSERT(DT_NODE_HAS_COMPAT(RTC_NODE, nxp_pcf8563), "The time service expects a PCF8563");
+BUILD_ASSERT(DT_NODE_HAS_PROP(RTC_NODE, int1_gpios), "Alarm wakeups need the RTC's INT");
+
+#define PCF8563_REG_SECONDS 0x02
+#define PCF8563_SECONDS_VL  BIT(7)
+
+// The PCF8563 alarm matches on the day of the month at most
+#define ALARM_MAX_AHEAD_S (28 * 24 * 60 * 60)
+
+// Looking for the seconds edge: the seconds register is polled every
+// COARSE_POLL_MS until it changes, then back to back from FINE_GUARD_US
+// before to FINE_GUARD_US after where the next edge is due.
+#define COARSE_POLL_MS 10
+#define FINE_GUARD_US  2000
+#define EDGE_ATTEMPTS  3
+
+// Drift is estimated from edges at least DRIFT_MIN_S apart, and anything
+// past DRIFT_MAX_PPB (a crystal way off, or the RTC set behind our back)
+// is ignored
+#define DRIFT_MIN_S   60
+#define DRIFT_MAX_PPB 200000
+
+#define SLEW_PPB (CONFIG_T_WATCH_S3_TIME_SERVICE_SLEW_PPM * 1000)
+
+static const struct device *const rtc = DEVICE_DT_GET(RTC_NODE);
+static const struct i2c_dt_spec rtc_i2c = I2C_DT_SPEC_GET(RTC_NODE);
+static const struct gpio_dt_spec rtc_int = GPIO_DT_SPEC_GET(RTC_NODE, int1_gpios);
+
+// Wall time is a line through anchor_us at uptime anchor_ticks, running
+// drift_ppb faster than uptime. For slew_ticks after the anchor it runs
+// slew_ppb faster still, to work off an error without a step, and reaches
+// slew_end_us there. Read from any context, hence the spinlock.
+static struct k_spinlock lock;
+static int64_t anchor_us;
+static int64_t anchor_ticks;
+static int64_t slew_ticks;
+static int64_t slew_end_us;
+static int32_t drift_ppb;
+static int32_t slew_ppb;
+// bumped by time_service_set(), so a sync can tell the RTC moved under it
+static uint32_t epoch;
+static struct time_service_stats stats;
+
+// taken around every RTC access
+static K_MUTEX_DEFINE(rtc_lock);
+static bool is_set;
+static bool from_alarm;
+
+// The seconds edge search, run from the system workqueue a poll at a time
+enum sync_phase
+{
+    SYNC_IDLE,
+    SYNC_COARSE,
+    SYNC_FINE,
+};
+
+static struct
+{
+    enum sync_phase phase;
+    uint32_t epoch;
+    int attempts;
+    // the RTC's time and seconds register since the last change seen
+    int64_t rtc_s;
+    uint8_t seconds;
+    // when the poll that last saw the old second started, if any
+    int64_t last_poll;
+    bool have_last_poll;
+    int64_t give_up;
+    int64_t fine_from;
+    int64_t fine_until;
+    // the last edge found, for the drift estimate
+    int64_t edge_ticks;
+    int64_t edge_s;
+    uint32_t edge_epoch;
+    bool have_edge;
+} sync;
+
+static atomic_t sync_busy;
+static K_MUTEX_DEFINE(sync_lock);
+static K_CONDVAR_DEFINE(sync_cond);
+static uint32_t sync_gen;
+static int sync_result;
+
+static void time_service_sync_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(sync_work, time_service_sync_handler);
+
+static int64_t time_service_scale(int64_t ticks, int32_t ppb)
+{
+    if (ticks < 0)
+    {
+        return -time_service_scale(-ticks, ppb);
+    }
+    const int64_t us = k_ticks_to_us_floor64(ticks);
+    return us + us * ppb / NSEC_PER_SEC;
+}
+
+// Called with lock held
+static int64_t time_service_at_us(int64_t ticks)
+{
+    const int64_t elapsed = ticks - anchor_ticks;
+    if (elapsed < slew_ticks)
+    {
+        return anchor_us + time_service_scale(elapsed, drift_ppb + slew_ppb);
+    }
+    return slew_end_us + time_service_scale(elapsed - slew_ticks, drift_ppb);
+}
+
+// Called with lock held. error_us is how far ahead of the RTC the line
+// was, worked off by a slew.
+static void time_service_anchor_locked(int64_t unix_us, int64_t ticks, int64_t error_us)
+{
+    anchor_us = unix_us;
+    anchor_ticks = ticks;
+    slew_ppb = error_us > 0 ? -SLEW_PPB : SLEW_PPB;
+    slew_ticks = k_us_to_ticks_ceil64(llabs(error_us) * NSEC_PER_SEC / SLEW_PPB);
+    slew_end_us = anchor_us + time_service_scale(slew_ticks, drift_ppb + slew_ppb);
+}
+
+// Keep time() and clock_gettime(CLOCK_REALTIME) in step, after wall time
+// was stepped. They don't slew, so small corrections are left out.
+static void time_service_update_posix(void)
+{
+#ifdef CONFIG_POSIX_TIMERS
+    const int64_t now = time_service_now_ms();
+    const struct timespec ts = {
+        .tv_sec = now / MSEC_PER_SEC,
+        .tv_nsec = (now % MSEC_PER_SEC) * NSEC_PER_MSEC,
+    };
+    (void)clock_settime(CLOCK_REALTIME, &ts);
+#endif
+}
+
+static void time_service_step(int64_t unix_us, int64_t ticks)
+{
+    K_SPINLOCK(&lock)
+    {
+        time_service_anchor_locked(unix_us, ticks, 0);
+    }
+    time_service_update_posix();
+}
+
+static void time_service_to_rtc_time(int64_t unix_s, struct rtc_time *time)
+{
+    const time_t t = unix_s;
+    struct tm tm;
+    gmtime_r(&t, &tm);
+    *time = (struct rtc_time){
+        .tm_sec = tm.tm_sec,
+        .tm_min = tm.tm_min,
+        .tm_hour = tm.tm_hour,
+        .tm_mday = tm.tm_mday,
+        .tm_mon = tm.tm_mon,
+        .tm_year = tm.tm_year,
+        .tm_wday = tm.tm_wday,
+        .tm_yday = tm.tm_yday,
+        .tm_isdst = -1,
+    };
+}
+
+// The RTC's time, and the uptime the read started at
+static int time_service_read_rtc(int64_t *unix_s, int64_t *ticks)
+{
+    struct rtc_time time;
+
+    k_mutex_lock(&rtc_lock, K_FOREVER);
+    *ticks = k_uptime_ticks();
+    int ret = rtc_get_time(rtc, &time);
+    k_mutex_unlock(&rtc_lock);
+
+    K_SPINLOCK(&lock)
+    {
+        stats.rtc_reads++;
+    }
+    if (ret < 0)
+    {
+        return ret;
+    }
+
+    *unix_s = timeutil_timegm64(rtc_time_to_tm(&time));
+    return 0;
+}
+
+// Just the seconds register, which is as short as an I2C read gets
+static int time_service_read_seconds(uint8_t *seconds, int64_t *before, int64_t *after)
+{
+    uint8_t raw;
+
+    k_mutex_lock(&rtc_lock, K_FOREVER);
+    *before = k_uptime_ticks();
+    int ret = i2c_reg_read_byte_dt(&rtc_i2c, PCF8563_REG_SECONDS, &raw);
+    *after = k_uptime_ticks();
+    k_mutex_unlock(&rtc_lock);
+
+    K_SPINLOCK(&lock)
+    {
+        stats.edge_polls++;
+    }
+    if (ret < 0)
+    {
+        return ret;
+    }
+    if (raw & PCF8563_SECONDS_VL)
+    {
+        return -ENODATA;
+    }
+
+    *seconds = bcd2bin(raw & ~PCF8563_SECONDS_VL);
+    return 0;
+}
+
+int64_t time_service_now_ms(void)
+{
+    int64_t us;
+    K_SPINLOCK(&lock)
+    {
+        us = time_service_at_us(k_uptime_ticks());
+    }
+    return us / USEC_PER_MSEC;
+}
+
+int64_t time_service_ms_at(int64_t uptime_ticks)
+{
+    int64_t us;
+    K_SPINLOCK(&lock)
+    {
+        us = time_service_at_us(uptime_ticks);
+    }
+    return us / USEC_PER_MSEC;
+}
+
+int64_t time_service_now(void)
+{
+    return time_service_now_ms() / MSEC_PER_SEC;
+}
+
+int time_service_get_rtc_time(struct rtc_time *time)
+{
+    time_service_to_rtc_time(time_service_now(), time);
+    return 0;
+}
+
+bool time_service_is_set(void)
+{
+    return is_set;
+}
+
+static void time_service_sync_start(void)
+{
+    if (atomic_cas(&sync_busy, 0, 1))
+    {
+        k_work_reschedule(&sync_work, K_NO_WAIT);
+    }
+}
+
+int time_service_set(int64_t unix_s)
+{
+    if (unix_s < 0)
+    {
+        return -EINVAL;
+    }
+
+    struct rtc_time time;
+    time_service_to_rtc_time(unix_s, &time);
+
+    k_mutex_lock(&rtc_lock, K_FOREVER);
+    int ret = rtc_set_time(rtc, &time);
+    const int64_t ticks = k_uptime_ticks();
+    k_mutex_unlock(&rtc_lock);
+    if (ret < 0)
+    {
+        return ret;
+    }
+
+    // Where in the second the RTC's divider is now isn't known. Counting
+    // from the start of it means wall time can only be behind, and the
+    // sync after this moves it forward to the edge.
+    K_SPINLOCK(&lock)
+    {
+        epoch++;
+    }
+    time_service_step(unix_s * USEC_PER_SEC, ticks);
+    is_set = true;
+    time_service_sync_start();
+
+    return 0;
+}
+
+// Line wall time up with an edge found at edge_ticks, give or take
+// window_us / 2
+static void time_service_apply_edge(int64_t edge_ticks, int64_t edge_s, uint32_t window_us)
+{
+    bool stepped = false;
+    int64_t error_us;
+
+    K_SPINLOCK(&lock)
+    {
+        const int64_t ticks = k_uptime_ticks();
+        const int64_t now_us = time_service_at_us(ticks);
+        error_us = time_service_at_us(edge_ticks) - edge_s * USEC_PER_SEC;
+
+        if (sync.have_edge && sync.edge_epoch == sync.epoch && edge_s - sync.edge_s >= DRIFT_MIN_S)
+        {
+            const int64_t uptime_us = k_ticks_to_us_floor64(edge_ticks - sync.edge_ticks);
+            const int64_t rtc_us = (edge_s - sync.edge_s) * USEC_PER_SEC;
+            const int64_t measured_ppb = (rtc_us - uptime_us) * NSEC_PER_SEC / uptime_us;
+            if (llabs(measured_ppb) <= DRIFT_MAX_PPB)
+            {
+                // the first estimate is taken as is, later ones averaged in
+                drift_ppb = stats.drift_estimates == 0 ? measured_ppb : drift_ppb + (measured_ppb - drift_ppb) / 4;
+                stats.drift_estimates++;
+            }
+        }
+        sync.edge_ticks = edge_ticks;
+        sync.edge_s = edge_s;
+        sync.edge_epoch = sync.epoch;
+        sync.have_edge = true;
+
+        // Carry on from where wall time is now, so it never goes back, and
+        // slew off the error. Only an error too big to slew is stepped,
+        // which is always forward unless the RTC was set behind our back.
+        if (llabs(error_us) <= CONFIG_T_WATCH_S3_TIME_SERVICE_MAX_SLEW_MS * USEC_PER_MSEC)
+        {
+            time_service_anchor_locked(now_us, ticks, error_us);
+            stats.slews += error_us != 0;
+        }
+        else
+        {
+            // edge_s at the edge, so the line through now simply moves
+            time_service_anchor_locked(now_us - error_us, ticks, 0);
+            stepped = true;
+            stats.steps++;
+        }
+
+        stats.syncs++;
+        stats.last_error_us = CLAMP(error_us, INT32_MIN, INT32_MAX);
+        stats.edge_window_us = window_us;
+        stats.drift_ppb = drift_ppb;
+    }
+
+    if (stepped)
+    {
+        if (error_us > 0)
+        {
+            LOG_WRN("Wall time was %lld ms ahead of the RTC, stepped back", error_us / USEC_PER_MSEC);
+        }
+        time_service_update_posix();
+    }
+    LOG_DBG("Edge found to %u us, wall time was %lld us off, drift %d ppb", window_us, error_us, stats.drift_ppb);
+}
+
+static void time_service_sync_done(int ret)
+{
+    sync.phase = SYNC_IDLE;
+    atomic_set(&sync_busy, 0);
+
+    k_mutex_lock(&sync_lock, K_FOREVER);
+    sync_result = ret;
+    sync_gen++;
+    k_condvar_broadcast(&sync_cond);
+    k_mutex_unlock(&sync_lock);
+
+    if (ret < 0)
+    {
+        LOG_ERR("Failed to sync with the RTC: %d", ret);
+    }
+    k_work_schedule(&sync_work, K_SECONDS(CONFIG_T_WATCH_S3_TIME_SERVICE_SYNC_INTERVAL_S));
+}
+
+static void time_service_sync_reschedule(int64_t at)
+{
+    k_work_reschedule(&sync_work, K_TICKS(MAX(at - k_uptime_ticks(), 0)));
+}
+
+static void time_service_sync_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    uint8_t seconds;
+    int64_t before;
+    int64_t after;
+    int ret;
+
+    switch (sync.phase)
+    {
+    case SYNC_IDLE:
+        atomic_set(&sync_busy, 1);
+        K_SPINLOCK(&lock)
+        {
+            sync.epoch = epoch;
+        }
+        sync.attempts = 0;
+
+        ret = time_service_read_rtc(&sync.rtc_s, &before);
+        if (ret < 0)
+        {
+            time_service_sync_done(ret);
+            return;
+        }
+        sync.seconds = sync.rtc_s % 60;
+        sync.last_poll = before;
+        sync.have_last_poll = true;
+        sync.give_up = before + k_ms_to_ticks_ceil64(2 * MSEC_PER_SEC);
+        sync.phase = SYNC_COARSE;
+        k_work_reschedule(&sync_work, K_MSEC(COARSE_POLL_MS));
+        return;
+
+    case SYNC_COARSE:
+        ret = time_service_read_seconds(&seconds, &before, &after);
+        if (ret < 0)
+        {
+            time_service_sync_done(ret);
+            return;
+        }
+        if (seconds == sync.seconds)
+        {
+            if (after > sync.give_up)
+            {
+                // the RTC is not counting
+                time_service_sync_done(-EIO);
+                return;
+            }
+            sync.last_poll = before;
+            k_work_reschedule(&sync_work, K_MSEC(COARSE_POLL_MS));
+            return;
+        }
+
+        // The edge was somewhere in the last COARSE_POLL_MS, so the next
+        // one is a second after that. Look for it there, closely.
+        sync.rtc_s += (seconds + 60 - sync.seconds) % 60;
+        sync.seconds = seconds;
+        sync.fine_from = sync.last_poll + k_ms_to_ticks_floor64(MSEC_PER_SEC) - k_us_to_ticks_ceil64(FINE_GUARD_US);
+        sync.fine_until = after + k_ms_to_ticks_ceil64(MSEC_PER_SEC) + k_us_to_ticks_ceil64(FINE_GUARD_US);
+        sync.have_last_poll = false;
+        sync.phase = SYNC_FINE;
+        time_service_sync_reschedule(sync.fine_from);
+        return;
+
+    case SYNC_FINE:
+        if (k_uptime_ticks() < sync.fine_from)
+        {
+            // kicked early by time_service_sync()
+            time_service_sync_reschedule(sync.fine_from);
+            return;
+        }
+
+        // back to back, so the edge is pinned down to about two reads
+        do
+        {
+            ret = time_service_read_seconds(&seconds, &before, &after);
+            if (ret < 0)
+            {
+                time_service_sync_done(ret);
+                return;
+            }
+            if (seconds != sync.seconds)
+            {
+                break;
+            }
+            sync.last_poll = before;
+            sync.have_last_poll = true;
+        } while (after <= sync.fine_until);
+
+        if (seconds != sync.seconds && sync.have_last_poll)
+        {
+            bool moved;
+            K_SPINLOCK(&lock)
+            {
+                moved = sync.epoch != epoch;
+            }
+            if (!moved)
+            {
+                const int64_t rtc_s = sync.rtc_s + (seconds + 60 - sync.seconds) % 60;
+                const int64_t edge_ticks = sync.last_poll + (after - sync.last_poll) / 2;
+                time_service_apply_edge(edge_ticks, rtc_s, k_ticks_to_us_ceil32(after - sync.last_poll));
+                time_service_sync_done(0);
+                return;
+            }
+        }
+
+        // Started too late to see the old second (the workqueue was busy),
+        // missed the edge, or the RTC was set meanwhile: start over
+        K_SPINLOCK(&lock)
+        {
+            stats.edge_misses++;
+        }
+        if (++sync.attempts >= EDGE_ATTEMPTS)
+        {
+            time_service_sync_done(-EAGAIN);
+            return;
+        }
+        sync.phase = SYNC_IDLE;
+        k_work_reschedule(&sync_work, K_NO_WAIT);
+        return;
+    }
+}
+
+int time_service_sync(void)
+{
+    int ret = 0;
+
+    k_mutex_lock(&sync_lock, K_FOREVER);
+    const uint32_t gen = sync_gen;
+    time_service_sync_start();
+    while (sync_gen == gen && ret == 0)
+    {
+        ret = k_condvar_wait(&sync_cond, &sync_lock, K_SECONDS(EDGE_ATTEMPTS * 3));
+    }
+    ret = ret < 0 ? -ETIMEDOUT : sync_result;
+    k_mutex_unlock(&sync_lock);
+
+    return ret;
+}
+
+int time_service_alarm_set(int64_t unix_s)
+{
+    const int64_t now = time_service_now();
+    if (unix_s < now)
+    {
+        return -EINVAL;
+    }
+
+    // no alarm seconds: round up to the minute
+    const int64_t at = DIV_ROUND_UP(unix_s, 60) * 60;
+    if (at - now > ALARM_MAX_AHEAD_S)
+    {
+        return -ERANGE;
+    }
+
+    struct rtc_time time;
+    time_service_to_rtc_time(at, &time);
+    const uint16_t mask = RTC_ALARM_TIME_MASK_MINUTE | RTC_ALARM_TIME_MASK_HOUR | RTC_ALARM_TIME_MASK_MONTHDAY;
+
+    k_mutex_lock(&rtc_lock, K_FOREVER);
+    int ret = rtc_alarm_set_time(rtc, 0, mask, &time);
+    k_mutex_unlock(&rtc_lock);
+
+    return ret;
+}
+
+int time_service_alarm_cancel(void)
+{
+    k_mutex_lock(&rtc_lock, K_FOREVER);
+    int ret = rtc_alarm_set_time(rtc, 0, 0, NULL);
+    k_mutex_unlock(&rtc_lock);
+
+    return ret;
+}
+
+void time_service_poweroff(void)
+{
+    // a pending alarm would wake the watch straight back up
+    k_mutex_lock(&rtc_lock, K_FOREVER);
+    (void)rtc_alarm_is_pending(rtc, 0);
+    k_mutex_unlock(&rtc_lock);
+
+    // along with the other libraries' pins, such as motion wake's
+    ext1_wake_enable();
+
+    LOG_INF("Powering off until the RTC alarm");
+    sys_poweroff();
+}
+
+bool time_service_from_alarm(void)
+{
+    return from_alarm;
+}
+
+void time_service_stats_get(struct time_service_stats *out)
+{
+    K_SPINLOCK(&lock)
+    {
+        *out = stats;
+    }
+}
+
+static void time_service_alarm_cb(const struct device *dev, uint16_t id, void *user_data)
+{
+    ARG_UNUSED(dev);
+    ARG_UNUSED(id);
+    ARG_UNUSED(user_data);
+
+    K_SPINLOCK(&lock)
+    {
+        stats.alarms++;
+    }
+    LOG_INF("RTC alarm");
+}
+
+static int time_service_init(void)
+{
+    if (!device_is_ready(rtc))
+    {
+        LOG_ERR("RTC not ready");
+        return -ENODEV;
+    }
+
+    int ret = ext1_wake_add(&rtc_int);
+    if (ret < 0)
+    {
+        LOG_WRN("The RTC alarm cannot wake from deep sleep (%d)", ret);
+    }
+
+    from_alarm = ext1_wake_from(&rtc_int);
+    if (from_alarm)
+    {
+        // clear it, or INT stays low
+        (void)rtc_alarm_is_pending(rtc, 0);
+        LOG_INF("Woken up by the RTC alarm");
+    }
+
+    int64_t rtc_s;
+    int64_t ticks;
+    ret = time_service_read_rtc(&rtc_s, &ticks);
+    if (ret == 0)
+    {
+        // somewhere in the second it read: count from the start of it, so
+        // the first sync only ever moves wall time forward
+        time_service_step(rtc_s * USEC_PER_SEC, ticks);
+        is_set = true;
+    }
+    else
+    {
+        LOG_WRN("RTC has no valid time (%d), counting from 1970", ret);
+    }
+
+    ret = rtc_alarm_set_callback(rtc, 0, time_service_alarm_cb, NULL);
+    if (ret < 0)
+    {
+        LOG_WRN("No alarm callback: %d", ret);
+    }
+
+    // find the seconds edge right away, rather than an interval from now
+    if (is_set)
+    {
+        time_service_sync_start();
+    }
+    else
+    {
+        k_work_schedule(&sync_work, K_SECONDS(CONFIG_T_WATCH_S3_TIME_SERVICE_SYNC_INTERVAL_S));
+    }
+    return 0;
+}
+
+SYS_INIT(time_service_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
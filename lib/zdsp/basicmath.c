@@ -0,0 +1,355 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <zephyr/dsp/dsp.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+// Results match CMSIS-DSP's, bit for bit in Q15 and Q31: saturated where it
+// saturates, with the same rounding (down) and output formats.
+
+static inline q15_t sat_q15(int32_t value)
+{
+    return CLAMP(value, INT16_MIN, INT16_MAX);
+}
+
+static inline q31_t sat_q31(int64_t value)
+{
+    return CLAMP(value, INT32_MIN, INT32_MAX);
+}
+
+#ifdef CONFIG_T_WATCH_S3_ZDSP_PIE
+// PIE works on 128-bit Q registers, 8 Q15 or 4 Q31 at a time. Its loads and
+// stores ignore the low 4 address bits, so only aligned buffers take this
+// path, and each kernel returns how many elements it did: the C loops do
+// the rest.
+#define PIE_ALIGNED(ptr) (((uintptr_t)(ptr) & 15) == 0)
+
+// PIE is coprocessor 3, and Zephyr leaves it off in CPENABLE, where its
+// first instruction would raise a coprocessor exception. Zephyr also saves
+// neither the Q registers nor ACCX on a context switch, so no other thread
+// may run PIE code in the middle of a kernel.
+#define PIE_CPENABLE BIT(3)
+
+static inline uint32_t pie_begin(void)
+{
+    uint32_t cpenable;
+
+    k_sched_lock();
+    __asm__ volatile("rsr.cpenable %0" : "=r"(cpenable));
+    __asm__ volatile("wsr.cpenable %0\n\t"
+                     "rsync\n\t"
+                     :
+                     : "r"(cpenable | PIE_CPENABLE)
+                     : "memory");
+    return cpenable;
+}
+
+static inline void pie_end(uint32_t cpenable)
+{
+    __asm__ volatile("wsr.cpenable %0\n\t"
+                     "rsync\n\t"
+                     :
+                     : "r"(cpenable)
+                     : "memory");
+    k_sched_unlock();
+}
+
+static uint32_t pie_add_q15(const q15_t *src_a, const q15_t *src_b, q15_t *dst, uint32_t block_size)
+{
+    if (!PIE_ALIGNED(src_a) || !PIE_ALIGNED(src_b) || !PIE_ALIGNED(dst))
+    {
+        return 0;
+    }
+
+    const uint32_t vectors = block_size / 8;
+    const uint32_t cpenable = pie_begin();
+    for (uint32_t i = 0; i < vectors; i++)
+    {
+        __asm__ volatile("ee.vld.128.ip q0, %0, 16\n\t"
+                         "ee.vld.128.ip q1, %1, 16\n\t"
+                         "ee.vadds.s16 q2, q0, q1\n\t"
+                         "ee.vst.128.ip q2, %2, 16\n\t"
+                         : "+r"(src_a), "+r"(src_b), "+r"(dst)
+                         :
+                         : "memory");
+    }
+    pie_end(cpenable);
+
+    return vectors * 8;
+}
+
+static uint32_t pie_add_q31(const q31_t *src_a, const q31_t *src_b, q31_t *dst, uint32_t block_size)
+{
+    if (!PIE_ALIGNED(src_a) || !PIE_ALIGNED(src_b) || !PIE_ALIGNED(dst))
+    {
+        return 0;
+    }
+
+    const uint32_t vectors = block_size / 4;
+    const uint32_t cpenable = pie_begin();
+    for (uint32_t i = 0; i < vectors; i++)
+    {
+        __asm__ volatile("ee.vld.128.ip q0, %0, 16\n\t"
+                         "ee.vld.128.ip q1, %1, 16\n\t"
+                         "ee.vadds.s32 q2, q0, q1\n\t"
+                         "ee.vst.128.ip q2, %2, 16\n\t"
+                         : "+r"(src_a), "+r"(src_b), "+r"(dst)
+                         :
+                         : "memory");
+    }
+    pie_end(cpenable);
+
+    return vectors * 4;
+}
+
+// EE.VMUL.S16 shifts each 32-bit product right by SAR before saturating it
+// to 16 bits. The compiler uses SAR for its own shifts and has no clobber
+// for it, so each statement sets it and puts the old value back.
+static uint32_t pie_mult_q15(const q15_t *src_a, const q15_t *src_b, q15_t *dst, uint32_t block_size,
+                             uint32_t shift)
+{
+    if (!PIE_ALIGNED(src_a) || !PIE_ALIGNED(src_b) || !PIE_ALIGNED(dst))
+    {
+        return 0;
+    }
+
+    const uint32_t vectors = block_size / 8;
+    const uint32_t cpenable = pie_begin();
+    for (uint32_t i = 0; i < vectors; i++)
+    {
+        uint32_t sar;
+        __asm__ volatile("rsr.sar %3\n\t"
+                         "ssr %4\n\t"
+                         "ee.vld.128.ip q0, %0, 16\n\t"
+                         "ee.vld.128.ip q1, %1, 16\n\t"
+                         "ee.vmul.s16 q2, q0, q1\n\t"
+                         "ee.vst.128.ip q2, %2, 16\n\t"
+                         "wsr.sar %3\n\t"
+                         : "+r"(src_a), "+r"(src_b), "+r"(dst), "=&r"(sar)
+                         : "r"(shift)
+                         : "memory");
+    }
+    pie_end(cpenable);
+
+    return vectors * 8;
+}
+
+static uint32_t pie_scale_q15(const q15_t *src, q15_t scale_fract, uint32_t shift, q15_t *dst, uint32_t block_size)
+{
+    if (!PIE_ALIGNED(src) || !PIE_ALIGNED(dst))
+    {
+        return 0;
+    }
+
+    const uint32_t vectors = block_size / 8;
+    const uint32_t cpenable = pie_begin();
+    for (uint32_t i = 0; i < vectors; i++)
+    {
+        uint32_t sar;
+        __asm__ volatile("rsr.sar %2\n\t"
+                         "ssr %4\n\t"
+                         "ee.vldbc.16 q1, %3\n\t"
+                         "ee.vld.128.ip q0, %0, 16\n\t"
+                         "ee.vmul.s16 q2, q0, q1\n\t"
+                         "ee.vst.128.ip q2, %1, 16\n\t"
+                         "wsr.sar %2\n\t"
+                         : "+r"(src), "+r"(dst), "=&r"(sar)
+                         : "r"(&scale_fract), "r"(shift)
+                         : "memory");
+    }
+    pie_end(cpenable);
+
+    return vectors * 8;
+}
+
+// ACCX is 40 bits wide. A vector adds at most 8 * 2^30 to it, so it is
+// moved into the 64-bit result every 32 vectors, before it can overflow.
+#define PIE_DOT_VECTORS 32
+
+static uint32_t pie_dot_prod_q15(const q15_t *src_a, const q15_t *src_b, uint32_t block_size, q63_t *result)
+{
+    if (!PIE_ALIGNED(src_a) || !PIE_ALIGNED(src_b))
+    {
+        *result = 0;
+        return 0;
+    }
+
+    q63_t sum = 0;
+    uint32_t vectors = block_size / 8;
+    const uint32_t cpenable = pie_begin();
+    while (vectors > 0)
+    {
+        const uint32_t chunk = MIN(vectors, PIE_DOT_VECTORS);
+        __asm__ volatile("ee.zero.accx");
+        for (uint32_t i = 0; i < chunk; i++)
+        {
+            __asm__ volatile("ee.vld.128.ip q0, %0, 16\n\t"
+                             "ee.vld.128.ip q1, %1, 16\n\t"
+                             "ee.vmulas.s16.accx q0, q1\n\t"
+                             : "+r"(src_a), "+r"(src_b)
+                             :
+                             : "memory");
+        }
+
+        uint32_t low;
+        uint32_t high;
+        __asm__ volatile("rur.accx_0 %0\n\t"
+                         "rur.accx_1 %1\n\t"
+                         : "=r"(low), "=r"(high));
+        // sign extend the 40 bits
+        sum += (int64_t)(((uint64_t)high << 56) | ((uint64_t)low << 24)) >> 24;
+        vectors -= chunk;
+    }
+    pie_end(cpenable);
+
+    *result = sum;
+    return (block_size / 8) * 8;
+}
+#else
+#define pie_add_q15(...) 0
+#define pie_add_q31(...) 0
+#define pie_mult_q15(...) 0
+#define pie_scale_q15(...) 0
+#define pie_dot_prod_q15(src_a, src_b, block_size, result) (*(result) = 0, 0)
+#endif
+
+void zdsp_add_q15(const DSP_DATA q15_t *src_a, const DSP_DATA q15_t *src_b, DSP_DATA q15_t *dst,
+                  uint32_t block_size)
+{
+    for (uint32_t i = pie_add_q15(src_a, src_b, dst, block_size); i < block_size; i++)
+    {
+        dst[i] = sat_q15((int32_t)src_a[i] + src_b[i]);
+    }
+}
+
+void zdsp_add_q31(const DSP_DATA q31_t *src_a, const DSP_DATA q31_t *src_b, DSP_DATA q31_t *dst,
+                  uint32_t block_size)
+{
+    for (uint32_t i = pie_add_q31(src_a, src_b, dst, block_size); i < block_size; i++)
+    {
+        dst[i] = sat_q31((int64_t)src_a[i] + src_b[i]);
+    }
+}
+
+void zdsp_add_f32(const DSP_DATA float32_t *src_a, const DSP_DATA float32_t *src_b, DSP_DATA float32_t *dst,
+                  uint32_t block_size)
+{
+    for (uint32_t i = 0; i < block_size; i++)
+    {
+        dst[i] = src_a[i] + src_b[i];
+    }
+}
+
+void zdsp_mult_q15(const DSP_DATA q15_t *src_a, const DSP_DATA q15_t *src_b, DSP_DATA q15_t *dst,
+                   uint32_t block_size)
+{
+    for (uint32_t i = pie_mult_q15(src_a, src_b, dst, block_size, 15); i < block_size; i++)
+    {
+        dst[i] = sat_q15(((int32_t)src_a[i] * src_b[i]) >> 15);
+    }
+}
+
+void zdsp_mult_q31(const DSP_DATA q31_t *src_a, const DSP_DATA q31_t *src_b, DSP_DATA q31_t *dst,
+                   uint32_t block_size)
+{
+    // No 32-bit multiply in PIE. CMSIS keeps the top half of the Q62
+    // product and saturates it to 31 bits, so the result's LSB is always 0.
+    for (uint32_t i = 0; i < block_size; i++)
+    {
+        const int64_t high = ((int64_t)src_a[i] * src_b[i]) >> 32;
+        dst[i] = CLAMP(high, INT32_MIN / 2, INT32_MAX / 2) * 2;
+    }
+}
+
+void zdsp_mult_f32(const DSP_DATA float32_t *src_a, const DSP_DATA float32_t *src_b, DSP_DATA float32_t *dst,
+                   uint32_t block_size)
+{
+    for (uint32_t i = 0; i < block_size; i++)
+    {
+        dst[i] = src_a[i] * src_b[i];
+    }
+}
+
+// The product of two Q15 is Q30, and shifting it right by 15 - shift both
+// brings it back to Q15 and applies the shift
+void zdsp_scale_q15(const DSP_DATA q15_t *src, q15_t scale_fract, int8_t shift, DSP_DATA q15_t *dst,
+                    uint32_t block_size)
+{
+    const int32_t right = 15 - shift;
+    uint32_t i = 0;
+
+    // a left shift could overflow before the saturation
+    if (right >= 0 && right < 32)
+    {
+        i = pie_scale_q15(src, scale_fract, right, dst, block_size);
+    }
+
+    for (; i < block_size; i++)
+    {
+        const int64_t product = (int32_t)src[i] * scale_fract;
+        dst[i] = sat_q15(right >= 0 ? product >> MIN(right, 63) : product * (1LL << MIN(-right, 31)));
+    }
+}
+
+// Q31 times Q31 is Q62, and CMSIS keeps its top 32 bits (Q30) before
+// shifting left by shift + 1, saturating, or right when that is negative
+void zdsp_scale_q31(const DSP_DATA q31_t *src, q31_t scale_fract, int8_t shift, DSP_DATA q31_t *dst,
+                    uint32_t block_size)
+{
+    const int32_t left = shift + 1;
+
+    for (uint32_t i = 0; i < block_size; i++)
+    {
+        const int64_t product = ((int64_t)src[i] * scale_fract) >> 32;
+        dst[i] = left >= 0 ? sat_q31(product * (1LL << MIN(left, 31))) : (q31_t)(product >> MIN(-left, 63));
+    }
+}
+
+void zdsp_scale_f32(const DSP_DATA float32_t *src, float32_t scale, DSP_DATA float32_t *dst, uint32_t block_size)
+{
+    for (uint32_t i = 0; i < block_size; i++)
+    {
+        dst[i] = src[i] * scale;
+    }
+}
+
+// Q30 products summed in Q34.30
+void zdsp_dot_prod_q15(const DSP_DATA q15_t *src_a, const DSP_DATA q15_t *src_b, uint32_t block_size,
+                       DSP_DATA q63_t *result)
+{
+    q63_t sum;
+    for (uint32_t i = pie_dot_prod_q15(src_a, src_b, block_size, &sum); i < block_size; i++)
+    {
+        sum += (int32_t)src_a[i] * src_b[i];
+    }
+
+    *result = sum;
+}
+
+// Q62 products, shifted down to Q48 to leave 14 guard bits, as in CMSIS
+void zdsp_dot_prod_q31(const DSP_DATA q31_t *src_a, const DSP_DATA q31_t *src_b, uint32_t block_size,
+                       DSP_DATA q63_t *result)
+{
+    q63_t sum = 0;
+    for (uint32_t i = 0; i < block_size; i++)
+    {
+        sum += ((int64_t)src_a[i] * src_b[i]) >> 14;
+    }
+
+    *result = sum;
+}
+
+void zdsp_dot_prod_f32(const DSP_DATA float32_t *src_a, const DSP_DATA float32_t *src_b, uint32_t block_size,
+                       DSP_DATA float32_t *result)
+{
+    float32_t sum = 0;
+    for (uint32_t i = 0; i < block_size; i++)
+    {
+        sum += src_a[i] * src_b[i];
+    }
+
+    *result = sum;
+}
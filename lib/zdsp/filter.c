@@ -0,0 +1,224 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <t_watch_s3/zdsp_filter.h>
+
+#include <string.h>
+
+#include <zephyr/sys/__assert.h>
+#include <zephyr/sys/util.h>
+
+// The FIR state is the last num_taps - 1 inputs, oldest first, followed by
+// room for a block. Each block is copied in behind the history, so every
+// output is a plain dot product over contiguous samples, and the newest
+// num_taps - 1 are moved to the front for the next block.
+#define FIR_INIT(fir, coeffs_, num_taps_, state_, max_block_)                                                        \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        __ASSERT_NO_MSG((num_taps_) > 0);                                                                              \
+        (fir)->coeffs = (coeffs_);                                                                                     \
+        (fir)->state = (state_);                                                                                       \
+        (fir)->num_taps = (num_taps_);                                                                                 \
+        (fir)->max_block = (max_block_);                                                                               \
+        memset((state_), 0, ((num_taps_) - 1) * sizeof(*(state_)));                                                    \
+    } while (0)
+
+void zdsp_fir_q15_init(struct zdsp_fir_q15 *fir, const q15_t *coeffs, uint16_t num_taps, q15_t *state,
+                       uint16_t max_block)
+{
+    FIR_INIT(fir, coeffs, num_taps, state, max_block);
+}
+
+void zdsp_fir_q31_init(struct zdsp_fir_q31 *fir, const q31_t *coeffs, uint16_t num_taps, q31_t *state,
+                       uint16_t max_block)
+{
+    FIR_INIT(fir, coeffs, num_taps, state, max_block);
+}
+
+void zdsp_fir_f32_init(struct zdsp_fir_f32 *fir, const float32_t *coeffs, uint16_t num_taps, float32_t *state,
+                       uint16_t max_block)
+{
+    FIR_INIT(fir, coeffs, num_taps, state, max_block);
+}
+
+void zdsp_fir_q15(struct zdsp_fir_q15 *fir, const q15_t *src, q15_t *dst, uint32_t block_size)
+{
+    __ASSERT_NO_MSG(block_size <= fir->max_block);
+    const uint16_t history = fir->num_taps - 1;
+    memcpy(&fir->state[history], src, block_size * sizeof(*src));
+
+    for (uint32_t n = 0; n < block_size; n++)
+    {
+        const q15_t *newest = &fir->state[history + n];
+        int64_t acc = 0;
+        for (uint16_t k = 0; k < fir->num_taps; k++)
+        {
+            acc += (int32_t)fir->coeffs[k] * newest[-k];
+        }
+        dst[n] = CLAMP(acc >> 15, INT16_MIN, INT16_MAX);
+    }
+
+    memmove(fir->state, &fir->state[block_size], history * sizeof(*src));
+}
+
+void zdsp_fir_q31(struct zdsp_fir_q31 *fir, const q31_t *src, q31_t *dst, uint32_t block_size)
+{
+    __ASSERT_NO_MSG(block_size <= fir->max_block);
+    const uint16_t history = fir->num_taps - 1;
+    memcpy(&fir->state[history], src, block_size * sizeof(*src));
+
+    for (uint32_t n = 0; n < block_size; n++)
+    {
+        const q31_t *newest = &fir->state[history + n];
+        int64_t acc = 0;
+        for (uint16_t k = 0; k < fir->num_taps; k++)
+        {
+            acc += (int64_t)fir->coeffs[k] * newest[-k];
+        }
+        dst[n] = (q31_t)(acc >> 31);
+    }
+
+    memmove(fir->state, &fir->state[block_size], history * sizeof(*src));
+}
+
+void zdsp_fir_f32(struct zdsp_fir_f32 *fir, const float32_t *src, float32_t *dst, uint32_t block_size)
+{
+    __ASSERT_NO_MSG(block_size <= fir->max_block);
+    const uint16_t history = fir->num_taps - 1;
+    memcpy(&fir->state[history], src, block_size * sizeof(*src));
+
+    for (uint32_t n = 0; n < block_size; n++)
+    {
+        const float32_t *newest = &fir->state[history + n];
+        float32_t acc = 0;
+        for (uint16_t k = 0; k < fir->num_taps; k++)
+        {
+            acc += fir->coeffs[k] * newest[-k];
+        }
+        dst[n] = acc;
+    }
+
+    memmove(fir->state, &fir->state[block_size], history * sizeof(*src));
+}
+
+void zdsp_biquad_q15_init(struct zdsp_biquad_q15 *biquad, uint8_t num_stages, const q15_t *coeffs, q15_t *state,
+                          uint8_t post_shift)
+{
+    __ASSERT_NO_MSG(post_shift < 15);
+    biquad->coeffs = coeffs;
+    biquad->state = state;
+    biquad->num_stages = num_stages;
+    biquad->post_shift = post_shift;
+    memset(state, 0, ZDSP_BIQUAD_Q_STATE_LEN(num_stages) * sizeof(*state));
+}
+
+void zdsp_biquad_q31_init(struct zdsp_biquad_q31 *biquad, uint8_t num_stages, const q31_t *coeffs, q31_t *state,
+                          uint8_t post_shift)
+{
+    __ASSERT_NO_MSG(post_shift < 31);
+    biquad->coeffs = coeffs;
+    biquad->state = state;
+    biquad->num_stages = num_stages;
+    biquad->post_shift = post_shift;
+    memset(state, 0, ZDSP_BIQUAD_Q_STATE_LEN(num_stages) * sizeof(*state));
+}
+
+void zdsp_biquad_f32_init(struct zdsp_biquad_f32 *biquad, uint8_t num_stages, const float32_t *coeffs,
+                          float32_t *state)
+{
+    biquad->coeffs = coeffs;
+    biquad->state = state;
+    biquad->num_stages = num_stages;
+    memset(state, 0, ZDSP_BIQUAD_F32_STATE_LEN(num_stages) * sizeof(*state));
+}
+
+// Direct form I: each stage keeps {x[n-1], x[n-2], y[n-1], y[n-2]}, in
+// registers for the length of the block
+void zdsp_biquad_q15(struct zdsp_biquad_q15 *biquad, const q15_t *src, q15_t *dst, uint32_t block_size)
+{
+    const uint8_t shift = 15 - biquad->post_shift;
+
+    for (uint8_t stage = 0; stage < biquad->num_stages; stage++)
+    {
+        const q15_t *c = &biquad->coeffs[stage * 5];
+        q15_t *s = &biquad->state[stage * 4];
+        int32_t x1 = s[0], x2 = s[1], y1 = s[2], y2 = s[3];
+
+        for (uint32_t n = 0; n < block_size; n++)
+        {
+            const int32_t x0 = src[n];
+            const int64_t acc = (int64_t)c[0] * x0 + (int64_t)c[1] * x1 + (int64_t)c[2] * x2 +
+                                (int64_t)c[3] * y1 + (int64_t)c[4] * y2;
+            const q15_t y0 = CLAMP(acc >> shift, INT16_MIN, INT16_MAX);
+
+            x2 = x1;
+            x1 = x0;
+            y2 = y1;
+            y1 = y0;
+            dst[n] = y0;
+        }
+
+        s[0] = x1;
+        s[1] = x2;
+        s[2] = y1;
+        s[3] = y2;
+        // the next stage filters this one's output
+        src = dst;
+    }
+}
+
+void zdsp_biquad_q31(struct zdsp_biquad_q31 *biquad, const q31_t *src, q31_t *dst, uint32_t block_size)
+{
+    const uint8_t shift = 31 - biquad->post_shift;
+
+    for (uint8_t stage = 0; stage < biquad->num_stages; stage++)
+    {
+        const q31_t *c = &biquad->coeffs[stage * 5];
+        q31_t *s = &biquad->state[stage * 4];
+        int64_t x1 = s[0], x2 = s[1], y1 = s[2], y2 = s[3];
+
+        for (uint32_t n = 0; n < block_size; n++)
+        {
+            const int64_t x0 = src[n];
+            const int64_t acc = c[0] * x0 + c[1] * x1 + c[2] * x2 + c[3] * y1 + c[4] * y2;
+            const q31_t y0 = CLAMP(acc >> shift, INT32_MIN, INT32_MAX);
+
+            x2 = x1;
+            x1 = x0;
+            y2 = y1;
+            y1 = y0;
+            dst[n] = y0;
+        }
+
+        s[0] = x1;
+        s[1] = x2;
+        s[2] = y1;
+        s[3] = y2;
+        src = dst;
+    }
+}
+
+// Direct form II transposed: two delays per stage instead of four
+void zdsp_biquad_f32(struct zdsp_biquad_f32 *biquad, const float32_t *src, float32_t *dst, uint32_t block_size)
+{
+    for (uint8_t stage = 0; stage < biquad->num_stages; stage++)
+    {
+        const float32_t *c = &biquad->coeffs[stage * 5];
+        float32_t *s = &biquad->state[stage * 2];
+        float32_t d1 = s[0], d2 = s[1];
+
+        for (uint32_t n = 0; n < block_size; n++)
+        {
+            const float32_t x0 = src[n];
+            const float32_t y0 = c[0] * x0 + d1;
+            d1 = c[1] * x0 + c[3] * y0 + d2;
+            d2 = c[2] * x0 + c[4] * y0;
+            dst[n] = y0;
+        }
+
+        s[0] = d1;
+        s[1] = d2;
+        src = dst;
+    }
+}
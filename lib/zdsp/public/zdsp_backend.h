@@ -0,0 +1,12 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef ZDSP_BACKEND_H
+#define ZDSP_BACKEND_H
+
+// Included by zephyr/dsp/dsp.h. The functions it declares are defined out
+// of line in lib/zdsp, so there is nothing to add here: filters beyond
+// Zephyr's basic math are in <t_watch_s3/zdsp_filter.h>.
+
+#endif // ZDSP_BACKEND_H
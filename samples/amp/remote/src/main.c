@@ -0,0 +1,50 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <zephyr/kernel.h>
+#include <t_watch_s3/amp_ipc.h>
+
+#include "probe.h"
+
+// APPCPU side: announce itself, then echo pings until the end of time
+
+int main(void)
+{
+    const uint32_t main_us = (uint32_t)k_ticks_to_us_floor64(k_uptime_ticks());
+
+    // anything sent before PROCPU attaches is dropped when it does
+    amp_ipc_wait_ready(K_FOREVER);
+
+    void *buf;
+    if (amp_ipc_alloc(&buf, sizeof(struct probe_msg), K_FOREVER) == 0)
+    {
+        *(struct probe_msg *)buf = (struct probe_msg){.type = PROBE_HELLO, .main_us = main_us};
+        amp_ipc_send(buf, sizeof(struct probe_msg));
+    }
+
+    while (true)
+    {
+        void *rx_buf;
+        int len = amp_ipc_claim(&rx_buf, K_FOREVER);
+        if (len < (int)sizeof(struct probe_msg))
+        {
+            if (len > 0)
+            {
+                amp_ipc_release(rx_buf, len);
+            }
+            continue;
+        }
+
+        const struct probe_msg rx = *(struct probe_msg *)rx_buf;
+        amp_ipc_release(rx_buf, len);
+
+        if (rx.type == PROBE_PING && amp_ipc_alloc(&buf, sizeof(rx), K_FOREVER) == 0)
+        {
+            *(struct probe_msg *)buf = (struct probe_msg){.type = PROBE_PING, .main_us = main_us, .seq = rx.seq};
+            amp_ipc_send(buf, sizeof(rx));
+        }
+    }
+
+    return 0;
+}
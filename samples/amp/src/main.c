@@ -0,0 +1,112 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <zephyr/kernel.h>
+#include <t_watch_s3/amp_ipc.h>
+
+#include "probe.h"
+
+// PROCPU side. By the time main() runs, the SoC startup code has already
+// copied the APPCPU image out of slot0_appcpu_partition and released APPCPU
+// from reset (CONFIG_SOC_ENABLE_APPCPU). Everything here measures how long
+// it then takes for APPCPU to become usable.
+
+#define PINGS 100
+
+static uint32_t now_us(void)
+{
+    return (uint32_t)k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+static int claim_msg(struct probe_msg *out, k_timeout_t timeout)
+{
+    void *buf;
+    int len = amp_ipc_claim(&buf, timeout);
+    if (len < 0)
+    {
+        return len;
+    }
+
+    const bool valid = len >= (int)sizeof(*out);
+    if (valid)
+    {
+        *out = *(struct probe_msg *)buf;
+    }
+    amp_ipc_release(buf, len);
+    return valid ? 0 : -EBADMSG;
+}
+
+static void ping(void)
+{
+    uint32_t first = 0;
+    uint32_t max = 0;
+    uint64_t total = 0;
+
+    for (uint32_t i = 0; i < PINGS; i++)
+    {
+        const uint32_t start = k_cycle_get_32();
+
+        void *buf;
+        struct probe_msg reply;
+        int ret = amp_ipc_alloc(&buf, sizeof(reply), K_SECONDS(1));
+        if (ret == 0)
+        {
+            *(struct probe_msg *)buf = (struct probe_msg){.type = PROBE_PING, .seq = i};
+            amp_ipc_send(buf, sizeof(reply));
+            ret = claim_msg(&reply, K_SECONDS(1));
+        }
+
+        const uint32_t cycles = k_cycle_get_32() - start;
+        if (ret < 0 || reply.type != PROBE_PING || reply.seq != i)
+        {
+            printk("ping %u failed: %d\n", i, ret);
+            return;
+        }
+
+        first = i == 0 ? cycles : first;
+        max = MAX(max, cycles);
+        total += cycles;
+    }
+
+    printk("round trip: first %u us, avg %u us, max %u us\n", k_cyc_to_us_floor32(first),
+           k_cyc_to_us_floor32((uint32_t)(total / PINGS)), k_cyc_to_us_floor32(max));
+}
+
+int main(void)
+{
+    const uint32_t main_us = now_us();
+
+    if (amp_ipc_wait_ready(K_SECONDS(5)) < 0)
+    {
+        printk("APPCPU did not attach, was the image built with sysbuild and flashed?\n");
+        return 0;
+    }
+    const uint32_t attach_us = now_us();
+
+    struct probe_msg hello;
+    if (claim_msg(&hello, K_SECONDS(1)) < 0 || hello.type != PROBE_HELLO)
+    {
+        printk("APPCPU attached but never said hello\n");
+        return 0;
+    }
+    const uint32_t hello_us = now_us();
+
+    // Both uptimes count from their own kernel start. The hello is stamped
+    // as it leaves APPCPU's main(), so subtracting it from the arrival time
+    // places APPCPU's kernel start on the PROCPU timeline (to within one
+    // message latency).
+    printk("PROCPU main() at %u.%03u ms\n", main_us / 1000, main_us % 1000);
+    printk("APPCPU attached at %u.%03u ms\n", attach_us / 1000, attach_us % 1000);
+    printk("APPCPU main() reached %u.%03u ms after its kernel start\n", hello.main_us / 1000,
+           hello.main_us % 1000);
+    if (hello_us > hello.main_us)
+    {
+        const uint32_t start_us = hello_us - hello.main_us;
+        printk("APPCPU kernel started at ~%u.%03u ms of PROCPU uptime\n", start_us / 1000, start_us % 1000);
+    }
+
+    ping();
+    printk("amp done\n");
+    return 0;
+}
@@ -0,0 +1,22 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef AMP_PROBE_H
+#define AMP_PROBE_H
+
+#include <stdint.h>
+
+#define PROBE_HELLO 0x48454c4f // "HELO"
+#define PROBE_PING 0x50494e47  // "PING"
+
+// Sent by APPCPU as soon as its main() runs, then echoed back for pings
+struct probe_msg
+{
+    uint32_t type;
+    // APPCPU uptime when main() was entered, in microseconds of its own clock
+    uint32_t main_us;
+    uint32_t seq;
+};
+
+#endif // AMP_PROBE_H
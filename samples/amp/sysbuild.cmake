@@ -0,0 +1,17 @@
+# Copyright (c) 2025, Noah Luskey <noah@vvvvvvvvvv.io>
+# SPDX-License-Identifier: Apache-2.0
+
+if("${SB_CONFIG_REMOTE_BOARD}" STREQUAL "")
+  message(FATAL_ERROR "REMOTE_BOARD must be set to a valid board name")
+endif()
+
+ExternalZephyrProject_Add(
+  APPLICATION amp_remote
+  SOURCE_DIR ${APP_DIR}/remote
+  BOARD ${SB_CONFIG_REMOTE_BOARD}
+)
+
+# The APPCPU image is built first and flashed alongside the PROCPU one, which
+# loads it from slot0_appcpu_partition at boot
+add_dependencies(${DEFAULT_IMAGE} amp_remote)
+sysbuild_add_dependencies(FLASH ${DEFAULT_IMAGE} amp_remote)
@@ -0,0 +1,206 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <zephyr/kernel.h>
+#include <t_watch_s3/amp_ipc.h>
+
+// The same application is built for both cores. APPCPU runs a responder,
+// PROCPU drives the benchmark and prints the results.
+
+enum msg_type
+{
+    // reply with a message of the same size
+    MSG_PING,
+    // count and drop
+    MSG_SINK,
+    // reply with the number of bytes sunk so far
+    MSG_FLUSH,
+};
+
+struct msg_header
+{
+    uint32_t type;
+    uint32_t value;
+};
+
+#if defined(CONFIG_SOC_ESP32S3_APPCPU)
+
+int main(void)
+{
+    uint32_t sunk = 0;
+
+    while (true)
+    {
+        void *rx_buf;
+        int len = amp_ipc_claim(&rx_buf, K_FOREVER);
+        if (len < (int)sizeof(struct msg_header))
+        {
+            if (len > 0)
+            {
+                amp_ipc_release(rx_buf, len);
+            }
+            continue;
+        }
+
+        const struct msg_header rx = *(struct msg_header *)rx_buf;
+        amp_ipc_release(rx_buf, len);
+
+        size_t reply_len = 0;
+        uint32_t value = rx.value;
+        switch (rx.type)
+        {
+        case MSG_PING:
+            reply_len = len;
+            break;
+        case MSG_SINK:
+            sunk += len;
+            break;
+        case MSG_FLUSH:
+            reply_len = sizeof(struct msg_header);
+            value = sunk;
+            sunk = 0;
+            break;
+        default:
+            break;
+        }
+
+        if (reply_len > 0)
+        {
+            void *tx_buf;
+            if (amp_ipc_alloc(&tx_buf, reply_len, K_FOREVER) == 0)
+            {
+                // the payload is left as-is: only the header has to make it back
+                *(struct msg_header *)tx_buf = (struct msg_header){.type = rx.type, .value = value};
+                amp_ipc_send(tx_buf, reply_len);
+            }
+        }
+    }
+
+    return 0;
+}
+
+#else
+
+#define ROUND_TRIPS 200
+#define STREAM_BYTES (256 * 1024)
+
+static const size_t sizes[] = {16, 64, 256, 1024, 4096, 16384};
+
+static int send_msg(size_t len, enum msg_type type, uint32_t value)
+{
+    void *buf;
+    int ret = amp_ipc_alloc(&buf, len, K_SECONDS(1));
+    if (ret < 0)
+    {
+        return ret;
+    }
+    *(struct msg_header *)buf = (struct msg_header){.type = type, .value = value};
+    return amp_ipc_send(buf, len);
+}
+
+static int recv_msg(struct msg_header *out)
+{
+    void *buf;
+    int len = amp_ipc_claim(&buf, K_SECONDS(1));
+    if (len < 0)
+    {
+        return len;
+    }
+    *out = *(struct msg_header *)buf;
+    amp_ipc_release(buf, len);
+    return len;
+}
+
+static int bench_latency(size_t len)
+{
+    uint32_t min = UINT32_MAX;
+    uint32_t max = 0;
+    uint64_t total = 0;
+
+    for (uint32_t i = 0; i < ROUND_TRIPS; i++)
+    {
+        struct msg_header reply;
+        const uint32_t start = k_cycle_get_32();
+        int ret = send_msg(len, MSG_PING, i);
+        if (ret == 0)
+        {
+            ret = recv_msg(&reply);
+        }
+        const uint32_t cycles = k_cycle_get_32() - start;
+
+        if (ret < 0 || reply.value != i)
+        {
+            printk("size=%zu error=%d\n", len, ret);
+            return -EIO;
+        }
+
+        min = MIN(min, cycles);
+        max = MAX(max, cycles);
+        total += cycles;
+    }
+
+    printk("size=%zu rtt_avg_us=%u rtt_min_us=%u rtt_max_us=%u ", len,
+           k_cyc_to_us_floor32((uint32_t)(total / ROUND_TRIPS)), k_cyc_to_us_floor32(min), k_cyc_to_us_floor32(max));
+    return 0;
+}
+
+static int bench_throughput(size_t len)
+{
+    const uint32_t count = MAX(STREAM_BYTES / len, 1);
+    const uint32_t start = k_cycle_get_32();
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (send_msg(len, MSG_SINK, i) < 0)
+        {
+            printk("error=stream\n");
+            return -EIO;
+        }
+    }
+
+    struct msg_header reply;
+    if (send_msg(sizeof(reply), MSG_FLUSH, 0) < 0 || recv_msg(&reply) < 0)
+    {
+        printk("error=flush\n");
+        return -EIO;
+    }
+
+    const uint32_t us = MAX(k_cyc_to_us_floor32(k_cycle_get_32() - start), 1);
+    const uint32_t msgs_per_s = (uint32_t)((uint64_t)count * USEC_PER_SEC / us);
+    const uint32_t kbytes_per_s = (uint32_t)((uint64_t)reply.value * USEC_PER_SEC / 1024 / us);
+    printk("msgs_per_s=%u throughput_kBps=%u\n", msgs_per_s, kbytes_per_s);
+
+    return reply.value == count * len ? 0 : -EIO;
+}
+
+int main(void)
+{
+    const uint32_t boot_ms = k_uptime_get_32();
+    if (amp_ipc_wait_ready(K_SECONDS(5)) < 0)
+    {
+        printk("APPCPU did not attach, is its image flashed?\n");
+        return 0;
+    }
+    printk("APPCPU attached %u ms after PROCPU main()\n", k_uptime_get_32() - boot_ms);
+    printk("max message size %zu\n", amp_ipc_max_len());
+
+    for (size_t i = 0; i < ARRAY_SIZE(sizes); i++)
+    {
+        if (sizes[i] > amp_ipc_max_len())
+        {
+            printk("size=%zu skipped (does not fit zephyr,ipc_shm)\n", sizes[i]);
+            continue;
+        }
+
+        if (bench_latency(sizes[i]) < 0 || bench_throughput(sizes[i]) < 0)
+        {
+            break;
+        }
+    }
+
+    printk("amp_ipc_benchmark done\n");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,16 @@
+# Copyright (c) 2025, Noah Luskey <noah@vvvvvvvvvv.io>
+# SPDX-License-Identifier: Apache-2.0
+
+if("${SB_CONFIG_REMOTE_BOARD}" STREQUAL "")
+  message(FATAL_ERROR "REMOTE_BOARD must be set to a valid board name")
+endif()
+
+# the same application, built again for APPCPU
+ExternalZephyrProject_Add(
+  APPLICATION amp_ipc_benchmark_remote
+  SOURCE_DIR ${APP_DIR}
+  BOARD ${SB_CONFIG_REMOTE_BOARD}
+)
+
+add_dependencies(${DEFAULT_IMAGE} amp_ipc_benchmark_remote)
+sysbuild_add_dependencies(FLASH ${DEFAULT_IMAGE} amp_ipc_benchmark_remote)
@@ -0,0 +1,250 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/flash.h>
+#include <zephyr/storage/flash_map.h>
+#include <string.h>
+
+#include <spi_flash_mmap.h>
+
+// Every pass moves BENCH_BYTES through the start of storage_partition,
+// which is erased and overwritten along the way
+#define BENCH_BYTES   (64 * 1024)
+#define ERASE_SECTORS 16
+
+#define FLASH_NODE  DT_CHOSEN(zephyr_flash)
+#define SECTOR_SIZE DT_PROP(FLASH_NODE, erase_block_size)
+
+BUILD_ASSERT(FIXED_PARTITION_SIZE(storage_partition) >= BENCH_BYTES, "storage_partition is too small");
+BUILD_ASSERT(ERASE_SECTORS * SECTOR_SIZE <= BENCH_BYTES);
+
+static const size_t block_sizes[] = {32, 128, 512, 2048, 4096, 16384, 65536};
+
+static const struct device *const flash = FIXED_PARTITION_DEVICE(storage_partition);
+static const off_t base = FIXED_PARTITION_OFFSET(storage_partition);
+
+static uint8_t pattern[BENCH_BYTES];
+static uint8_t buffer[BENCH_BYTES];
+// block order for the random passes: a shuffle of every block, so each one
+// is written exactly once
+static uint16_t order[BENCH_BYTES / 32];
+
+static uint32_t seed = 1;
+
+static uint32_t next_random(void)
+{
+    seed = seed * 1103515245 + 12345;
+    return seed >> 8;
+}
+
+static void shuffle(size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        order[i] = i;
+    }
+    for (size_t i = count - 1; i > 0; i--)
+    {
+        const size_t j = next_random() % (i + 1);
+        const uint16_t tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+}
+
+static void report(const char *op, size_t block, uint32_t cycles)
+{
+    const uint32_t us = MAX(k_cyc_to_us_floor32(cycles), 1);
+    printk("flash_bench op=%s block=%zu bytes=%u us=%u kBps=%u\n", op, block, BENCH_BYTES, us,
+           (uint32_t)((uint64_t)BENCH_BYTES * USEC_PER_SEC / 1024 / us));
+}
+
+static int erase_all(void)
+{
+    return flash_erase(flash, base, BENCH_BYTES);
+}
+
+static int bench_write(size_t block, bool random)
+{
+    const size_t count = BENCH_BYTES / block;
+    int ret = erase_all();
+    if (ret < 0)
+    {
+        return ret;
+    }
+    shuffle(count);
+
+    const uint32_t start = k_cycle_get_32();
+    for (size_t i = 0; i < count && ret == 0; i++)
+    {
+        const size_t pos = (random ? order[i] : i) * block;
+        ret = flash_write(flash, base + pos, &pattern[pos], block);
+    }
+    const uint32_t cycles = k_cycle_get_32() - start;
+    if (ret < 0)
+    {
+        return ret;
+    }
+
+    report(random ? "rand_write" : "seq_write", block, cycles);
+
+    // what was written is what the reads check
+    ret = flash_read(flash, base, buffer, BENCH_BYTES);
+    return ret < 0 ? ret : memcmp(buffer, pattern, BENCH_BYTES) == 0 ? 0 : -EIO;
+}
+
+static int bench_read(size_t block, bool random)
+{
+    const size_t count = BENCH_BYTES / block;
+    int ret = 0;
+    shuffle(count);
+    memset(buffer, 0, sizeof(buffer));
+
+    const uint32_t start = k_cycle_get_32();
+    for (size_t i = 0; i < count && ret == 0; i++)
+    {
+        const size_t pos = (random ? order[i] : i) * block;
+        ret = flash_read(flash, base + pos, &buffer[pos], block);
+    }
+    const uint32_t cycles = k_cycle_get_32() - start;
+    if (ret < 0)
+    {
+        return ret;
+    }
+
+    report(random ? "rand_read" : "seq_read", block, cycles);
+    return memcmp(buffer, pattern, BENCH_BYTES) == 0 ? 0 : -EIO;
+}
+
+// The same data through the flash cache: the first pass after mapping
+// misses, the second finds whatever still fits in the cache
+static int bench_mmap(size_t block)
+{
+    const size_t aligned = ROUND_DOWN(base, SPI_FLASH_MMU_PAGE_SIZE);
+    const size_t len = ROUND_UP(base + BENCH_BYTES, SPI_FLASH_MMU_PAGE_SIZE) - aligned;
+    const void *mapped;
+    spi_flash_mmap_handle_t handle;
+
+    if (spi_flash_mmap(aligned, len, SPI_FLASH_MMAP_DATA, &mapped, &handle) != ESP_OK)
+    {
+        return -ENOMEM;
+    }
+    const uint8_t *data = (const uint8_t *)mapped + (base - aligned);
+    int ret = 0;
+
+    for (int pass = 0; pass < 2 && ret == 0; pass++)
+    {
+        memset(buffer, 0, sizeof(buffer));
+        const uint32_t start = k_cycle_get_32();
+        for (size_t pos = 0; pos < BENCH_BYTES; pos += block)
+        {
+            memcpy(&buffer[pos], &data[pos], block);
+        }
+        const uint32_t cycles = k_cycle_get_32() - start;
+
+        report(pass == 0 ? "mmap_read_cold" : "mmap_read_warm", block, cycles);
+        ret = memcmp(buffer, pattern, BENCH_BYTES) == 0 ? 0 : -EIO;
+    }
+
+    spi_flash_munmap(handle);
+    return ret;
+}
+
+// One sector at a time, in order or shuffled, from written flash, as
+// erasing erased flash can be quicker
+static int bench_erase_sectors(bool random)
+{
+    int ret = flash_write(flash, base, pattern, BENCH_BYTES);
+    if (ret < 0)
+    {
+        return ret;
+    }
+    shuffle(ERASE_SECTORS);
+
+    uint32_t min = UINT32_MAX;
+    uint32_t max = 0;
+    uint64_t total = 0;
+    for (int i = 0; i < ERASE_SECTORS; i++)
+    {
+        const off_t pos = (random ? order[i] : i) * SECTOR_SIZE;
+        const uint32_t start = k_cycle_get_32();
+        ret = flash_erase(flash, base + pos, SECTOR_SIZE);
+        const uint32_t cycles = k_cycle_get_32() - start;
+        if (ret < 0)
+        {
+            return ret;
+        }
+
+        min = MIN(min, cycles);
+        max = MAX(max, cycles);
+        total += cycles;
+    }
+    printk("flash_bench op=%s size=%u count=%u avg_us=%u min_us=%u max_us=%u\n",
+           random ? "rand_erase_sector" : "erase_sector", SECTOR_SIZE, ERASE_SECTORS,
+           k_cyc_to_us_floor32(total / ERASE_SECTORS), k_cyc_to_us_floor32(min), k_cyc_to_us_floor32(max));
+    return 0;
+}
+
+// all of it in one call, which the driver may do in bigger blocks
+static int bench_erase(void)
+{
+    int ret = flash_write(flash, base, pattern, BENCH_BYTES);
+    if (ret < 0)
+    {
+        return ret;
+    }
+
+    const uint32_t start = k_cycle_get_32();
+    ret = erase_all();
+    const uint32_t cycles = k_cycle_get_32() - start;
+    if (ret == 0)
+    {
+        report("erase", BENCH_BYTES, cycles);
+    }
+    return ret;
+}
+
+ZTEST(flash_benchmark, test_flash_io)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(block_sizes); i++)
+    {
+        const size_t block = block_sizes[i];
+        zassert_ok(bench_write(block, false), "seq_write block=%zu", block);
+        zassert_ok(bench_read(block, false), "seq_read block=%zu", block);
+        zassert_ok(bench_read(block, true), "rand_read block=%zu", block);
+        zassert_ok(bench_mmap(block), "mmap_read block=%zu", block);
+        zassert_ok(bench_write(block, true), "rand_write block=%zu", block);
+    }
+}
+
+ZTEST(flash_benchmark, test_flash_erase)
+{
+    zassert_ok(bench_erase_sectors(false), "erase_sector");
+    zassert_ok(bench_erase_sectors(true), "rand_erase_sector");
+    zassert_ok(bench_erase(), "erase");
+}
+
+static void *flash_benchmark_setup(void)
+{
+    zassert_true(device_is_ready(flash), "flash not ready");
+    printk("storage_partition at 0x%lx, %u byte sectors, %u bytes per pass\n", (long)base, SECTOR_SIZE,
+           BENCH_BYTES);
+
+    for (size_t i = 0; i < sizeof(pattern); i++)
+    {
+        pattern[i] = next_random();
+    }
+    return NULL;
+}
+
+static void flash_benchmark_teardown(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    // left erased, like tests/src/flash.c leaves it
+    (void)erase_all();
+}
+
+ZTEST_SUITE(flash_benchmark, NULL, flash_benchmark_setup, NULL, NULL, flash_benchmark_teardown);
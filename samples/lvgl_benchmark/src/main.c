@@ -0,0 +1,210 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/display.h>
+#include <lvgl.h>
+
+#define FRAMES 300
+#define RAW_LINES 40
+
+struct phase
+{
+    const char *name;
+    uint32_t start;
+    uint64_t total;
+    uint32_t max;
+    uint32_t count;
+};
+
+static struct phase refresh = {.name = "refresh"};
+static struct phase render = {.name = "render"};
+static struct phase flush_wait = {.name = "flush wait"};
+
+static void phase_start(struct phase *p)
+{
+    p->start = k_cycle_get_32();
+}
+
+static void phase_end(struct phase *p)
+{
+    const uint32_t cycles = k_cycle_get_32() - p->start;
+    p->total += cycles;
+    p->max = MAX(p->max, cycles);
+    p->count++;
+}
+
+static void phase_reset(struct phase *p)
+{
+    p->total = 0;
+    p->max = 0;
+    p->count = 0;
+}
+
+static void phase_print(const struct phase *p, uint32_t frames)
+{
+    // flush waits happen zero or more times per frame, so average per frame
+    const uint64_t avg = frames ? p->total / frames : 0;
+    printk("  %-10s avg %6u us/frame, max %6u us (%u events)\n", p->name, k_cyc_to_us_floor32((uint32_t)avg),
+           k_cyc_to_us_floor32(p->max), p->count);
+}
+
+static void display_event_cb(lv_event_t *e)
+{
+    switch (lv_event_get_code(e))
+    {
+    case LV_EVENT_REFR_START:
+        phase_start(&refresh);
+        break;
+    case LV_EVENT_REFR_READY:
+        phase_end(&refresh);
+        break;
+    case LV_EVENT_RENDER_START:
+        phase_start(&render);
+        break;
+    case LV_EVENT_RENDER_READY:
+        phase_end(&render);
+        break;
+    case LV_EVENT_FLUSH_WAIT_START:
+        phase_start(&flush_wait);
+        break;
+    case LV_EVENT_FLUSH_WAIT_FINISH:
+        phase_end(&flush_wait);
+        break;
+    default:
+        break;
+    }
+}
+
+struct scene
+{
+    lv_obj_t *arc;
+    lv_obj_t *bar;
+    lv_obj_t *slider;
+    lv_obj_t *label;
+    lv_obj_t *sw;
+    lv_obj_t *chart;
+    lv_chart_series_t *series;
+};
+
+// The "standard" scene: a typical watch face worth of widgets, most of which
+// change every frame so each refresh has several small dirty areas
+static void scene_create(struct scene *s)
+{
+    lv_obj_t *screen = lv_screen_active();
+
+    s->arc = lv_arc_create(screen);
+    lv_obj_set_size(s->arc, 120, 120);
+    lv_obj_align(s->arc, LV_ALIGN_TOP_LEFT, 4, 4);
+    lv_arc_set_range(s->arc, 0, 100);
+
+    s->label = lv_label_create(screen);
+    lv_obj_set_style_text_font(s->label, &lv_font_montserrat_28, 0);
+    lv_obj_align(s->label, LV_ALIGN_TOP_RIGHT, -8, 20);
+
+    s->sw = lv_switch_create(screen);
+    lv_obj_align(s->sw, LV_ALIGN_TOP_RIGHT, -8, 80);
+
+    s->bar = lv_bar_create(screen);
+    lv_obj_set_size(s->bar, 220, 12);
+    lv_obj_align(s->bar, LV_ALIGN_TOP_MID, 0, 132);
+
+    s->slider = lv_slider_create(screen);
+    lv_obj_set_width(s->slider, 200);
+    lv_obj_align(s->slider, LV_ALIGN_TOP_MID, 0, 156);
+
+    s->chart = lv_chart_create(screen);
+    lv_obj_set_size(s->chart, 220, 56);
+    lv_obj_align(s->chart, LV_ALIGN_BOTTOM_MID, 0, -4);
+    lv_chart_set_point_count(s->chart, 32);
+    s->series = lv_chart_add_series(s->chart, lv_palette_main(LV_PALETTE_RED), LV_CHART_AXIS_PRIMARY_Y);
+}
+
+static void scene_update(struct scene *s, uint32_t frame)
+{
+    const int32_t v = frame % 100;
+    lv_arc_set_value(s->arc, v);
+    lv_bar_set_value(s->bar, 100 - v, LV_ANIM_OFF);
+    lv_slider_set_value(s->slider, v, LV_ANIM_OFF);
+    lv_label_set_text_fmt(s->label, "%02u:%02u", (frame / 60) % 24, frame % 60);
+    if (frame % 30 == 0)
+    {
+        lv_obj_set_state(s->sw, LV_STATE_CHECKED, (frame / 30) & 1);
+    }
+    lv_chart_set_next_value(s->chart, s->series, (v * 7) % 100);
+}
+
+static void run(const char *name, struct scene *s, bool full_screen)
+{
+    phase_reset(&refresh);
+    phase_reset(&render);
+    phase_reset(&flush_wait);
+
+    const uint32_t start = k_cycle_get_32();
+    for (uint32_t frame = 0; frame < FRAMES; frame++)
+    {
+        scene_update(s, frame);
+        if (full_screen)
+        {
+            lv_obj_invalidate(lv_screen_active());
+        }
+        lv_refr_now(NULL);
+    }
+    const uint32_t elapsed_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+    const uint32_t fps_x100 = (uint32_t)((uint64_t)FRAMES * USEC_PER_SEC * 100 / elapsed_us);
+    printk("%s: %u frames in %u ms, %u.%02u fps\n", name, FRAMES, elapsed_us / 1000, fps_x100 / 100,
+           fps_x100 % 100);
+    phase_print(&refresh, FRAMES);
+    phase_print(&render, FRAMES);
+    phase_print(&flush_wait, FRAMES);
+}
+
+// The bottom line for any flush: pushing pixels straight through the
+// display API, without LVGL in the way
+static void raw_flush(const struct device *display)
+{
+    static uint16_t buf[240 * RAW_LINES];
+    const struct display_buffer_descriptor desc = {
+        .buf_size = sizeof(buf),
+        .width = 240,
+        .height = RAW_LINES,
+        .pitch = 240,
+    };
+
+    const uint32_t start = k_cycle_get_32();
+    for (uint16_t y = 0; y < 240; y += RAW_LINES)
+    {
+        display_write(display, 0, y, &desc, buf);
+    }
+    const uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+    const uint32_t kbps = (uint32_t)((uint64_t)240 * 240 * 2 * 1000 / us);
+    printk("raw flush: full frame in %u us (%u kB/s)\n", us, kbps);
+}
+
+int main(void)
+{
+    const struct device *display = DEVICE_DT_GET(DT_CHOSEN(zephyr_display));
+    if (!device_is_ready(display))
+    {
+        printk("Display not ready\n");
+        return 0;
+    }
+
+    raw_flush(display);
+
+    lv_display_t *disp = lv_display_get_default();
+    lv_display_add_event_cb(disp, display_event_cb, LV_EVENT_ALL, NULL);
+
+    static struct scene scene;
+    scene_create(&scene);
+    lv_refr_now(NULL);
+    display_blanking_off(display);
+
+    run("widgets", &scene, false);
+    run("full screen", &scene, true);
+
+    printk("lvgl_benchmark done\n");
+    return 0;
+}
@@ -0,0 +1,122 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "latency.h"
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/sys/math_extras.h>
+
+// Bin i counts latencies below 2^i us, the last one everything above
+#define LATENCY_BINS 18
+
+enum latency_stage
+{
+    STAGE_IRQ_TO_REPORT,
+    STAGE_REPORT_TO_INPUT,
+    STAGE_INPUT_TO_APP,
+    STAGE_APP_TO_FLUSH,
+    STAGE_FLUSH_TO_DONE,
+    STAGE_TOTAL,
+    STAGE_COUNT,
+};
+
+static const char *const stage_names[STAGE_COUNT] = {
+    [STAGE_IRQ_TO_REPORT] = "irq -> report",
+    [STAGE_REPORT_TO_INPUT] = "report -> input",
+    [STAGE_INPUT_TO_APP] = "input -> app",
+    [STAGE_APP_TO_FLUSH] = "app -> flush",
+    [STAGE_FLUSH_TO_DONE] = "flush -> done",
+    [STAGE_TOTAL] = "irq -> done",
+};
+
+struct latency_histogram
+{
+    uint32_t count;
+    uint64_t total_us;
+    uint32_t max_us;
+    uint32_t bins[LATENCY_BINS];
+};
+
+static struct k_spinlock lock;
+static struct latency_histogram histograms[STAGE_COUNT];
+
+static void histogram_add(struct latency_histogram *h, uint32_t from, uint32_t to)
+{
+    const uint32_t us = k_cyc_to_us_floor32(to - from);
+    // 0 us lands in bin 0 along with everything below 1 us
+    const uint32_t bin = us == 0 ? 0 : 32 - u32_count_leading_zeros(us);
+
+    h->count++;
+    h->total_us += us;
+    h->max_us = MAX(h->max_us, us);
+    h->bins[MIN(bin, LATENCY_BINS - 1)]++;
+}
+
+void latency_record(const struct latency_probe *probe)
+{
+    K_SPINLOCK(&lock)
+    {
+        histogram_add(&histograms[STAGE_IRQ_TO_REPORT], probe->irq, probe->report);
+        histogram_add(&histograms[STAGE_REPORT_TO_INPUT], probe->report, probe->input);
+        histogram_add(&histograms[STAGE_INPUT_TO_APP], probe->input, probe->app);
+        histogram_add(&histograms[STAGE_APP_TO_FLUSH], probe->app, probe->flush);
+        histogram_add(&histograms[STAGE_FLUSH_TO_DONE], probe->flush, probe->done);
+        histogram_add(&histograms[STAGE_TOTAL], probe->irq, probe->done);
+    }
+}
+
+static int cmd_touch_latency_stats(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    static struct latency_histogram copy[STAGE_COUNT];
+    K_SPINLOCK(&lock)
+    {
+        memcpy(copy, histograms, sizeof(copy));
+    }
+
+    for (size_t stage = 0; stage < STAGE_COUNT; stage++)
+    {
+        const struct latency_histogram *h = &copy[stage];
+        const uint32_t avg = h->count ? (uint32_t)(h->total_us / h->count) : 0;
+        shell_print(sh, "%s: %u samples, avg %u us, max %u us", stage_names[stage], h->count, avg, h->max_us);
+        for (size_t i = 0; i < LATENCY_BINS; i++)
+        {
+            if (h->bins[i] == 0)
+            {
+                continue;
+            }
+            const bool overflow = i == LATENCY_BINS - 1;
+            shell_print(sh, "  %s %6u us: %u", overflow ? ">=" : "< ", (unsigned int)(overflow ? BIT(i - 1) : BIT(i)),
+                        h->bins[i]);
+        }
+    }
+    return 0;
+}
+
+static int cmd_touch_latency_reset(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(sh);
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    K_SPINLOCK(&lock)
+    {
+        memset(histograms, 0, sizeof(histograms));
+    }
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(touch_latency_cmds,
+                               SHELL_CMD(stats, NULL, "Show touch to photon latency histograms",
+                                         cmd_touch_latency_stats),
+                               SHELL_CMD(reset, NULL, "Reset touch to photon latency histograms",
+                                         cmd_touch_latency_reset),
+                               SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(touch_latency, &touch_latency_cmds, "Touch to photon latency", NULL);
@@ -0,0 +1,24 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef TOUCH_LATENCY_H
+#define TOUCH_LATENCY_H
+
+#include <stdint.h>
+
+// One touch report followed from the interrupt to the panel, in
+// k_cycle_get_32() cycles
+struct latency_probe
+{
+    uint32_t irq;
+    uint32_t report;
+    uint32_t input;
+    uint32_t app;
+    uint32_t flush;
+    uint32_t done;
+};
+
+void latency_record(const struct latency_probe *probe);
+
+#endif // TOUCH_LATENCY_H
@@ -0,0 +1,183 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "latency.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/drivers/display.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/input/input.h>
+#include <lvgl.h>
+
+#define TOUCH_NODE DT_ALIAS(touch)
+#define FILTER_NODE DT_NODELABEL(touch_filter)
+#define MARKER_SIZE 24
+
+static const struct gpio_dt_spec touch_int = GPIO_DT_SPEC_GET(TOUCH_NODE, int_gpios);
+static struct gpio_callback touch_int_cb;
+
+// Stamped in the order a report travels. The interrupt and the two input
+// callbacks run ahead of LVGL, so each keeps only the latest report; the
+// probe takes the latest one LVGL acts on and follows it to the panel.
+static atomic_t irq_at;
+static atomic_t report_irq_at;
+static atomic_t report_at;
+
+static struct k_spinlock candidate_lock;
+static struct latency_probe candidate;
+static bool candidate_valid;
+
+// owned by the LVGL thread
+static struct latency_probe probe;
+static bool probe_active;
+static bool probe_flushing;
+static bool probe_last_area;
+
+static lv_obj_t *marker;
+
+static void touch_int_handler(const struct device *port, struct gpio_callback *cb, gpio_port_pins_t pins)
+{
+    ARG_UNUSED(port);
+    ARG_UNUSED(cb);
+    ARG_UNUSED(pins);
+    atomic_set(&irq_at, k_cycle_get_32());
+}
+
+// The controller's report, once the driver has read it over I2C
+static void touch_report_cb(struct input_event *evt, void *user_data)
+{
+    ARG_UNUSED(user_data);
+    if (evt->sync)
+    {
+        atomic_set(&report_irq_at, atomic_get(&irq_at));
+        atomic_set(&report_at, k_cycle_get_32());
+    }
+}
+INPUT_CALLBACK_DEFINE(DEVICE_DT_GET(TOUCH_NODE), touch_report_cb, NULL);
+
+// The same report as the LVGL pointer gets it, out of the touch filter
+static void touch_input_cb(struct input_event *evt, void *user_data)
+{
+    ARG_UNUSED(user_data);
+    if (!evt->sync || (evt->type == INPUT_EV_KEY && evt->code != INPUT_BTN_TOUCH))
+    {
+        // gestures do not move the pointer
+        return;
+    }
+
+    K_SPINLOCK(&candidate_lock)
+    {
+        candidate.irq = atomic_get(&report_irq_at);
+        candidate.report = atomic_get(&report_at);
+        candidate.input = k_cycle_get_32();
+        candidate_valid = true;
+    }
+}
+INPUT_CALLBACK_DEFINE(DEVICE_DT_GET(FILTER_NODE), touch_input_cb, NULL);
+
+static void screen_event_cb(lv_event_t *e)
+{
+    ARG_UNUSED(e);
+    const uint32_t now = k_cycle_get_32();
+
+    lv_point_t point;
+    lv_indev_get_point(lv_indev_active(), &point);
+    const int32_t x = point.x - MARKER_SIZE / 2;
+    const int32_t y = point.y - MARKER_SIZE / 2;
+    if (x == lv_obj_get_x(marker) && y == lv_obj_get_y(marker))
+    {
+        // nothing to redraw, so nothing to follow to the panel
+        return;
+    }
+    lv_obj_set_pos(marker, x, y);
+
+    if (probe_active)
+    {
+        return;
+    }
+    K_SPINLOCK(&candidate_lock)
+    {
+        // LVGL repeats PRESSING while the finger is down, report or not
+        if (candidate_valid)
+        {
+            probe = candidate;
+            probe.app = now;
+            probe_active = true;
+            candidate_valid = false;
+        }
+    }
+}
+
+static void display_event_cb(lv_event_t *e)
+{
+    if (!probe_active)
+    {
+        return;
+    }
+
+    switch (lv_event_get_code(e))
+    {
+    case LV_EVENT_FLUSH_START:
+        if (!probe_flushing)
+        {
+            probe.flush = k_cycle_get_32();
+            probe_flushing = true;
+        }
+        // flush_is_last is cleared by lv_display_flush_ready()
+        probe_last_area = lv_display_flush_is_last(lv_event_get_target(e));
+        break;
+    case LV_EVENT_FLUSH_FINISH:
+        // without the flush thread, flush_cb has returned from display_write()
+        if (probe_last_area)
+        {
+            probe.done = k_cycle_get_32();
+            latency_record(&probe);
+            probe_active = false;
+            probe_flushing = false;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+int main(void)
+{
+    const struct device *display = DEVICE_DT_GET(DT_CHOSEN(zephyr_display));
+    if (!device_is_ready(display) || !gpio_is_ready_dt(&touch_int))
+    {
+        printk("Display or touch not ready\n");
+        return 0;
+    }
+
+    // alongside the FT6336 driver's own callback, which set the pin up
+    gpio_init_callback(&touch_int_cb, touch_int_handler, BIT(touch_int.pin));
+    gpio_add_callback(touch_int.port, &touch_int_cb);
+
+    lv_obj_t *screen = lv_screen_active();
+    lv_obj_set_style_bg_color(screen, lv_color_black(), 0);
+    lv_obj_remove_flag(screen, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_event_cb(screen, screen_event_cb, LV_EVENT_PRESSED, NULL);
+    lv_obj_add_event_cb(screen, screen_event_cb, LV_EVENT_PRESSING, NULL);
+
+    marker = lv_obj_create(screen);
+    lv_obj_set_size(marker, MARKER_SIZE, MARKER_SIZE);
+    lv_obj_set_style_bg_color(marker, lv_color_white(), 0);
+    lv_obj_remove_flag(marker, LV_OBJ_FLAG_CLICKABLE);
+
+    lv_obj_t *label = lv_label_create(screen);
+    lv_label_set_text(label, "touch anywhere\n'touch_latency stats' in the shell");
+    lv_obj_align(label, LV_ALIGN_BOTTOM_MID, 0, -8);
+
+    lv_display_add_event_cb(lv_display_get_default(), display_event_cb, LV_EVENT_ALL, NULL);
+    lv_refr_now(NULL);
+    display_blanking_off(display);
+
+    while (true)
+    {
+        k_msleep(MIN(lv_timer_handler(), INT32_MAX));
+    }
+    return 0;
+}
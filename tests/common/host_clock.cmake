@@ -0,0 +1,11 @@
+# Copyright (c) 2025, Noah Luskey <noah@vvvvvvvvvv.io>
+# SPDX-License-Identifier: Apache-2.0
+
+# test_host_ns() and the bench_*() timing macros (host_clock.h) for
+# benchmarks. Simulated time stands still while the CPU is busy, so on
+# native_sim they read the host's clock, built on the host side of the
+# simulator.
+target_include_directories(app PRIVATE ${CMAKE_CURRENT_LIST_DIR})
+if(CONFIG_ARCH_POSIX)
+  target_sources(native_simulator INTERFACE ${CMAKE_CURRENT_LIST_DIR}/host_clock.c)
+endif()
@@ -0,0 +1,25 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef T_WATCH_S3_TESTS_HOST_CLOCK_H
+#define T_WATCH_S3_TESTS_HOST_CLOCK_H
+
+#include <stdint.h>
+#include <zephyr/kernel.h>
+
+// The host's monotonic clock, on native_sim only: simulated time stands
+// still while the CPU is busy, so benchmarks time themselves with this
+uint64_t test_host_ns(void);
+
+// Benchmark timing, in ns: the host's clock on native_sim, the cycle
+// counter on the watch
+#ifdef CONFIG_ARCH_POSIX
+#define bench_start()           test_host_ns()
+#define bench_elapsed_ns(start) (test_host_ns() - (start))
+#else
+#define bench_start()           k_cycle_get_32()
+#define bench_elapsed_ns(start) k_cyc_to_ns_floor64(k_cycle_get_32() - (uint32_t)(start))
+#endif
+
+#endif // T_WATCH_S3_TESTS_HOST_CLOCK_H
@@ -0,0 +1,275 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/drivers/sensor/bma423.h>
+#include <zephyr/sys/byteorder.h>
+
+#include "bma423.h"
+#include <host_clock.h>
+
+#define FRAMES BMA423_FIFO_MAX_FRAMES
+#define PERIOD_100HZ 10000000U
+#define TIMESTAMP 1000000000ULL
+#define BENCH_ROUNDS 20000
+
+// 9.80665 * 2^16: one 12-bit LSB in q31 at a shift of 5 + range
+#define Q31_PER_LSB (16 * 40168)
+
+static uint8_t buffer[sizeof(struct bma423_encoded_data) + FRAMES * BMA423_FRAME_SIZE] __aligned(8);
+static struct bma423_encoded_data *const edata = (struct bma423_encoded_data *)buffer;
+
+static struct
+{
+    struct sensor_three_axis_data data;
+    struct sensor_three_axis_sample_data more[FRAMES - 1];
+} out;
+
+static const struct sensor_decoder_api *decoder;
+static const struct sensor_chan_spec xyz = {.chan_type = SENSOR_CHAN_ACCEL_XYZ, .chan_idx = 0};
+
+
+// The straightforward way: shift the 12 bits down, then sign extend with
+// a branch per axis. Reference for both the values and the speed.
+static int16_t reference_axis(const uint8_t *raw)
+{
+    const uint16_t value = sys_get_le16(raw) >> 4;
+    return (value & 0x800) ? (int16_t)(value | 0xF000) : (int16_t)value;
+}
+
+static void reference_decode(const uint8_t *frame, uint16_t count, struct sensor_three_axis_sample_data *readings)
+{
+    for (uint16_t i = 0; i < count; i++, frame += BMA423_FRAME_SIZE)
+    {
+        readings[i].timestamp_delta = i * PERIOD_100HZ;
+        readings[i].x = reference_axis(&frame[0]) * Q31_PER_LSB;
+        readings[i].y = reference_axis(&frame[2]) * Q31_PER_LSB;
+        readings[i].z = reference_axis(&frame[4]) * Q31_PER_LSB;
+    }
+}
+
+static void put_axis(uint8_t *raw, int16_t value, uint8_t junk)
+{
+    // the reading goes in the top 12 bits, the bottom 4 are undefined
+    sys_put_le16(((uint16_t)value << 4) | (junk & 0xF), raw);
+}
+
+static void fill(uint16_t frame_count, uint32_t seed)
+{
+    edata->timestamp = TIMESTAMP;
+    edata->period_ns = PERIOD_100HZ;
+    edata->frame_count = frame_count;
+    edata->range = 1;
+    edata->has_steps = 0;
+    edata->steps = 0;
+    edata->events = BMA423_EVENT_FIFO_WATERMARK;
+
+    for (size_t i = 0; i < frame_count * 3; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        put_axis(&edata->frames[i * 2], (int16_t)(seed >> 16) >> 4, seed);
+    }
+}
+
+static void *setup(void)
+{
+    zassert_ok(bma423_get_decoder(NULL, &decoder));
+    return NULL;
+}
+
+ZTEST(bma423_decoder, test_sign_extension)
+{
+    // every 12-bit value, three to a frame
+    int16_t value = -2048;
+    while (value < 2048)
+    {
+        fill(FRAMES, 0);
+        uint16_t axes = 0;
+        for (; axes < FRAMES * 3 && value < 2048; axes++, value++)
+        {
+            put_axis(&edata->frames[axes * 2], value, axes);
+        }
+
+        uint32_t fit = 0;
+        zassert_equal(decoder->decode(buffer, xyz, &fit, FRAMES, &out), FRAMES);
+        zassert_equal(out.data.shift, 6);
+
+        const q31_t *decoded = &out.data.readings[0].x;
+        for (uint16_t i = 0; i < axes; i++)
+        {
+            // readings are {timestamp_delta, x, y, z}
+            const q31_t got = decoded[(i / 3) * 4 + (i % 3)];
+            const int16_t expected = value - axes + i;
+            zassert_equal(got, expected * Q31_PER_LSB, "%d decoded as %d", expected, got);
+        }
+    }
+}
+
+ZTEST(bma423_decoder, test_batches)
+{
+    static struct sensor_three_axis_sample_data expected[FRAMES];
+    fill(FRAMES, 42);
+    reference_decode(edata->frames, FRAMES, expected);
+
+    uint16_t frame_count;
+    zassert_ok(decoder->get_frame_count(buffer, xyz, &frame_count));
+    zassert_equal(frame_count, FRAMES);
+
+    // odd and even batch sizes, so batches start on odd frames too
+    const uint16_t batch_sizes[] = {1, 2, 3, 7, 64, FRAMES};
+    for (size_t b = 0; b < ARRAY_SIZE(batch_sizes); b++)
+    {
+        uint32_t fit = 0;
+        while (fit < FRAMES)
+        {
+            const uint32_t first = fit;
+            const int count = decoder->decode(buffer, xyz, &fit, batch_sizes[b], &out);
+            zassert_equal(count, MIN(batch_sizes[b], FRAMES - first));
+            zassert_equal(fit, first + count);
+            zassert_equal(out.data.header.reading_count, count);
+
+            // the newest frame carries the buffer's timestamp
+            zassert_equal(out.data.header.base_timestamp_ns,
+                          TIMESTAMP - (uint64_t)(FRAMES - 1 - first) * PERIOD_100HZ);
+
+            for (int i = 0; i < count; i++)
+            {
+                const struct sensor_three_axis_sample_data *got = &out.data.readings[i];
+                zassert_equal(got->timestamp_delta, expected[i].timestamp_delta);
+                zassert_equal(got->x, expected[first + i].x, "frame %u", first + i);
+                zassert_equal(got->y, expected[first + i].y, "frame %u", first + i);
+                zassert_equal(got->z, expected[first + i].z, "frame %u", first + i);
+            }
+        }
+
+        zassert_equal(decoder->decode(buffer, xyz, &fit, batch_sizes[b], &out), 0, "Nothing left");
+    }
+}
+
+ZTEST(bma423_decoder, test_single_axis)
+{
+    static struct sensor_three_axis_sample_data expected[FRAMES];
+    static struct
+    {
+        struct sensor_q31_data data;
+        struct sensor_q31_sample_data more[FRAMES - 1];
+    } axis_out;
+
+    fill(FRAMES, 7);
+    reference_decode(edata->frames, FRAMES, expected);
+
+    const enum sensor_channel channels[] = {SENSOR_CHAN_ACCEL_X, SENSOR_CHAN_ACCEL_Y, SENSOR_CHAN_ACCEL_Z};
+    for (size_t c = 0; c < ARRAY_SIZE(channels); c++)
+    {
+        const struct sensor_chan_spec spec = {.chan_type = channels[c], .chan_idx = 0};
+        uint32_t fit = 0;
+        zassert_equal(decoder->decode(buffer, spec, &fit, FRAMES, &axis_out), FRAMES);
+
+        for (int i = 0; i < FRAMES; i++)
+        {
+            const q31_t want = c == 0 ? expected[i].x : c == 1 ? expected[i].y : expected[i].z;
+            zassert_equal(axis_out.data.readings[i].value, want, "axis %zu frame %d", c, i);
+        }
+    }
+}
+
+ZTEST(bma423_decoder, test_timestamp_span)
+{
+    // at 12.5 Hz, 32-bit nanosecond deltas run out after 53 frames
+    fill(FRAMES, 3);
+    edata->period_ns = 80000000;
+
+    uint32_t fit = 0;
+    const int count = decoder->decode(buffer, xyz, &fit, FRAMES, &out);
+    zassert_true(count > 0 && count < FRAMES);
+    zassert_true((uint64_t)(count - 1) * edata->period_ns <= UINT32_MAX);
+}
+
+ZTEST(bma423_decoder, test_triggers)
+{
+    fill(1, 0);
+    zassert_true(decoder->has_trigger(buffer, SENSOR_TRIG_FIFO_WATERMARK));
+    zassert_false(decoder->has_trigger(buffer, SENSOR_TRIG_FIFO_FULL));
+    zassert_false(decoder->has_trigger(buffer, SENSOR_TRIG_DATA_READY));
+}
+
+// INT_STATUS_0 and INT1_MAP, as in the datasheet: the trigger handlers
+// and motion wake are only as right as these
+ZTEST(bma423_decoder, test_feature_int_bits)
+{
+    zassert_equal(BMA423_FEATURE_INT_SINGLE_TAP, 0x01);
+    zassert_equal(BMA423_FEATURE_INT_STEP, 0x02);
+    zassert_equal(BMA423_FEATURE_INT_ACTIVITY, 0x04);
+    zassert_equal(BMA423_FEATURE_INT_WRIST_WEAR, 0x08);
+    zassert_equal(BMA423_FEATURE_INT_DOUBLE_TAP, 0x10);
+    zassert_equal(BMA423_FEATURE_INT_ANY_MOTION, 0x20);
+    zassert_equal(BMA423_FEATURE_INT_NO_MOTION, 0x40);
+    zassert_equal(BMA423_FEATURE_INT_ERROR, 0x80);
+}
+
+ZTEST(bma423_decoder, test_steps)
+{
+    const struct sensor_chan_spec steps = {.chan_type = (enum sensor_channel)SENSOR_CHAN_BMA423_STEPS, .chan_idx = 0};
+    struct sensor_q31_data steps_out;
+    uint16_t frame_count;
+    uint32_t fit = 0;
+
+    // a step count read on its own carries no frames
+    fill(0, 0);
+    zassert_equal(decoder->get_frame_count(buffer, steps, &frame_count), -ENODATA);
+    zassert_equal(decoder->decode(buffer, steps, &fit, 1, &steps_out), 0);
+
+    edata->has_steps = 1;
+    edata->steps = 123456;
+    zassert_ok(decoder->get_frame_count(buffer, steps, &frame_count));
+    zassert_equal(frame_count, 1);
+    zassert_ok(decoder->get_frame_count(buffer, xyz, &frame_count));
+    zassert_equal(frame_count, 0);
+
+    size_t base_size;
+    size_t frame_size;
+    zassert_ok(decoder->get_size_info(steps, &base_size, &frame_size));
+    zassert_equal(base_size, sizeof(struct sensor_q31_data));
+
+    zassert_equal(decoder->decode(buffer, steps, &fit, 1, &steps_out), 1);
+    zassert_equal(fit, 1);
+    zassert_equal(steps_out.shift, 31);
+    zassert_equal(steps_out.readings[0].value, 123456);
+    zassert_equal(steps_out.header.base_timestamp_ns, TIMESTAMP);
+    zassert_equal(decoder->decode(buffer, steps, &fit, 1, &steps_out), 0, "Nothing left");
+}
+
+// Decodes a full FIFO drain over and over, and prints the cost per frame
+// for the driver's decoder and for the scalar reference
+ZTEST(bma423_decoder, test_decode_throughput)
+{
+    fill(FRAMES, 1);
+
+    uint64_t start = bench_start();
+    for (int round = 0; round < BENCH_ROUNDS; round++)
+    {
+        uint32_t fit = 0;
+        decoder->decode(buffer, xyz, &fit, FRAMES, &out);
+        compiler_barrier();
+    }
+    const uint64_t batched_ns = bench_elapsed_ns(start);
+
+    start = bench_start();
+    for (int round = 0; round < BENCH_ROUNDS; round++)
+    {
+        reference_decode(edata->frames, FRAMES, out.data.readings);
+        compiler_barrier();
+    }
+    const uint64_t reference_ns = bench_elapsed_ns(start);
+
+    const uint64_t frames = (uint64_t)BENCH_ROUNDS * FRAMES;
+    TC_PRINT("decode_ps_per_frame batched=%u reference=%u frames=%u\n", (uint32_t)(batched_ns * 1000 / frames),
+             (uint32_t)(reference_ns * 1000 / frames), (uint32_t)frames);
+    TC_PRINT("decode_frames_per_s batched=%u reference=%u\n",
+             (uint32_t)(frames * NSEC_PER_SEC / MAX(batched_ns, 1)),
+             (uint32_t)(frames * NSEC_PER_SEC / MAX(reference_ns, 1)));
+}
+
+ZTEST_SUITE(bma423_decoder, NULL, setup, NULL, NULL, NULL);
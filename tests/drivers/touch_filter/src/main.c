@@ -0,0 +1,203 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <zephyr/ztest.h>
+#include <zephyr/input/input.h>
+#include <t_watch_s3/touch_filter.h>
+#include <host_clock.h>
+
+#define FAKE_NODE DT_NODELABEL(fake_touch)
+#define FILTER_NODE DT_NODELABEL(touch_filter)
+
+// The controller's report rate while a finger moves
+#define REPORT_MS 10
+
+DEVICE_DT_DEFINE(FAKE_NODE, NULL, NULL, NULL, NULL, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_DEVICE, NULL);
+
+static const struct device *const fake = DEVICE_DT_GET(FAKE_NODE);
+static const struct device *const filter = DEVICE_DT_GET(FILTER_NODE);
+
+static struct
+{
+    uint32_t positions;
+    uint32_t presses;
+    uint32_t releases;
+    uint32_t gestures[TOUCH_GESTURE_COUNT];
+    int32_t x;
+    int32_t y;
+} seen;
+
+static void on_filtered(struct input_event *evt, void *user_data)
+{
+    ARG_UNUSED(user_data);
+    if (evt->type == INPUT_EV_ABS && evt->code == INPUT_ABS_X)
+    {
+        seen.x = evt->value;
+    }
+    else if (evt->type == INPUT_EV_ABS && evt->code == INPUT_ABS_Y)
+    {
+        seen.y = evt->value;
+        seen.positions++;
+    }
+    else if (evt->type == INPUT_EV_KEY && evt->code == INPUT_BTN_TOUCH)
+    {
+        if (evt->value)
+        {
+            seen.presses++;
+        }
+        else
+        {
+            seen.releases++;
+        }
+    }
+    else if (evt->type == INPUT_EV_KEY && evt->value)
+    {
+        const int gesture = evt->code - TOUCH_GESTURE_INPUT_CODE(0);
+        zassert_true(gesture >= 0 && gesture < TOUCH_GESTURE_COUNT, "Unexpected code %u", evt->code);
+        seen.gestures[gesture]++;
+    }
+}
+INPUT_CALLBACK_DEFINE(DEVICE_DT_GET(FILTER_NODE), on_filtered, NULL);
+
+// What the FT6336 driver reports for every position while touched
+static void report(int32_t x, int32_t y)
+{
+    input_report_abs(fake, INPUT_ABS_X, x, false, K_FOREVER);
+    input_report_abs(fake, INPUT_ABS_Y, y, false, K_FOREVER);
+    input_report_key(fake, INPUT_BTN_TOUCH, 1, true, K_FOREVER);
+}
+
+static void release(void)
+{
+    input_report_key(fake, INPUT_BTN_TOUCH, 0, true, K_FOREVER);
+}
+
+ZTEST(touch_filter, test_tap)
+{
+    report(100, 100);
+    k_msleep(REPORT_MS);
+    report(102, 99);
+    k_msleep(REPORT_MS);
+    release();
+
+    zassert_equal(seen.presses, 1);
+    zassert_equal(seen.releases, 1);
+    zassert_equal(seen.gestures[TOUCH_GESTURE_TAP], 1);
+    zassert_equal(seen.x, 102);
+    zassert_equal(seen.y, 99);
+}
+
+ZTEST(touch_filter, test_long_press_without_repeats)
+{
+    // a still finger, reported over and over
+    for (int i = 0; i < 60; i++)
+    {
+        report(50, 60);
+        k_msleep(REPORT_MS);
+    }
+    release();
+
+    zassert_equal(seen.presses, 1, "Presses should not repeat");
+    zassert_equal(seen.positions, 1, "An unchanged position should not repeat");
+    zassert_equal(seen.gestures[TOUCH_GESTURE_LONG_PRESS], 1);
+    zassert_equal(seen.gestures[TOUCH_GESTURE_TAP], 0, "A long press is not also a tap");
+
+    struct touch_filter_stats stats;
+    touch_filter_stats_get(filter, &stats);
+    zassert_equal(stats.duplicates, 59);
+}
+
+ZTEST(touch_filter, test_rate_limit)
+{
+    // a controller reporting every 2ms, moving a pixel at a time
+    for (int i = 0; i < 50; i++)
+    {
+        report(10 + i, 10);
+        k_msleep(2);
+    }
+    release();
+
+    // one position per report interval, plus the press and the release's
+    zassert_between_inclusive(seen.positions, 100 / DT_PROP(FILTER_NODE, report_interval_ms),
+                              100 / DT_PROP(FILTER_NODE, report_interval_ms) + 2);
+    zassert_equal(seen.x, 59, "The last position should be reported on release");
+    zassert_equal(seen.gestures[TOUCH_GESTURE_SWIPE_RIGHT], 1);
+}
+
+ZTEST(touch_filter, test_swipe_directions)
+{
+    const struct
+    {
+        int32_t dx;
+        int32_t dy;
+        enum touch_gesture gesture;
+    } swipes[] = {
+        {0, -8, TOUCH_GESTURE_SWIPE_UP},
+        {0, 8, TOUCH_GESTURE_SWIPE_DOWN},
+        {-8, 1, TOUCH_GESTURE_SWIPE_LEFT},
+        {8, -1, TOUCH_GESTURE_SWIPE_RIGHT},
+    };
+
+    for (size_t s = 0; s < ARRAY_SIZE(swipes); s++)
+    {
+        for (int i = 0; i < 20; i++)
+        {
+            report(120 + swipes[s].dx * i, 120 + swipes[s].dy * i);
+            k_msleep(REPORT_MS);
+        }
+        release();
+        zassert_equal(seen.gestures[swipes[s].gesture], 1, "swipe %zu", s);
+    }
+
+    // too slow for a swipe: a drag
+    for (int i = 0; i < 100; i++)
+    {
+        report(120, 120 + i * 2);
+        k_msleep(REPORT_MS);
+    }
+    release();
+    zassert_equal(seen.gestures[TOUCH_GESTURE_SWIPE_DOWN], 1);
+}
+
+// A standard swipe: 300ms across 240px at the controller's 100Hz, printed as
+// touch_filter_swipe events_in=... events_out=... reports_in=... reports_out=... ns=...
+// where ns is the time spent reporting the swipe through the filter
+ZTEST(touch_filter, test_standard_swipe)
+{
+    const int reports = 300 / REPORT_MS;
+    uint64_t elapsed = 0;
+
+    for (int i = 0; i < reports; i++)
+    {
+        const uint64_t start = bench_start();
+        report(0, i * 240 / (reports - 1));
+        elapsed += bench_elapsed_ns(start);
+        k_msleep(REPORT_MS);
+    }
+    const uint64_t start = bench_start();
+    release();
+    elapsed += bench_elapsed_ns(start);
+
+    struct touch_filter_stats stats;
+    touch_filter_stats_get(filter, &stats);
+    zassert_equal(stats.gestures[TOUCH_GESTURE_SWIPE_DOWN], 1);
+    zassert_equal(stats.events_in, reports * 3 + 1);
+    zassert_equal(stats.reports_in, reports + 1);
+    zassert_equal(stats.dropped, 0);
+    zassert_true(stats.events_out < stats.events_in / 2, "Only %u of %u events filtered out",
+                 stats.events_in - stats.events_out, stats.events_in);
+    zassert_equal(seen.y, 240);
+
+    TC_PRINT("touch_filter_swipe events_in=%u events_out=%u reports_in=%u reports_out=%u ns=%u\n", stats.events_in,
+             stats.events_out, stats.reports_in, stats.reports_out, (uint32_t)elapsed);
+}
+
+static void before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    memset(&seen, 0, sizeof(seen));
+    touch_filter_stats_reset(filter);
+}
+
+ZTEST_SUITE(touch_filter, NULL, NULL, before, NULL, NULL);
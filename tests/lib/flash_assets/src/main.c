@@ -0,0 +1,207 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <zephyr/ztest.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/crc.h>
+#include <t_watch_s3/flash_assets.h>
+#include <host_clock.h>
+
+#include <string.h>
+
+// What a watch face uses: 4 bpp glyphs of a 16 and a 32 px font, a 48 px
+// RGB565 icon and a 240x240 RGB565 background. Sorted by name, as
+// mkassets.py would.
+static const struct
+{
+    const char *name;
+    size_t size;
+} assets[] = {
+    {"face_240", 240 * 240 * 2},
+    {"glyph_16", 8 * 16 / 2 * 2},
+    {"glyph_32", 16 * 32 / 2 * 2},
+    {"icon_48", 48 * 48 * 2},
+};
+
+#define IMAGE_MAX (128 * 1024)
+#define READ_BUF  4096
+
+static uint8_t image_buf[IMAGE_MAX] __aligned(4);
+static uint8_t read_buf[READ_BUF] __aligned(4);
+static size_t image_size;
+static const struct flash_area *area;
+
+static uint8_t asset_byte(size_t asset, size_t i)
+{
+    return (i * 31 + asset * 7) ^ (i >> 8);
+}
+
+// An image laid out like mkassets.py's
+static void build_image(void)
+{
+    struct flash_assets_header *header = (void *)image_buf;
+    struct flash_assets_entry *entries = (void *)&image_buf[sizeof(*header)];
+    size_t offset = sizeof(*header) + ARRAY_SIZE(assets) * sizeof(*entries);
+
+    memset(image_buf, 0xff, sizeof(image_buf));
+    for (size_t a = 0; a < ARRAY_SIZE(assets); a++)
+    {
+        offset = ROUND_UP(offset, 4);
+        zassert_true(offset + assets[a].size <= IMAGE_MAX);
+        for (size_t i = 0; i < assets[a].size; i++)
+        {
+            image_buf[offset + i] = asset_byte(a, i);
+        }
+        memset(&entries[a], 0, sizeof(entries[a]));
+        strncpy(entries[a].name, assets[a].name, sizeof(entries[a].name));
+        entries[a].offset = offset;
+        entries[a].size = assets[a].size;
+        entries[a].crc32 = crc32_ieee(&image_buf[offset], assets[a].size);
+        offset += assets[a].size;
+    }
+
+    *header = (struct flash_assets_header){
+        .magic = FLASH_ASSETS_MAGIC,
+        .version = FLASH_ASSETS_VERSION,
+        .count = ARRAY_SIZE(assets),
+        .size = offset,
+    };
+    header->crc32 = crc32_ieee(image_buf, offsetof(struct flash_assets_header, crc32));
+    header->crc32 = crc32_ieee_update(header->crc32, entries, ARRAY_SIZE(assets) * sizeof(*entries));
+    image_size = offset;
+}
+
+static void write_image(void)
+{
+    const size_t write_block = flash_get_write_block_size(flash_area_get_device(area));
+    zassert_ok(flash_area_erase(area, 0, ROUND_UP(image_size, 4096)));
+    zassert_ok(flash_area_write(area, 0, image_buf, ROUND_UP(image_size, write_block)));
+}
+
+// Flip a byte of the image in flash, as a half finished update would leave it
+static void damage(size_t offset)
+{
+    flash_assets_unmap();
+    image_buf[offset] ^= 0x01;
+    write_image();
+    image_buf[offset] ^= 0x01;
+}
+
+static void *flash_assets_setup(void)
+{
+    zassert_ok(flash_area_open(FIXED_PARTITION_ID(assets_partition), &area));
+    build_image();
+    return NULL;
+}
+
+static void flash_assets_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    flash_assets_unmap();
+    write_image();
+    zassert_ok(flash_assets_init());
+}
+
+ZTEST(flash_assets, test_flash_assets_lookup)
+{
+    for (size_t a = 0; a < ARRAY_SIZE(assets); a++)
+    {
+        struct flash_asset asset;
+        struct flash_asset again;
+        zassert_ok(flash_assets_get(assets[a].name, &asset), "%s is missing", assets[a].name);
+        zassert_equal(asset.size, assets[a].size);
+        zassert_equal((uintptr_t)asset.data % 4, 0);
+        zassert_ok(flash_assets_check(&asset));
+
+        const uint8_t *data = asset.data;
+        for (size_t i = 0; i < asset.size; i++)
+        {
+            zassert_equal(data[i], asset_byte(a, i), "%s differs at %zu", assets[a].name, i);
+        }
+
+        // the same flash every time, nothing copied
+        zassert_ok(flash_assets_get(assets[a].name, &again));
+        zassert_equal_ptr(asset.data, again.data);
+    }
+
+    struct flash_asset asset;
+    zassert_equal(flash_assets_get("glyph", &asset), -ENOENT);
+    zassert_equal(flash_assets_get("glyph_160", &asset), -ENOENT);
+    zassert_equal(flash_assets_get("zzz", &asset), -ENOENT);
+    zassert_equal(flash_assets_get("", &asset), -ENOENT);
+}
+
+ZTEST(flash_assets, test_flash_assets_damaged)
+{
+    struct flash_asset asset;
+    const struct flash_assets_entry *entries = (const void *)&image_buf[sizeof(struct flash_assets_header)];
+
+    // in an asset: found, but it doesn't check out
+    damage(entries[1].offset + 3);
+    zassert_ok(flash_assets_init());
+    zassert_ok(flash_assets_get(assets[1].name, &asset));
+    zassert_equal(flash_assets_check(&asset), -EBADMSG);
+
+    // in the table: nothing is handed out
+    damage(sizeof(struct flash_assets_header) + 2 * sizeof(struct flash_assets_entry) + 1);
+    zassert_equal(flash_assets_init(), -EBADMSG);
+    zassert_equal(flash_assets_get(assets[0].name, &asset), -ENODEV);
+
+    // erased
+    zassert_ok(flash_area_erase(area, 0, 4096));
+    zassert_equal(flash_assets_init(), -ENOENT);
+}
+
+static uint32_t sum(const uint8_t *data, size_t len)
+{
+    uint32_t total = 0;
+    for (size_t i = 0; i < len; i++)
+    {
+        total += data[i];
+    }
+    return total;
+}
+
+// Using each asset (summing its bytes, as a blit would touch them) in
+// place, and after flash_read() into RAM, a buffer at a time, printed as
+// flash_assets_bench asset=... bytes=... mapped_ns=... read_ns=... speedup_permille=...
+ZTEST(flash_assets, test_flash_assets_bench)
+{
+    const struct flash_assets_entry *entries = (const void *)&image_buf[sizeof(struct flash_assets_header)];
+
+    for (size_t a = 0; a < ARRAY_SIZE(assets); a++)
+    {
+        struct flash_asset asset;
+        zassert_ok(flash_assets_get(assets[a].name, &asset));
+        const uint32_t reps = MAX(256 * 1024 / asset.size, 4);
+        uint32_t mapped_sum = 0;
+        uint32_t read_sum = 0;
+
+        uint64_t start = bench_start();
+        for (uint32_t rep = 0; rep < reps; rep++)
+        {
+            mapped_sum += sum(asset.data, asset.size);
+        }
+        const uint64_t mapped_ns = bench_elapsed_ns(start) / reps;
+
+        start = bench_start();
+        for (uint32_t rep = 0; rep < reps; rep++)
+        {
+            for (size_t pos = 0; pos < asset.size; pos += READ_BUF)
+            {
+                const size_t len = MIN(asset.size - pos, READ_BUF);
+                zassert_ok(flash_area_read(area, entries[a].offset + pos, read_buf, len));
+                read_sum += sum(read_buf, len);
+            }
+        }
+        const uint64_t read_ns = bench_elapsed_ns(start) / reps;
+
+        zassert_equal(mapped_sum, read_sum);
+        TC_PRINT("flash_assets_bench asset=%s bytes=%zu mapped_ns=%u read_ns=%u speedup_permille=%u\n",
+                 assets[a].name, asset.size, (uint32_t)mapped_ns, (uint32_t)read_ns,
+                 (uint32_t)(read_ns * 1000 / MAX(mapped_ns, 1)));
+    }
+}
+
+ZTEST_SUITE(flash_assets, NULL, flash_assets_setup, flash_assets_before, NULL, NULL);
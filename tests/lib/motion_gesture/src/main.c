@@ -0,0 +1,270 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <zephyr/ztest.h>
+#include <zephyr/input/input.h>
+#include <t_watch_s3/motion_gesture.h>
+#include <host_clock.h>
+
+#include <math.h>
+
+#define RATE CONFIG_T_WATCH_S3_MOTION_GESTURE_RATE_HZ
+#define SECONDS(s) ((int)((s) * RATE))
+#define PI 3.14159265358979
+
+// Same batch size the stream uses
+#define BATCH 32
+
+struct batch
+{
+    struct sensor_three_axis_data data;
+    struct sensor_three_axis_sample_data more[BATCH - 1];
+};
+
+static struct batch batch;
+
+static int8_t shift;
+static uint32_t noise_seed;
+static uint32_t events[MOTION_GESTURE_COUNT];
+
+static void on_input(struct input_event *evt, void *user_data)
+{
+    ARG_UNUSED(user_data);
+    if (evt->dev != motion_gesture_device() || evt->type != INPUT_EV_KEY || evt->value != 1)
+    {
+        return;
+    }
+    const int gesture = evt->code - MOTION_GESTURE_INPUT_CODE(0);
+    zassert_true(gesture >= 0 && gesture < MOTION_GESTURE_COUNT, "Unexpected code %u", evt->code);
+    events[gesture]++;
+}
+INPUT_CALLBACK_DEFINE(NULL, on_input, NULL);
+
+static void flush(void)
+{
+    if (batch.data.header.reading_count > 0)
+    {
+        motion_gesture_feed(&batch.data);
+        batch.data.header.reading_count = 0;
+    }
+}
+
+// A few mg of noise, as on a watch at rest
+static double noise(void)
+{
+    noise_seed = noise_seed * 1664525 + 1013904223;
+    return ((int32_t)(noise_seed >> 16) - 32768) / 32768.0 * 0.02;
+}
+
+// One sample, in g, encoded the way the BMA423 decoder does it
+static void encode(struct batch *out, double x, double y, double z)
+{
+    const double g[3] = {x + noise(), y + noise(), z + noise()};
+    struct sensor_three_axis_sample_data *sample = &out->data.readings[out->data.header.reading_count++];
+    for (int axis = 0; axis < 3; axis++)
+    {
+        sample->values[axis] = (q31_t)llround(g[axis] * 9.80665 * (double)(1LL << (31 - shift)));
+    }
+    out->data.shift = shift;
+}
+
+static void push(double x, double y, double z)
+{
+    encode(&batch, x, y, z);
+    if (batch.data.header.reading_count == BATCH)
+    {
+        flush();
+    }
+}
+
+// Face up on a table
+static void still(double seconds)
+{
+    for (int n = 0; n < SECONDS(seconds); n++)
+    {
+        push(0, 0, -1);
+    }
+}
+
+// Arm hanging, the screen facing sideways
+static void hanging(double seconds)
+{
+    for (int n = 0; n < SECONDS(seconds); n++)
+    {
+        push(-1, 0, 0);
+    }
+}
+
+// Turn from hanging to face up, at constant angular speed
+static void rotate_up(double seconds)
+{
+    for (int n = 0; n < SECONDS(seconds); n++)
+    {
+        const double angle = PI / 2 * n / SECONDS(seconds);
+        push(-cos(angle), 0, -sin(angle));
+    }
+}
+
+static void tap(void)
+{
+    push(0, 0, -1 + 2.5);
+    push(0, 0, -1 + 1.5);
+}
+
+static void shake(double seconds, double hz, double amplitude)
+{
+    for (int n = 0; n < SECONDS(seconds); n++)
+    {
+        push(amplitude * sin(2 * PI * hz * n / RATE), 0, -1);
+    }
+}
+
+ZTEST(motion_gesture, test_still)
+{
+    still(10);
+    flush();
+    zassert_equal(events[MOTION_GESTURE_WRIST_RAISE], 0);
+    zassert_equal(events[MOTION_GESTURE_SHAKE], 0);
+    zassert_equal(events[MOTION_GESTURE_DOUBLE_TAP], 0);
+
+    struct motion_gesture_stats stats;
+    motion_gesture_stats_get(&stats);
+    zassert_equal(stats.samples, SECONDS(10));
+    zassert_equal(stats.windows, 10);
+}
+
+ZTEST(motion_gesture, test_wrist_raise)
+{
+    // at every range the BMA423 decoder reports
+    for (shift = 5; shift <= 8; shift++)
+    {
+        memset(events, 0, sizeof(events));
+        hanging(2);
+        rotate_up(0.4);
+        still(1);
+        flush();
+        zassert_equal(events[MOTION_GESTURE_WRIST_RAISE], 1, "shift %d", shift);
+
+        // only once until the arm drops again
+        still(2);
+        flush();
+        zassert_equal(events[MOTION_GESTURE_WRIST_RAISE], 1, "shift %d", shift);
+    }
+    zassert_equal(events[MOTION_GESTURE_SHAKE], 0);
+    zassert_equal(events[MOTION_GESTURE_DOUBLE_TAP], 0);
+}
+
+ZTEST(motion_gesture, test_slow_turn_is_not_a_raise)
+{
+    hanging(2);
+    rotate_up(8);
+    still(1);
+    flush();
+    zassert_equal(events[MOTION_GESTURE_WRIST_RAISE], 0);
+}
+
+ZTEST(motion_gesture, test_shake)
+{
+    still(1);
+    shake(1.5, 4, 2);
+    still(1);
+    flush();
+    zassert_equal(events[MOTION_GESTURE_SHAKE], 1);
+    zassert_equal(events[MOTION_GESTURE_DOUBLE_TAP], 0);
+
+    // a gentle sway is not a shake
+    shake(2, 1, 0.5);
+    still(1);
+    flush();
+    zassert_equal(events[MOTION_GESTURE_SHAKE], 1);
+}
+
+ZTEST(motion_gesture, test_double_tap)
+{
+    still(1);
+    tap();
+    still(0.2);
+    tap();
+    still(1);
+    flush();
+    zassert_equal(events[MOTION_GESTURE_DOUBLE_TAP], 1);
+
+    // taps too far apart, or too close together, are not a double tap
+    tap();
+    still(1);
+    tap();
+    still(1);
+    tap();
+    still(0.04);
+    tap();
+    still(1);
+    flush();
+    zassert_equal(events[MOTION_GESTURE_DOUBLE_TAP], 1);
+    zassert_equal(events[MOTION_GESTURE_SHAKE], 0);
+    zassert_equal(events[MOTION_GESTURE_WRIST_RAISE], 0);
+}
+
+// Cost of one window of samples, with gestures going on, printed as
+// motion_gesture_bench window_ns=... sample_ns=... max_window_us=...
+// (max_window_us is the recognizer's own account, from the kernel's cycle
+// counter, which stands still on native_sim)
+ZTEST(motion_gesture, test_cost_per_window)
+{
+    const int rounds = 10;
+    uint64_t elapsed = 0;
+
+    // generated up front, so only the recognizer is timed: hanging, a
+    // raise, then a shake
+    static struct batch batches[DIV_ROUND_UP(SECONDS(6), BATCH)];
+    memset(batches, 0, sizeof(batches));
+    for (int n = 0; n < SECONDS(6); n++)
+    {
+        const double t = (double)n / RATE;
+        struct batch *out = &batches[n / BATCH];
+        if (t < 2)
+        {
+            encode(out, -1, 0, 0);
+        }
+        else if (t > 3 && t < 4.5)
+        {
+            encode(out, 2 * sin(2 * PI * 4 * t), 0, -1);
+        }
+        else
+        {
+            encode(out, 0, 0, -1);
+        }
+    }
+
+    for (int round = 0; round < rounds; round++)
+    {
+        const uint64_t start = bench_start();
+        for (size_t i = 0; i < ARRAY_SIZE(batches); i++)
+        {
+            motion_gesture_feed(&batches[i].data);
+        }
+        elapsed += bench_elapsed_ns(start);
+    }
+
+    struct motion_gesture_stats stats;
+    motion_gesture_stats_get(&stats);
+    zassert_true(stats.windows > 0, "No windows");
+    zassert_equal(stats.events[MOTION_GESTURE_WRIST_RAISE], rounds);
+    zassert_equal(stats.events[MOTION_GESTURE_SHAKE], rounds);
+
+    const uint32_t window = elapsed / stats.windows;
+    TC_PRINT("motion_gesture_bench window_ns=%u sample_ns=%u max_window_us=%u\n", window, window / RATE,
+             stats.max_window_us);
+}
+
+static void before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    motion_gesture_reset();
+    memset(events, 0, sizeof(events));
+    batch.data.header.reading_count = 0;
+    shift = 6;
+    noise_seed = 1;
+}
+
+ZTEST_SUITE(motion_gesture, NULL, NULL, before, NULL, NULL);
@@ -0,0 +1,236 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <zephyr/ztest.h>
+#include <t_watch_s3/series_codec.h>
+#include <host_clock.h>
+
+#include <string.h>
+
+// The largest LoRaWAN payload, at EU868 DR5, which also fits a telemetry
+// log record
+#define BLOCK_SIZE 242
+
+#define ACCEL_HZ        100
+#define ACCEL_SAMPLES   (60 * ACCEL_HZ)
+#define BATTERY_PERIOD  10
+#define BATTERY_SAMPLES (8 * 3600 / BATTERY_PERIOD)
+
+#define T0_MS 1735689600000ULL
+
+static int32_t accel[ACCEL_SAMPLES][3];
+static int32_t battery[BATTERY_SAMPLES][1];
+static uint8_t blocks[ACCEL_SAMPLES * SERIES_CODEC_SAMPLE_MAX(3)];
+
+static uint32_t rng_state;
+
+static int32_t noise(int32_t amplitude)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (int32_t)(rng_state % (2 * amplitude + 1)) - amplitude;
+}
+
+// A minute of the BMA423 at 100 Hz, +-4 g in 12 bit counts (512 per g):
+// the wrist at rest, walking with the arm swinging, then raised to look at
+// the watch. Sines come from a rotating vector rather than libm.
+static void make_accel_trace(void)
+{
+    float c = 1.0f;
+    float s = 0.0f;
+    // 1 Hz arm swing
+    const float cos_w = 0.998026728f;
+    const float sin_w = 0.062790520f;
+
+    rng_state = 0x5eed1;
+    for (int i = 0; i < ACCEL_SAMPLES; i++)
+    {
+        const float next_c = c * cos_w - s * sin_w;
+        s = s * cos_w + c * sin_w;
+        c = next_c;
+
+        const int t = i / ACCEL_HZ;
+        int32_t x = 0;
+        int32_t y = 0;
+        int32_t z = 512;
+        if (t >= 20 && t < 50)
+        {
+            x = (int32_t)(350.0f * s);
+            y = (int32_t)(120.0f * c) - 200;
+            z = 440 + (int32_t)(60.0f * c * s);
+        }
+        else if (t >= 50)
+        {
+            // raised over a second, and held
+            const int32_t ramp = MIN(i - 50 * ACCEL_HZ, ACCEL_HZ);
+            y = -300 * ramp / ACCEL_HZ;
+            z = 512 - 100 * ramp / ACCEL_HZ;
+        }
+        accel[i][0] = x + noise(3);
+        accel[i][1] = y + noise(3);
+        accel[i][2] = z + noise(3);
+    }
+}
+
+// Eight hours of the AXP2101's battery voltage in mV every 10 s: a slow
+// discharge, ADC noise, and the sag of a radio burst now and then
+static void make_battery_trace(void)
+{
+    rng_state = 0xba77;
+    for (int i = 0; i < BATTERY_SAMPLES; i++)
+    {
+        int32_t mv = 4180 - 400 * i / BATTERY_SAMPLES + noise(2);
+        if (i % 90 == 0)
+        {
+            mv -= 40;
+        }
+        battery[i][0] = mv;
+    }
+}
+
+// Code samples into back to back blocks of at most BLOCK_SIZE
+static size_t encode(const int32_t *samples, size_t count, uint8_t channels, uint32_t period_ms)
+{
+    struct series_encoder enc;
+    size_t len = 0;
+    size_t i = 0;
+
+    while (i < count)
+    {
+        zassert_ok(series_encoder_start(&enc, &blocks[len], BLOCK_SIZE, channels, T0_MS + i * period_ms,
+                                        period_ms));
+        while (i < count && series_encoder_add(&enc, &samples[i * channels]) == 0)
+        {
+            i++;
+        }
+        len += series_encoder_finish(&enc);
+    }
+    return len;
+}
+
+// Decode the blocks, and check them against samples
+static void decode(const int32_t *samples, size_t count, uint8_t channels, uint32_t period_ms, size_t len)
+{
+    struct series_decoder dec;
+    int32_t sample[SERIES_CODEC_MAX_CHANNELS];
+    uint64_t timestamp_ms;
+    size_t pos = 0;
+    size_t i = 0;
+
+    while (pos < len)
+    {
+        zassert_ok(series_decoder_start(&dec, &blocks[pos], len - pos));
+        zassert_equal(dec.channels, channels);
+        while (series_decoder_next(&dec, sample, &timestamp_ms) == 0)
+        {
+            zassert_true(i < count);
+            zassert_mem_equal(sample, &samples[i * channels], channels * sizeof(int32_t), "Sample %zu differs",
+                              i);
+            zassert_equal(timestamp_ms, T0_MS + i * period_ms);
+            i++;
+        }
+        zassert_equal(dec.index, dec.count, "Block at %zu cut short", pos);
+        pos += dec.pos;
+    }
+    zassert_equal(i, count);
+}
+
+ZTEST(series_codec, test_series_codec_roundtrip)
+{
+    static const int32_t samples[][2] = {
+        {0, 0}, {INT32_MAX, INT32_MIN}, {INT32_MIN, INT32_MAX}, {-1, 1}, {1, -1}, {63, -64}, {64, -65}, {0, 0},
+    };
+
+    const size_t len = encode(&samples[0][0], ARRAY_SIZE(samples), 2, 1000);
+    decode(&samples[0][0], ARRAY_SIZE(samples), 2, 1000, len);
+
+    // the worst case is what it says
+    zassert_true(len <= SERIES_CODEC_HEADER_MAX + ARRAY_SIZE(samples) * SERIES_CODEC_SAMPLE_MAX(2));
+}
+
+ZTEST(series_codec, test_series_codec_full)
+{
+    uint8_t buf[32];
+    struct series_encoder enc;
+    const int32_t sample[3] = {1000, -1000, 1000};
+
+    zassert_equal(series_encoder_start(&enc, buf, SERIES_CODEC_HEADER_MAX - 1, 3, 0, 10), -ENOSPC);
+    zassert_equal(series_encoder_start(&enc, buf, sizeof(buf), 0, 0, 10), -EINVAL);
+    zassert_equal(series_encoder_start(&enc, buf, sizeof(buf), SERIES_CODEC_MAX_CHANNELS + 1, 0, 10), -EINVAL);
+
+    zassert_ok(series_encoder_start(&enc, buf, sizeof(buf), 3, 0, 10));
+    int added = 0;
+    while (series_encoder_add(&enc, sample) == 0)
+    {
+        added++;
+    }
+    const size_t len = enc.len;
+    zassert_equal(series_encoder_add(&enc, sample), -ENOSPC);
+    zassert_equal(enc.len, len, "A sample that didn't fit should leave the block alone");
+    zassert_true(len <= sizeof(buf));
+    zassert_true(added > 0);
+
+    struct series_decoder dec;
+    zassert_equal(series_encoder_finish(&enc), len);
+    zassert_ok(series_decoder_start(&dec, buf, len));
+    zassert_equal(dec.count, added);
+}
+
+ZTEST(series_codec, test_series_codec_damaged)
+{
+    static const int32_t samples[][3] = {{512, -3, 7}, {-400, 300, 2000}, {0, 0, 0}, {-2048, 2047, 1}};
+    struct series_decoder dec;
+    int32_t sample[3];
+
+    const size_t len = encode(&samples[0][0], ARRAY_SIZE(samples), 3, 10);
+
+    // cut short anywhere, it is noticed rather than read past the end
+    for (size_t cut = 0; cut < len; cut++)
+    {
+        int ret = series_decoder_start(&dec, blocks, cut);
+        while (ret == 0)
+        {
+            ret = series_decoder_next(&dec, sample, NULL);
+        }
+        zassert_equal(ret, -EBADMSG, "Block cut to %zu bytes", cut);
+    }
+
+    blocks[0] = (SERIES_CODEC_VERSION + 1) << 4 | 3;
+    zassert_equal(series_decoder_start(&dec, blocks, len), -ENOTSUP);
+    blocks[0] = SERIES_CODEC_VERSION << 4;
+    zassert_equal(series_decoder_start(&dec, blocks, len), -EBADMSG);
+}
+
+// Size against 16 bit samples with no timestamps, and speed, printed as
+// series_codec_bench trace=... samples=... raw_bytes=... coded_bytes=... ratio_permille=...
+// encode_ns_per_sample=... decode_ns_per_sample=...
+static void bench(const char *trace, const int32_t *samples, size_t count, uint8_t channels, uint32_t period_ms)
+{
+    uint64_t start = bench_start();
+    const size_t len = encode(samples, count, channels, period_ms);
+    const uint64_t encode_ns = bench_elapsed_ns(start);
+
+    start = bench_start();
+    decode(samples, count, channels, period_ms, len);
+    const uint64_t decode_ns = bench_elapsed_ns(start);
+
+    const size_t raw = count * channels * sizeof(int16_t);
+    TC_PRINT("series_codec_bench trace=%s samples=%zu raw_bytes=%zu coded_bytes=%zu ratio_permille=%zu "
+             "encode_ns_per_sample=%u decode_ns_per_sample=%u\n",
+             trace, count, raw, len, raw * 1000 / len, (uint32_t)(encode_ns / count),
+             (uint32_t)(decode_ns / count));
+    zassert_true(raw * 1000 / len >= 1500, "%s should code to under 2/3 of its raw size", trace);
+}
+
+ZTEST(series_codec, test_series_codec_bench)
+{
+    make_accel_trace();
+    make_battery_trace();
+
+    bench("accel", &accel[0][0], ACCEL_SAMPLES, 3, 1000 / ACCEL_HZ);
+    bench("battery", &battery[0][0], BATTERY_SAMPLES, 1, BATTERY_PERIOD * 1000);
+}
+
+ZTEST_SUITE(series_codec, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,279 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/flash.h>
+#include <zephyr/storage/flash_map.h>
+#include <t_watch_s3/telemetry_log.h>
+#include <host_clock.h>
+
+#include <string.h>
+
+#ifdef CONFIG_FLASH_SIMULATOR
+#include <zephyr/drivers/flash/flash_simulator.h>
+#endif
+
+#define TYPE_SAMPLE 1
+#define BATCH_SIZE  CONFIG_T_WATCH_S3_TELEMETRY_LOG_BATCH_SIZE
+
+// A battery/IMU sized sample, which can tell whether it came back intact
+struct sample
+{
+    uint32_t seq;
+    uint8_t data[12];
+};
+
+struct walk_state
+{
+    uint32_t count;
+    uint32_t first;
+    uint32_t last;
+    bool in_order;
+};
+
+static const struct device *const flash = FIXED_PARTITION_DEVICE(storage_partition);
+
+static struct sample make_sample(uint32_t seq)
+{
+    struct sample sample = {.seq = seq};
+    for (size_t i = 0; i < sizeof(sample.data); i++)
+    {
+        sample.data[i] = seq * 7 + i;
+    }
+    return sample;
+}
+
+static void append_samples(uint32_t from, uint32_t count)
+{
+    for (uint32_t seq = from; seq < from + count; seq++)
+    {
+        const struct sample sample = make_sample(seq);
+        zassert_ok(telemetry_log_append(TYPE_SAMPLE, &sample, sizeof(sample)));
+    }
+}
+
+static bool walk_cb(uint8_t type, const void *data, size_t len, void *user_data)
+{
+    struct walk_state *state = user_data;
+    struct sample sample;
+
+    zassert_equal(type, TYPE_SAMPLE);
+    zassert_equal(len, sizeof(sample));
+    memcpy(&sample, data, len);
+    const struct sample expected = make_sample(sample.seq);
+    zassert_mem_equal(&sample, &expected, sizeof(sample), "Record %u came back damaged", sample.seq);
+
+    if (state->count == 0)
+    {
+        state->first = sample.seq;
+    }
+    else if (sample.seq != state->last + 1)
+    {
+        state->in_order = false;
+    }
+    state->last = sample.seq;
+    state->count++;
+    return true;
+}
+
+static struct walk_state walk(void)
+{
+    struct walk_state state = {.in_order = true};
+    zassert_ok(telemetry_log_walk(walk_cb, &state));
+    return state;
+}
+
+static uint32_t sector_count(void)
+{
+    struct flash_pages_info info;
+    zassert_ok(flash_get_page_info_by_offs(flash, FIXED_PARTITION_OFFSET(storage_partition), &info));
+    return FIXED_PARTITION_SIZE(storage_partition) / info.size;
+}
+
+#ifdef CONFIG_FLASH_SIMULATOR
+// Where a record is in the simulated flash
+static uint8_t *find_sample(uint32_t seq)
+{
+    size_t size;
+    uint8_t *memory = flash_simulator_get_memory(flash, &size);
+    uint8_t *partition = memory + FIXED_PARTITION_OFFSET(storage_partition);
+    const struct sample sample = make_sample(seq);
+
+    for (size_t pos = 0; pos + sizeof(sample) <= FIXED_PARTITION_SIZE(storage_partition); pos++)
+    {
+        if (memcmp(&partition[pos], &sample, sizeof(sample)) == 0)
+        {
+            return &partition[pos];
+        }
+    }
+    return NULL;
+}
+#endif
+
+static void telemetry_log_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    zassert_ok(telemetry_log_init());
+    zassert_ok(telemetry_log_clear());
+    telemetry_log_stats_reset();
+}
+
+ZTEST(telemetry_log, test_telemetry_log_roundtrip)
+{
+    append_samples(0, 5);
+    zassert_equal(walk().count, 0, "Nothing should be written before a flush");
+
+    append_samples(5, 45);
+    zassert_ok(telemetry_log_flush());
+    const struct walk_state state = walk();
+    zassert_equal(state.count, 50);
+    zassert_equal(state.first, 0);
+    zassert_true(state.in_order);
+
+    // too big for a batch
+    static uint8_t big[BATCH_SIZE];
+    zassert_equal(telemetry_log_append(TYPE_SAMPLE, big, sizeof(big)), -EINVAL);
+}
+
+ZTEST(telemetry_log, test_telemetry_log_batching)
+{
+    // records per batch: the batch header is 8 bytes, each record 2 more
+    const uint32_t per_batch = (BATCH_SIZE - 8) / (2 + sizeof(struct sample));
+
+    append_samples(0, per_batch * 4);
+    struct telemetry_log_stats stats;
+    telemetry_log_stats_get(&stats);
+    zassert_equal(stats.batches, 3, "The last batch should still be in RAM");
+
+    zassert_ok(telemetry_log_flush());
+    zassert_ok(telemetry_log_flush());
+    telemetry_log_stats_get(&stats);
+    zassert_equal(stats.batches, 4, "A flush with nothing to write should write nothing");
+}
+
+ZTEST(telemetry_log, test_telemetry_log_rotation)
+{
+    const uint32_t sectors = sector_count();
+    struct telemetry_log_stats stats;
+    uint32_t seq = 0;
+
+    // round the ring twice
+    do
+    {
+        append_samples(seq, 10);
+        seq += 10;
+        telemetry_log_stats_get(&stats);
+    } while (stats.sectors_erased < 2 * sectors + 1);
+    zassert_ok(telemetry_log_flush());
+
+    telemetry_log_stats_get(&stats);
+    zassert_true(stats.sectors_dropped > 0);
+
+    // what is left is the newest records, without a gap
+    const struct walk_state state = walk();
+    zassert_true(state.in_order, "Records came back out of order");
+    zassert_equal(state.last, seq - 1);
+    zassert_true(state.count > 0 && state.count < seq);
+
+    // every sector erased about as often as the others
+    zassert_ok(telemetry_log_init());
+    telemetry_log_stats_get(&stats);
+    zassert_true(stats.max_erase_count - stats.min_erase_count <= 1, "Erase counts %u to %u", stats.min_erase_count,
+                 stats.max_erase_count);
+}
+
+ZTEST(telemetry_log, test_telemetry_log_recovery)
+{
+    append_samples(0, 100);
+    zassert_ok(telemetry_log_flush());
+    // lost on "reset"
+    append_samples(100, 5);
+
+    struct telemetry_log_stats stats;
+    zassert_ok(telemetry_log_init());
+    telemetry_log_stats_get(&stats);
+    // the sector headers and the batch headers of the newest sector, one
+    // past the last
+    zassert_true(stats.recovery_reads <= sector_count() + stats.batches + 1, "%u header reads", stats.recovery_reads);
+
+    struct walk_state state = walk();
+    zassert_equal(state.count, 100);
+
+    // and carries on after the records that made it
+    append_samples(100, 10);
+    zassert_ok(telemetry_log_flush());
+    state = walk();
+    zassert_equal(state.count, 110);
+    zassert_true(state.in_order);
+}
+
+ZTEST(telemetry_log, test_telemetry_log_corruption)
+{
+#ifdef CONFIG_FLASH_SIMULATOR
+    for (uint32_t seq = 0; seq < 30; seq += 10)
+    {
+        append_samples(seq, 10);
+        zassert_ok(telemetry_log_flush());
+    }
+
+    // a bit flipped in the second batch
+    uint8_t *record = find_sample(15);
+    zassert_not_null(record);
+    record[offsetof(struct sample, data)] ^= 0x01;
+
+    struct walk_state state = walk();
+    struct telemetry_log_stats stats;
+    telemetry_log_stats_get(&stats);
+    zassert_equal(state.count, 20, "Only the damaged batch should be skipped");
+    zassert_equal(stats.crc_errors, 1);
+
+    // a batch header cut short by a reset, after the last batch
+    record = find_sample(29);
+    zassert_not_null(record);
+    record[sizeof(struct sample)] = 0x12;
+
+    zassert_ok(telemetry_log_init());
+    append_samples(30, 10);
+    zassert_ok(telemetry_log_flush());
+    state = walk();
+    zassert_equal(state.count, 30);
+    zassert_equal(state.last, 39, "New records should go past the damage");
+#else
+    ztest_test_skip();
+#endif
+}
+
+// Write amplification batched and if every sample had been written on its
+// own, and throughput, printed as
+// telemetry_log_bench record_bytes=... records=... batches=... erases=... wa_permille=... unbatched_wa_permille=...
+// records_per_s=...
+// telemetry_log_recovery sectors=... header_reads=... recovery_us=...
+ZTEST(telemetry_log, test_telemetry_log_bench)
+{
+    const uint32_t records = 1000;
+
+    const uint64_t start = bench_start();
+    append_samples(0, records);
+    zassert_ok(telemetry_log_flush());
+    const uint64_t elapsed_ns = MAX(bench_elapsed_ns(start), 1);
+
+    struct telemetry_log_stats stats;
+    telemetry_log_stats_get(&stats);
+    const size_t write_block = flash_get_write_block_size(flash);
+    const uint32_t unbatched = ROUND_UP(8 + 2 + sizeof(struct sample), write_block);
+    TC_PRINT("telemetry_log_bench record_bytes=%zu records=%u batches=%u erases=%u wa_permille=%u "
+             "unbatched_wa_permille=%u records_per_s=%u\n",
+             sizeof(struct sample), stats.records, stats.batches, stats.sectors_erased,
+             stats.flash_bytes_written * 1000 / stats.record_bytes, unbatched * 1000 / sizeof(struct sample),
+             (uint32_t)(records * NSEC_PER_SEC / elapsed_ns));
+    zassert_true(stats.flash_bytes_written * 1000 / stats.record_bytes < 1300,
+                 "Batching should keep the overhead under 30%%");
+
+    zassert_ok(telemetry_log_init());
+    telemetry_log_stats_get(&stats);
+    TC_PRINT("telemetry_log_recovery sectors=%u header_reads=%u recovery_us=%u\n", sector_count(),
+             stats.recovery_reads, stats.recovery_us);
+}
+
+ZTEST_SUITE(telemetry_log, NULL, NULL, telemetry_log_before, NULL, NULL);
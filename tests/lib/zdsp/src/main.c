@@ -0,0 +1,430 @@
+//
+// Copyright (c) 2025 Noah Luskey <noah@vvvvvvvvvv.io>
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <zephyr/ztest.h>
+#include <zephyr/dsp/dsp.h>
+#include <t_watch_s3/zdsp_filter.h>
+#include <host_clock.h>
+
+#include <math.h>
+
+// Not a multiple of the vector length, so every kernel has a tail
+#define LEN 67
+#define BENCH_LEN 256
+#define BENCH_ROUNDS 2000
+
+#define Q15_ONE 32768.0
+#define Q31_ONE 2147483648.0
+
+// Buffers are aligned for the PIE kernels. Every check runs on them, and
+// again one element in, where the C implementation does it all.
+static q15_t a15[BENCH_LEN] __aligned(16);
+static q15_t b15[BENCH_LEN] __aligned(16);
+static q15_t out15[BENCH_LEN] __aligned(16);
+static q31_t a31[BENCH_LEN] __aligned(16);
+static q31_t b31[BENCH_LEN] __aligned(16);
+static q31_t out31[BENCH_LEN] __aligned(16);
+static float32_t af[BENCH_LEN];
+static float32_t bf[BENCH_LEN];
+static float32_t outf[BENCH_LEN];
+
+static const size_t offsets[] = {0, 1};
+
+static void fill(uint32_t seed)
+{
+    for (size_t i = 0; i < BENCH_LEN; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        a31[i] = seed;
+        seed = seed * 1103515245 + 12345;
+        b31[i] = seed;
+        a15[i] = a31[i] >> 16;
+        b15[i] = b31[i] >> 16;
+    }
+
+    // the corners, where saturation kicks in
+    a15[0] = b15[0] = INT16_MIN;
+    a15[1] = b15[1] = INT16_MAX;
+    a15[2] = INT16_MIN;
+    b15[2] = INT16_MAX;
+    a31[0] = b31[0] = INT32_MIN;
+    a31[1] = b31[1] = INT32_MAX;
+    a31[2] = INT32_MIN;
+    b31[2] = INT32_MAX;
+
+    for (size_t i = 0; i < BENCH_LEN; i++)
+    {
+        af[i] = a15[i] / Q15_ONE;
+        bf[i] = b15[i] / Q15_ONE;
+    }
+}
+
+static void *setup(void)
+{
+    fill(1);
+    return NULL;
+}
+
+static double clamp(double value, double one)
+{
+    return CLAMP(value, -1.0, (one - 1) / one);
+}
+
+// Q results against the exact value: within an LSB, since the fixed point
+// kernels round down
+#define ASSERT_Q15(actual, exact, i)                                                                                   \
+    zassert_within((actual) / Q15_ONE, clamp(exact, Q15_ONE), 1.0 / Q15_ONE, "element %zu", (i))
+#define ASSERT_Q31(actual, exact, i)                                                                                   \
+    zassert_within((actual) / Q31_ONE, clamp(exact, Q31_ONE), 2.0 / Q31_ONE, "element %zu", (i))
+#define ASSERT_F32(actual, exact, i) zassert_within((actual), (exact), 1e-5, "element %zu", (i))
+
+ZTEST(zdsp, test_add)
+{
+    ARRAY_FOR_EACH(offsets, j)
+    {
+        const size_t o = offsets[j];
+        zdsp_add_q15(&a15[o], &b15[o], &out15[o], LEN);
+        zdsp_add_q31(&a31[o], &b31[o], &out31[o], LEN);
+        zdsp_add_f32(&af[o], &bf[o], &outf[o], LEN);
+        for (size_t i = o; i < o + LEN; i++)
+        {
+            ASSERT_Q15(out15[i], (a15[i] + b15[i]) / Q15_ONE, i);
+            ASSERT_Q31(out31[i], ((double)a31[i] + b31[i]) / Q31_ONE, i);
+            ASSERT_F32(outf[i], (double)af[i] + bf[i], i);
+        }
+    }
+}
+
+ZTEST(zdsp, test_mult)
+{
+    ARRAY_FOR_EACH(offsets, j)
+    {
+        const size_t o = offsets[j];
+        zdsp_mult_q15(&a15[o], &b15[o], &out15[o], LEN);
+        zdsp_mult_q31(&a31[o], &b31[o], &out31[o], LEN);
+        zdsp_mult_f32(&af[o], &bf[o], &outf[o], LEN);
+        for (size_t i = o; i < o + LEN; i++)
+        {
+            ASSERT_Q15(out15[i], (a15[i] / Q15_ONE) * (b15[i] / Q15_ONE), i);
+            ASSERT_Q31(out31[i], (a31[i] / Q31_ONE) * (b31[i] / Q31_ONE), i);
+            ASSERT_F32(outf[i], (double)af[i] * bf[i], i);
+        }
+    }
+}
+
+ZTEST(zdsp, test_scale)
+{
+    // 0.75 * 2^shift, down to a quarter and up to saturation
+    const int8_t shifts[] = {-2, 0, 1, 3};
+
+    ARRAY_FOR_EACH(shifts, k)
+    {
+        const int8_t shift = shifts[k];
+        const double scale = 0.75 * pow(2, shift);
+        // Q31 drops the product's bottom 32 bits before shifting
+        const double q31_lsb = MAX(pow(2, shift + 1), 2) / Q31_ONE;
+
+        ARRAY_FOR_EACH(offsets, j)
+        {
+            const size_t o = offsets[j];
+            zdsp_scale_q15(&a15[o], 0.75 * Q15_ONE, shift, &out15[o], LEN);
+            zdsp_scale_q31(&a31[o], 0.75 * Q31_ONE, shift, &out31[o], LEN);
+            zdsp_scale_f32(&af[o], scale, &outf[o], LEN);
+            for (size_t i = o; i < o + LEN; i++)
+            {
+                ASSERT_Q15(out15[i], a15[i] / Q15_ONE * scale, i);
+                zassert_within(out31[i] / Q31_ONE, clamp(a31[i] / Q31_ONE * scale, Q31_ONE), q31_lsb,
+                               "element %zu", i);
+                ASSERT_F32(outf[i], af[i] * scale, i);
+            }
+        }
+    }
+}
+
+ZTEST(zdsp, test_dot_prod)
+{
+    ARRAY_FOR_EACH(offsets, j)
+    {
+        const size_t o = offsets[j];
+        // long enough for the PIE accumulator to be flushed along the way
+        const uint32_t len = BENCH_LEN - o;
+
+        double exact15 = 0;
+        double exact31 = 0;
+        for (size_t i = o; i < o + len; i++)
+        {
+            exact15 += (double)a15[i] * b15[i];
+            exact31 += (a31[i] / Q31_ONE) * (b31[i] / Q31_ONE);
+        }
+
+        q63_t result;
+        zdsp_dot_prod_q15(&a15[o], &b15[o], len, &result);
+        // Q34.30, and exact
+        zassert_equal(result, (q63_t)exact15);
+
+        zdsp_dot_prod_q31(&a31[o], &b31[o], len, &result);
+        // Q16.48
+        zassert_within(result / (double)(1LL << 48), exact31, 1e-9);
+
+        float32_t resultf;
+        zdsp_dot_prod_f32(&af[o], &bf[o], len, &resultf);
+        zassert_within(resultf, exact15 / (Q15_ONE * Q15_ONE), 1e-4);
+    }
+}
+
+// A 7-tap smoothing filter, fed in two blocks to carry the state over
+#define TAPS 7
+static const double fir_coeffs[TAPS] = {0.05, 0.1, 0.2, 0.3, 0.2, 0.1, 0.05};
+
+ZTEST(zdsp, test_fir)
+{
+    q15_t coeffs15[TAPS];
+    q31_t coeffs31[TAPS];
+    float32_t coeffsf[TAPS];
+    for (size_t k = 0; k < TAPS; k++)
+    {
+        coeffs15[k] = fir_coeffs[k] * Q15_ONE;
+        coeffs31[k] = fir_coeffs[k] * Q31_ONE;
+        coeffsf[k] = fir_coeffs[k];
+    }
+
+    static q15_t state15[ZDSP_FIR_STATE_LEN(TAPS, LEN)];
+    static q31_t state31[ZDSP_FIR_STATE_LEN(TAPS, LEN)];
+    static float32_t statef[ZDSP_FIR_STATE_LEN(TAPS, LEN)];
+    struct zdsp_fir_q15 fir15;
+    struct zdsp_fir_q31 fir31;
+    struct zdsp_fir_f32 firf;
+    zdsp_fir_q15_init(&fir15, coeffs15, TAPS, state15, LEN);
+    zdsp_fir_q31_init(&fir31, coeffs31, TAPS, state31, LEN);
+    zdsp_fir_f32_init(&firf, coeffsf, TAPS, statef, LEN);
+
+    const size_t first = LEN / 2;
+    zdsp_fir_q15(&fir15, a15, out15, first);
+    zdsp_fir_q15(&fir15, &a15[first], &out15[first], LEN - first);
+    zdsp_fir_q31(&fir31, a31, out31, first);
+    zdsp_fir_q31(&fir31, &a31[first], &out31[first], LEN - first);
+    zdsp_fir_f32(&firf, af, outf, first);
+    zdsp_fir_f32(&firf, &af[first], &outf[first], LEN - first);
+
+    for (size_t n = 0; n < LEN; n++)
+    {
+        // with the coefficients as quantized
+        double exact15 = 0;
+        double exact31 = 0;
+        double exactf = 0;
+        for (size_t k = 0; k < TAPS && k <= n; k++)
+        {
+            exact15 += coeffs15[k] / Q15_ONE * (a15[n - k] / Q15_ONE);
+            exact31 += coeffs31[k] / Q31_ONE * (a31[n - k] / Q31_ONE);
+            exactf += (double)coeffsf[k] * af[n - k];
+        }
+        ASSERT_Q15(out15[n], exact15, n);
+        ASSERT_Q31(out31[n], exact31, n);
+        ASSERT_F32(outf[n], exactf, n);
+    }
+}
+
+// Two stages of a low-pass, with a1 above 1 so the fixed point versions
+// need a post shift
+#define STAGES 2
+static const double biquad_coeffs[5 * STAGES] = {
+    0.0675, 0.1349, 0.0675, 1.1430, -0.4128,
+    0.0675, 0.1349, 0.0675, 1.1430, -0.4128,
+};
+
+ZTEST(zdsp, test_biquad)
+{
+    q15_t coeffs15[5 * STAGES];
+    q31_t coeffs31[5 * STAGES];
+    float32_t coeffsf[5 * STAGES];
+    for (size_t k = 0; k < ARRAY_SIZE(biquad_coeffs); k++)
+    {
+        coeffs15[k] = biquad_coeffs[k] / 2 * Q15_ONE;
+        coeffs31[k] = biquad_coeffs[k] / 2 * Q31_ONE;
+        coeffsf[k] = biquad_coeffs[k];
+    }
+
+    q15_t state15[ZDSP_BIQUAD_Q_STATE_LEN(STAGES)];
+    q31_t state31[ZDSP_BIQUAD_Q_STATE_LEN(STAGES)];
+    float32_t statef[ZDSP_BIQUAD_F32_STATE_LEN(STAGES)];
+    struct zdsp_biquad_q15 biquad15;
+    struct zdsp_biquad_q31 biquad31;
+    struct zdsp_biquad_f32 biquadf;
+    zdsp_biquad_q15_init(&biquad15, STAGES, coeffs15, state15, 1);
+    zdsp_biquad_q31_init(&biquad31, STAGES, coeffs31, state31, 1);
+    zdsp_biquad_f32_init(&biquadf, STAGES, coeffsf, statef);
+
+    // half scale, so the low-pass' gain stays clear of saturation
+    q15_t in15[LEN];
+    q31_t in31[LEN];
+    float32_t inf[LEN];
+    for (size_t n = 0; n < LEN; n++)
+    {
+        in15[n] = a15[n] / 2;
+        in31[n] = a31[n] / 2;
+        inf[n] = in15[n] / Q15_ONE;
+    }
+
+    const size_t first = LEN / 2;
+    zdsp_biquad_q15(&biquad15, in15, out15, first);
+    zdsp_biquad_q15(&biquad15, &in15[first], &out15[first], LEN - first);
+    zdsp_biquad_q31(&biquad31, in31, out31, first);
+    zdsp_biquad_q31(&biquad31, &in31[first], &out31[first], LEN - first);
+    zdsp_biquad_f32(&biquadf, inf, outf, first);
+    zdsp_biquad_f32(&biquadf, &inf[first], &outf[first], LEN - first);
+
+    // in doubles, direct form I, with the coefficients as quantized
+    double x[STAGES][2] = {0};
+    double y[STAGES][2] = {0};
+    for (size_t n = 0; n < LEN; n++)
+    {
+        double value = in31[n] / Q31_ONE;
+        for (size_t s = 0; s < STAGES; s++)
+        {
+            const q31_t *c = &coeffs31[s * 5];
+            const double out = 2 * (c[0] * value + c[1] * x[s][0] + c[2] * x[s][1] + c[3] * y[s][0] +
+                                    c[4] * y[s][1]) / Q31_ONE;
+            x[s][1] = x[s][0];
+            x[s][0] = value;
+            y[s][1] = y[s][0];
+            y[s][0] = out;
+            value = out;
+        }
+
+        // Q15 rounds down, and the feedback loop amplifies that bias
+        zassert_within(out15[n] / Q15_ONE, value, 16.0 / Q15_ONE, "element %zu", n);
+        zassert_within(out31[n] / Q31_ONE, value, 1e-6, "element %zu", n);
+        zassert_within(outf[n], value, 1e-4, "element %zu", n);
+    }
+}
+
+// Plain C loops, the way they would be written without a backend, for the
+// kernels PIE covers
+static __noinline void plain_add_q15(const q15_t *a, const q15_t *b, q15_t *dst, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        dst[i] = CLAMP((int32_t)a[i] + b[i], INT16_MIN, INT16_MAX);
+    }
+}
+
+static __noinline void plain_add_q31(const q31_t *a, const q31_t *b, q31_t *dst, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        dst[i] = CLAMP((int64_t)a[i] + b[i], INT32_MIN, INT32_MAX);
+    }
+}
+
+static __noinline void plain_mult_q15(const q15_t *a, const q15_t *b, q15_t *dst, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        dst[i] = CLAMP(((int32_t)a[i] * b[i]) >> 15, INT16_MIN, INT16_MAX);
+    }
+}
+
+static __noinline void plain_scale_q15(const q15_t *a, q15_t scale, q15_t *dst, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        dst[i] = CLAMP(((int32_t)a[i] * scale) >> 15, INT16_MIN, INT16_MAX);
+    }
+}
+
+static __noinline q63_t plain_dot_prod_q15(const q15_t *a, const q15_t *b, uint32_t len)
+{
+    q63_t sum = 0;
+    for (uint32_t i = 0; i < len; i++)
+    {
+        sum += (int32_t)a[i] * b[i];
+    }
+    return sum;
+}
+
+// Runs the statement BENCH_ROUNDS times, and gives the cost of one
+// element in hundredths of a ns
+#define BENCH(statement)                                                                                               \
+    ({                                                                                                                 \
+        const uint64_t start_ = bench_start();                                                                         \
+        for (int round_ = 0; round_ < BENCH_ROUNDS; round_++)                                                          \
+        {                                                                                                              \
+            statement;                                                                                                 \
+            compiler_barrier();                                                                                        \
+        }                                                                                                              \
+        (uint32_t)(bench_elapsed_ns(start_) * 100ULL / ((uint64_t)BENCH_ROUNDS * BENCH_LEN));                          \
+    })
+
+static void print_bench(const char *kernel, uint32_t backend, uint32_t plain)
+{
+    TC_PRINT("zdsp_bench kernel=%s unit=ns backend=%u.%02u", kernel, backend / 100, backend % 100);
+    if (plain > 0)
+    {
+        TC_PRINT(" plain=%u.%02u", plain / 100, plain % 100);
+    }
+    TC_PRINT("\n");
+}
+
+// Cost per element of every kernel, on BENCH_LEN aligned elements, next to
+// the plain C loop where PIE is involved
+ZTEST(zdsp, test_benchmark)
+{
+    q63_t dot;
+    float32_t dotf;
+
+    print_bench("add_q15", BENCH(zdsp_add_q15(a15, b15, out15, BENCH_LEN)),
+                BENCH(plain_add_q15(a15, b15, out15, BENCH_LEN)));
+    print_bench("add_q31", BENCH(zdsp_add_q31(a31, b31, out31, BENCH_LEN)),
+                BENCH(plain_add_q31(a31, b31, out31, BENCH_LEN)));
+    print_bench("add_f32", BENCH(zdsp_add_f32(af, bf, outf, BENCH_LEN)), 0);
+    print_bench("mult_q15", BENCH(zdsp_mult_q15(a15, b15, out15, BENCH_LEN)),
+                BENCH(plain_mult_q15(a15, b15, out15, BENCH_LEN)));
+    print_bench("mult_q31", BENCH(zdsp_mult_q31(a31, b31, out31, BENCH_LEN)), 0);
+    print_bench("mult_f32", BENCH(zdsp_mult_f32(af, bf, outf, BENCH_LEN)), 0);
+    print_bench("scale_q15", BENCH(zdsp_scale_q15(a15, 0x6000, 0, out15, BENCH_LEN)),
+                BENCH(plain_scale_q15(a15, 0x6000, out15, BENCH_LEN)));
+    print_bench("scale_q31", BENCH(zdsp_scale_q31(a31, 0x60000000, 0, out31, BENCH_LEN)), 0);
+    print_bench("scale_f32", BENCH(zdsp_scale_f32(af, 0.75f, outf, BENCH_LEN)), 0);
+    print_bench("dot_prod_q15", BENCH(zdsp_dot_prod_q15(a15, b15, BENCH_LEN, &dot)),
+                BENCH(dot = plain_dot_prod_q15(a15, b15, BENCH_LEN)));
+    print_bench("dot_prod_q31", BENCH(zdsp_dot_prod_q31(a31, b31, BENCH_LEN, &dot)), 0);
+    print_bench("dot_prod_f32", BENCH(zdsp_dot_prod_f32(af, bf, BENCH_LEN, &dotf)), 0);
+
+    static q15_t coeffs15[TAPS];
+    static q31_t coeffs31[TAPS];
+    static float32_t coeffsf[TAPS];
+    static q15_t state15[ZDSP_FIR_STATE_LEN(TAPS, BENCH_LEN)];
+    static q31_t state31[ZDSP_FIR_STATE_LEN(TAPS, BENCH_LEN)];
+    static float32_t statef[ZDSP_FIR_STATE_LEN(TAPS, BENCH_LEN)];
+    struct zdsp_fir_q15 fir15;
+    struct zdsp_fir_q31 fir31;
+    struct zdsp_fir_f32 firf;
+    zdsp_fir_q15_init(&fir15, coeffs15, TAPS, state15, BENCH_LEN);
+    zdsp_fir_q31_init(&fir31, coeffs31, TAPS, state31, BENCH_LEN);
+    zdsp_fir_f32_init(&firf, coeffsf, TAPS, statef, BENCH_LEN);
+    print_bench("fir7_q15", BENCH(zdsp_fir_q15(&fir15, a15, out15, BENCH_LEN)), 0);
+    print_bench("fir7_q31", BENCH(zdsp_fir_q31(&fir31, a31, out31, BENCH_LEN)), 0);
+    print_bench("fir7_f32", BENCH(zdsp_fir_f32(&firf, af, outf, BENCH_LEN)), 0);
+
+    static q15_t bq_coeffs15[ZDSP_BIQUAD_COEFFS_LEN(STAGES)];
+    static q31_t bq_coeffs31[ZDSP_BIQUAD_COEFFS_LEN(STAGES)];
+    static float32_t bq_coeffsf[ZDSP_BIQUAD_COEFFS_LEN(STAGES)];
+    q15_t bq_state15[ZDSP_BIQUAD_Q_STATE_LEN(STAGES)];
+    q31_t bq_state31[ZDSP_BIQUAD_Q_STATE_LEN(STAGES)];
+    float32_t bq_statef[ZDSP_BIQUAD_F32_STATE_LEN(STAGES)];
+    struct zdsp_biquad_q15 biquad15;
+    struct zdsp_biquad_q31 biquad31;
+    struct zdsp_biquad_f32 biquadf;
+    zdsp_biquad_q15_init(&biquad15, STAGES, bq_coeffs15, bq_state15, 1);
+    zdsp_biquad_q31_init(&biquad31, STAGES, bq_coeffs31, bq_state31, 1);
+    zdsp_biquad_f32_init(&biquadf, STAGES, bq_coeffsf, bq_statef);
+    print_bench("biquad2_q15", BENCH(zdsp_biquad_q15(&biquad15, a15, out15, BENCH_LEN)), 0);
+    print_bench("biquad2_q31", BENCH(zdsp_biquad_q31(&biquad31, a31, out31, BENCH_LEN)), 0);
+    print_bench("biquad2_f32", BENCH(zdsp_biquad_f32(&biquadf, af, outf, BENCH_LEN)), 0);
+
+    ARG_UNUSED(dot);
+    ARG_UNUSED(dotf);
+}
+
+ZTEST_SUITE(zdsp, NULL, setup, NULL, NULL, NULL);
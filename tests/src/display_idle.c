@@ -0,0 +1,74 @@
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/regulator.h>
+#include <t_watch_s3/display_idle.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(bringup, CONFIG_BRINGUP_LOG_LEVEL);
+
+static void display_idle_tests_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    // start awake, with the whole idle timeout ahead, whatever ran before
+    zassert_equal(display_idle_enter(DISPLAY_IDLE_ACTIVE), 0);
+    display_idle_kick();
+}
+
+static void display_idle_tests_after(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    // leave the display on for whatever test runs next
+    zassert_equal(display_idle_enter(DISPLAY_IDLE_ACTIVE), 0);
+}
+
+ZTEST(display_idle, test_display_idle_steps)
+{
+    zassert_equal(display_idle_state_get(), DISPLAY_IDLE_ACTIVE);
+
+    for (enum display_idle_state s = DISPLAY_IDLE_DIM; s <= DISPLAY_IDLE_SLEEP; s++)
+    {
+        int ret = display_idle_enter(s);
+        zassert_equal(ret, 0, "Failed to enter state %d (%d)", s, ret);
+        zassert_equal(display_idle_state_get(), s);
+    }
+}
+
+ZTEST(display_idle, test_display_idle_wake_on_kick)
+{
+    struct display_idle_stats before;
+    struct display_idle_stats after;
+    display_idle_stats_get(&before);
+
+    zassert_equal(display_idle_enter(DISPLAY_IDLE_SLEEP), 0);
+    display_idle_kick();
+
+    // the wake happens on the system workqueue
+    k_sleep(K_MSEC(CONFIG_T_WATCH_S3_DISPLAY_IDLE_WAKE_BUDGET_MS * 2));
+    zassert_equal(display_idle_state_get(), DISPLAY_IDLE_ACTIVE);
+
+    display_idle_stats_get(&after);
+    zassert_equal(after.wakes, before.wakes + 1);
+    LOG_INF("Wake from sleep-in took %u us", after.last_wake_us);
+    zassert_true(after.last_wake_us <= CONFIG_T_WATCH_S3_DISPLAY_IDLE_WAKE_BUDGET_MS * USEC_PER_MSEC,
+                 "Wake took %u us", after.last_wake_us);
+}
+
+ZTEST(display_idle, test_display_idle_rail_cut)
+{
+    if (!IS_ENABLED(CONFIG_T_WATCH_S3_DISPLAY_IDLE_RAIL_CUT))
+    {
+        ztest_test_skip();
+    }
+
+    const struct device *lcd_vdd = DEVICE_DT_GET(DT_NODELABEL(lcd_vdd));
+    zassert_equal(display_idle_enter(DISPLAY_IDLE_OFF), 0);
+    zassert_false(regulator_is_enabled(lcd_vdd), "lcd_vdd is still enabled");
+
+    zassert_equal(display_idle_enter(DISPLAY_IDLE_ACTIVE), 0);
+    zassert_true(regulator_is_enabled(lcd_vdd), "lcd_vdd was not re-enabled");
+
+    struct display_idle_stats stats;
+    display_idle_stats_get(&stats);
+    LOG_INF("Wake from rail cut took %u us", stats.last_wake_us);
+}
+
+ZTEST_SUITE(display_idle, NULL, NULL, display_idle_tests_before, display_idle_tests_after, NULL);
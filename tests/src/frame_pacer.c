@@ -0,0 +1,119 @@
+#include <zephyr/ztest.h>
+#include <t_watch_s3/frame_pacer.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(bringup, CONFIG_BRINGUP_LOG_LEVEL);
+
+#define BAND_W 240
+#define BAND_H 20
+#define FRAMES 60
+
+static uint16_t band[BAND_W * BAND_H];
+static K_SEM_DEFINE(frame_done_sem, 0, FRAMES);
+
+static void frame_done(const struct frame_pacer_rect *rect, int status, void *user_data)
+{
+    ARG_UNUSED(rect);
+    int *last_status = user_data;
+    *last_status = status;
+    k_sem_give(&frame_done_sem);
+}
+
+static void frame_pacer_tests_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    k_sem_reset(&frame_done_sem);
+    frame_pacer_stats_reset();
+}
+
+ZTEST(frame_pacer, test_frame_pacer_interval)
+{
+    const struct device *display = DEVICE_DT_GET(DT_CHOSEN(zephyr_display));
+    zassert_true(device_is_ready(display), "Display not ready");
+    zassert_equal(display_blanking_off(display), 0);
+
+    int status = 0;
+    struct frame_pacer_rect rect = {
+        .desc = {
+            .buf_size = sizeof(band),
+            .width = BAND_W,
+            .height = BAND_H,
+            .pitch = BAND_W,
+        },
+        .buf = band,
+        .flags = FRAME_PACER_FLAG_LAST,
+        .done = frame_done,
+        .user_data = &status,
+    };
+
+    // a band sweeping down the screen, one frame per band position,
+    // drawn the way an app would: render, submit, wait for the buffer
+    for (int i = 0; i < FRAMES; i++)
+    {
+        memset(band, i & 1 ? 0xFF : 0x00, sizeof(band));
+        rect.y = (i * BAND_H) % 240;
+        zassert_equal(frame_pacer_submit(&rect, K_FOREVER), 0);
+        zassert_equal(k_sem_take(&frame_done_sem, K_MSEC(100)), 0, "Frame %d was not flushed", i);
+        zassert_equal(status, 0, "Frame %d failed (%d)", i, status);
+    }
+
+    // the counters are updated right after the last done callback
+    k_sleep(K_MSEC(5));
+    struct frame_pacer_stats stats;
+    frame_pacer_stats_get(&stats);
+    zassert_equal(stats.presented, FRAMES);
+    zassert_equal(stats.dropped, 0);
+
+    // Every frame became ready after the previous flush, so each one should
+    // land exactly one slot later. Allow a millisecond either side for tick rounding.
+    const uint32_t period_ms = frame_pacer_period_ns() / NSEC_PER_MSEC;
+    uint32_t on_time = 0;
+    for (uint32_t ms = MAX(period_ms, 1) - 1; ms <= period_ms + 1; ms++)
+    {
+        on_time += stats.interval_ms[ms];
+    }
+
+    LOG_INF("Flush period %u ns, %u of %u intervals on time, %u missed slots", frame_pacer_period_ns(), on_time,
+            FRAMES - 1, stats.missed_slots);
+    zassert_true(on_time >= (FRAMES - 1) * 9 / 10, "Only %u of %u frame intervals on time", on_time, FRAMES - 1);
+}
+
+ZTEST(frame_pacer, test_frame_pacer_drop_full_frames)
+{
+    int status = 0;
+    const struct frame_pacer_rect rect = {
+        .desc = {
+            .buf_size = sizeof(band),
+            .width = BAND_W,
+            .height = BAND_H,
+            .pitch = BAND_W,
+        },
+        .buf = band,
+        .flags = FRAME_PACER_FLAG_LAST | FRAME_PACER_FLAG_FULL,
+        .done = frame_done,
+        .user_data = &status,
+    };
+
+    // Queue several "full" frames back to back. However they end up split
+    // across slots, every frame has to be either shown or dropped.
+    const int submitted = 4;
+    for (int i = 0; i < submitted; i++)
+    {
+        zassert_equal(frame_pacer_submit(&rect, K_FOREVER), 0);
+    }
+
+    for (int i = 0; i < submitted; i++)
+    {
+        zassert_equal(k_sem_take(&frame_done_sem, K_MSEC(200)), 0);
+    }
+
+    // the counters are updated right after the last done callback
+    k_sleep(K_MSEC(5));
+    struct frame_pacer_stats stats;
+    frame_pacer_stats_get(&stats);
+    LOG_INF("Presented %u, dropped %u", stats.presented, stats.dropped);
+    zassert_equal(stats.presented + stats.dropped, submitted);
+    zassert_true(stats.presented >= 1);
+}
+
+ZTEST_SUITE(frame_pacer, NULL, NULL, frame_pacer_tests_before, NULL, NULL);
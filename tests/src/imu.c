@@ -1,8 +1,11 @@
 #include <zephyr/ztest.h>
 #include <zephyr/drivers/sensor.h>
+#include <zephyr/drivers/sensor/bma423.h>
 #include <zephyr/rtio/rtio.h>
 #include <zephyr/dsp/utils.h>
 
+#include <math.h>
+
 #include <zephyr/logging/log.h>
 LOG_MODULE_DECLARE(bringup, CONFIG_BRINGUP_LOG_LEVEL);
 
@@ -66,4 +69,422 @@ ZTEST(imu, test_imu)
     zassert_between_inclusive(z, -10.81, -8.81, "Z acceleration is too high");
 }
 
+// Room for a few full FIFO drains (170 frames of 6 bytes, plus a header)
+RTIO_DEFINE_WITH_MEMPOOL(imu_stream_rtio, 4, 4, 64, 64, sizeof(void *));
+SENSOR_DT_STREAM_IODEV(imu_stream_iodev, DT_ALIAS(accel),
+                       {SENSOR_TRIG_FIFO_WATERMARK, SENSOR_STREAM_DATA_INCLUDE},
+                       {SENSOR_TRIG_FIFO_FULL, SENSOR_STREAM_DATA_INCLUDE});
+
+#define STREAM_TEST_MS 2000
+// longer than it takes the FIFO to reach its watermark
+#define STREAM_DRAIN_MS 1000
+
+// A cancelled stream only completes at its next FIFO interrupt. Wait for
+// that, giving back any buffers filled in the meantime, so the next
+// stream on imu_stream_rtio starts from an empty queue.
+static void stream_drain(void)
+{
+    const int64_t end = k_uptime_get() + STREAM_DRAIN_MS;
+    while (k_uptime_get() < end)
+    {
+        struct rtio_cqe *cqe = rtio_cqe_consume(&imu_stream_rtio);
+        if (cqe == NULL)
+        {
+            k_msleep(1);
+            continue;
+        }
+
+        const int result = cqe->result;
+        uint8_t *buf;
+        uint32_t buf_len;
+        if (rtio_cqe_get_mempool_buffer(&imu_stream_rtio, cqe, &buf, &buf_len) == 0)
+        {
+            rtio_release_buffer(&imu_stream_rtio, buf, buf_len);
+        }
+        rtio_cqe_release(&imu_stream_rtio, cqe);
+        if (result == -ECANCELED)
+        {
+            return;
+        }
+    }
+}
+
+static void print_stats(const char *name, const struct bma423_stats *stats, uint32_t elapsed_ms)
+{
+    LOG_PRINTK("%s: %u wake-ups/s, %u frames/s, %u us/s on the bus\n", name,
+               (stats->wakeups + stats->reads) * MSEC_PER_SEC / elapsed_ms, stats->frames * MSEC_PER_SEC / elapsed_ms,
+               stats->bus_us * MSEC_PER_SEC / elapsed_ms);
+}
+
+// Compares sampling at 100 Hz with one-shot reads against draining the FIFO
+// on its watermark interrupt
+ZTEST(imu, test_imu_stream)
+{
+    const struct device *imu = DEVICE_DT_GET(DT_ALIAS(accel));
+    zassert_true(device_is_ready(imu), "IMU device is not ready");
+
+    const struct sensor_decoder_api *decoder;
+    zassert_equal(sensor_get_decoder(imu, &decoder), 0, "Failed to get decoder");
+
+    // one-shot polling, one read every 10 ms
+    struct bma423_stats polling;
+    bma423_stats_reset(imu);
+    uint32_t start = k_uptime_get_32();
+    for (int i = 0; i < STREAM_TEST_MS / 10; i++)
+    {
+        zassert_equal(sensor_read_async_mempool(&imu_iodev, &imu_rtio, (void *)imu), 0, "Sensor read failed");
+        struct rtio_cqe *cqe = rtio_cqe_consume_block(&imu_rtio);
+        zassert_equal(cqe->result, 0, "Sensor read failed");
+
+        uint8_t *buf;
+        uint32_t buf_len;
+        zassert_equal(rtio_cqe_get_mempool_buffer(&imu_rtio, cqe, &buf, &buf_len), 0, "No buffer");
+        rtio_cqe_release(&imu_rtio, cqe);
+        rtio_release_buffer(&imu_rtio, buf, buf_len);
+        k_sleep(K_MSEC(10));
+    }
+    bma423_stats_get(imu, &polling);
+    print_stats("polling", &polling, k_uptime_get_32() - start);
+
+    // streaming from the FIFO
+    struct bma423_stats streaming;
+    struct rtio_sqe *handle;
+    bma423_stats_reset(imu);
+    start = k_uptime_get_32();
+    zassert_equal(sensor_stream(&imu_stream_iodev, &imu_stream_rtio, (void *)imu, &handle), 0,
+                  "Failed to start streaming");
+
+    uint32_t frames = 0;
+    uint64_t last_timestamp = 0;
+    while (k_uptime_get_32() - start < STREAM_TEST_MS)
+    {
+        struct rtio_cqe *cqe = rtio_cqe_consume_block(&imu_stream_rtio);
+        zassert_equal(cqe->result, 0, "Stream read failed");
+
+        uint8_t *buf;
+        uint32_t buf_len;
+        zassert_equal(rtio_cqe_get_mempool_buffer(&imu_stream_rtio, cqe, &buf, &buf_len), 0, "No buffer");
+        rtio_cqe_release(&imu_stream_rtio, cqe);
+
+        // every frame in the drain comes out, in order, laying flat
+        const struct sensor_chan_spec ch_spec = {.chan_idx = 0, .chan_type = SENSOR_CHAN_ACCEL_XYZ};
+        uint32_t fit = 0;
+        struct sensor_three_axis_data accel_data;
+        while (decoder->decode(buf, ch_spec, &fit, 1, &accel_data) > 0)
+        {
+            zassert_true(accel_data.header.base_timestamp_ns > last_timestamp, "Frames out of order");
+            last_timestamp = accel_data.header.base_timestamp_ns;
+
+            double z = Z_SHIFT_Q31_TO_F32(accel_data.readings[0].z, accel_data.shift);
+            zassert_between_inclusive(z, -10.81, -8.81, "Z acceleration is off");
+            frames++;
+        }
+        rtio_release_buffer(&imu_stream_rtio, buf, buf_len);
+    }
+    rtio_sqe_cancel(handle);
+    bma423_stats_get(imu, &streaming);
+    print_stats("streaming", &streaming, k_uptime_get_32() - start);
+    stream_drain();
+
+    zassert_true(frames > 0, "No frames streamed");
+    zassert_true(streaming.wakeups < polling.reads, "Streaming should wake the host less often");
+}
+
+// How long it took the driver to find the chip at boot, poll by poll
+ZTEST(imu, test_imu_bringup)
+{
+    const struct device *imu = DEVICE_DT_GET(DT_ALIAS(accel));
+
+    struct bma423_bringup bringup;
+    bma423_bringup_get(imu, &bringup);
+    for (uint8_t i = 0; i < bringup.attempts; i++)
+    {
+        LOG_PRINTK("bring-up poll %u: %u us, %d\n", i, bringup.attempt[i].at_us, bringup.attempt[i].result);
+    }
+    LOG_PRINTK("bring-up: %u us, %u polls, %u resets\n", bringup.total_us, bringup.attempts, bringup.resets);
+
+    zassert_true(device_is_ready(imu), "IMU device is not ready");
+    zassert_true(bringup.attempts > 0, "No bring-up recorded");
+    zassert_equal(bringup.attempt[MIN(bringup.attempts, BMA423_BRINGUP_MAX_ATTEMPTS) - 1].result, 0);
+    zassert_true(bringup.total_us < CONFIG_BMA423_BRINGUP_TIMEOUT_MS * USEC_PER_MSEC * CONFIG_BMA423_BRINGUP_RESETS);
+}
+
+static void read_accel(const struct device *imu, double xyz[3])
+{
+    zassert_equal(sensor_read_async_mempool(&imu_iodev, &imu_rtio, (void *)imu), 0, "Sensor read failed");
+    struct rtio_cqe *cqe = rtio_cqe_consume_block(&imu_rtio);
+    zassert_equal(cqe->result, 0, "Sensor read failed");
+
+    uint8_t *buf;
+    uint32_t buf_len;
+    zassert_equal(rtio_cqe_get_mempool_buffer(&imu_rtio, cqe, &buf, &buf_len), 0, "No buffer");
+    rtio_cqe_release(&imu_rtio, cqe);
+
+    const struct sensor_decoder_api *decoder;
+    zassert_equal(sensor_get_decoder(imu, &decoder), 0, "Failed to get decoder");
+    const struct sensor_chan_spec ch_spec = {.chan_idx = 0, .chan_type = SENSOR_CHAN_ACCEL_XYZ};
+    struct sensor_three_axis_data accel_data;
+    uint32_t fit = 0;
+    zassert_equal(decoder->decode(buf, ch_spec, &fit, 1, &accel_data), 1, "Decode failed");
+    rtio_release_buffer(&imu_rtio, buf, buf_len);
+
+    xyz[0] = Z_SHIFT_Q31_TO_F32(accel_data.readings[0].x, accel_data.shift);
+    xyz[1] = Z_SHIFT_Q31_TO_F32(accel_data.readings[0].y, accel_data.shift);
+    xyz[2] = Z_SHIFT_Q31_TO_F32(accel_data.readings[0].z, accel_data.shift);
+}
+
+// Calibrates screen-up, and checks the chip now reads flat to within
+// 0.2 m/s^2 instead of test_imu's 1 m/s^2. The offsets are put back
+// afterwards, and never stored: the NVM only takes so many writes.
+ZTEST(imu, test_imu_calibrate)
+{
+    if (IS_ENABLED(CONFIG_RUNNING_UNDER_CI))
+    {
+        ztest_test_skip();
+    }
+
+    LOG_PRINTK("This test assumes the watch is laying screen-up on a flat surface\n");
+    const struct device *imu = DEVICE_DT_GET(DT_ALIAS(accel));
+    zassert_true(device_is_ready(imu), "IMU device is not ready");
+
+    struct sensor_value saved[3];
+    zassert_equal(sensor_attr_get(imu, SENSOR_CHAN_ACCEL_XYZ, SENSOR_ATTR_OFFSET, saved), 0, "No offsets");
+
+    struct sensor_value target[3] = {0};
+    sensor_g_to_ms2(-1, &target[2]);
+    zassert_equal(sensor_attr_set(imu, SENSOR_CHAN_ACCEL_XYZ, SENSOR_ATTR_CALIB_TARGET, target), 0,
+                  "Calibration failed");
+
+    struct sensor_value offset[3];
+    zassert_equal(sensor_attr_get(imu, SENSOR_CHAN_ACCEL_XYZ, SENSOR_ATTR_OFFSET, offset), 0, "No offsets");
+    LOG_PRINTK("offsets: %d.%06d, %d.%06d, %d.%06d m/s^2\n", offset[0].val1, offset[0].val2, offset[1].val1,
+               offset[1].val2, offset[2].val1, offset[2].val2);
+
+    // one sample is noisier than the calibration's average
+    double sum[3] = {0};
+    for (int i = 0; i < 16; i++)
+    {
+        double xyz[3];
+        k_sleep(K_MSEC(10));
+        read_accel(imu, xyz);
+        for (int axis = 0; axis < 3; axis++)
+        {
+            sum[axis] += xyz[axis];
+        }
+    }
+
+    zassert_equal(sensor_attr_set(imu, SENSOR_CHAN_ACCEL_XYZ, SENSOR_ATTR_OFFSET, saved), 0, "Restore failed");
+
+    zassert_between_inclusive(sum[0] / 16, -0.2, 0.2, "X is off after calibration");
+    zassert_between_inclusive(sum[1] / 16, -0.2, 0.2, "Y is off after calibration");
+    zassert_between_inclusive(sum[2] / 16, -10.01, -9.61, "Z is off after calibration");
+}
+
+#define LOW_POWER_SAMPLES 50
+
+static double noise(const struct device *imu)
+{
+    double sum = 0;
+    double sum2 = 0;
+    for (int i = 0; i < LOW_POWER_SAMPLES; i++)
+    {
+        double xyz[3];
+        k_sleep(K_MSEC(40));
+        read_accel(imu, xyz);
+        sum += xyz[2];
+        sum2 += xyz[2] * xyz[2];
+    }
+
+    const double mean = sum / LOW_POWER_SAMPLES;
+    return sqrt(sum2 / LOW_POWER_SAMPLES - mean * mean);
+}
+
+// Low power mode at 25 Hz, averaging 1 then 16 samples on the chip,
+// against performance mode. Prints the Z noise of each.
+ZTEST(imu, test_imu_low_power)
+{
+    const struct device *imu = DEVICE_DT_GET(DT_ALIAS(accel));
+    zassert_true(device_is_ready(imu), "IMU device is not ready");
+
+    const struct sensor_value odr = {.val1 = 25};
+    zassert_equal(sensor_attr_set(imu, SENSOR_CHAN_ACCEL_XYZ, SENSOR_ATTR_SAMPLING_FREQUENCY, &odr), 0);
+    LOG_PRINTK("performance mode: %d mg rms\n", (int)(noise(imu) * 1000 / 9.80665));
+
+    const struct sensor_value on = {.val1 = 1};
+    zassert_equal(sensor_attr_set(imu, SENSOR_CHAN_ACCEL_XYZ, (enum sensor_attribute)SENSOR_ATTR_BMA423_LOW_POWER, &on),
+                  0, "Failed to enter low power mode");
+    const int averages[] = {1, 16};
+    for (size_t i = 0; i < ARRAY_SIZE(averages); i++)
+    {
+        const struct sensor_value avg = {.val1 = averages[i]};
+        zassert_equal(sensor_attr_set(imu, SENSOR_CHAN_ACCEL_XYZ, SENSOR_ATTR_OVERSAMPLING, &avg), 0);
+
+        struct sensor_value readback;
+        zassert_equal(sensor_attr_get(imu, SENSOR_CHAN_ACCEL_XYZ, SENSOR_ATTR_OVERSAMPLING, &readback), 0);
+        zassert_equal(readback.val1, averages[i]);
+
+        double xyz[3];
+        read_accel(imu, xyz);
+        zassert_between_inclusive(xyz[2], -10.81, -8.81, "Z acceleration is off in low power mode");
+        LOG_PRINTK("low power, %d samples averaged: %d mg rms\n", averages[i], (int)(noise(imu) * 1000 / 9.80665));
+    }
+
+    const struct sensor_value off = {.val1 = 0};
+    zassert_equal(
+        sensor_attr_set(imu, SENSOR_CHAN_ACCEL_XYZ, (enum sensor_attribute)SENSOR_ATTR_BMA423_LOW_POWER, &off), 0,
+        "Failed to leave low power mode");
+    const struct sensor_value default_odr = {.val1 = 100};
+    zassert_equal(sensor_attr_set(imu, SENSOR_CHAN_ACCEL_XYZ, SENSOR_ATTR_SAMPLING_FREQUENCY, &default_odr), 0);
+}
+
+#define FEATURE_TEST_MS 2000
+
+// Minimal host-side step detector: a step is the acceleration magnitude
+// going above 1.2 g and back below 1 g. Squared magnitudes of the q31
+// readings, in integers like a real one would be.
+struct host_steps
+{
+    bool above;
+    uint32_t count;
+};
+
+static void host_steps_feed(struct host_steps *steps, const struct sensor_three_axis_data *data)
+{
+    // 1 g at the reading's shift, and everything scaled down to keep the
+    // squares in range
+    const int64_t g = (int64_t)(SENSOR_G / 1000000.0 * (1LL << (31 - data->shift))) >> 8;
+    for (uint16_t i = 0; i < data->header.reading_count; i++)
+    {
+        const int64_t x = data->readings[i].x >> 8;
+        const int64_t y = data->readings[i].y >> 8;
+        const int64_t z = data->readings[i].z >> 8;
+        const int64_t magnitude2 = x * x + y * y + z * z;
+        if (!steps->above && magnitude2 > g * g * 144 / 100)
+        {
+            steps->above = true;
+            steps->count++;
+        }
+        else if (steps->above && magnitude2 < g * g)
+        {
+            steps->above = false;
+        }
+    }
+}
+
+static atomic_t feature_events;
+
+static void feature_handler(const struct device *dev, const struct sensor_trigger *trigger)
+{
+    ARG_UNUSED(dev);
+    LOG_INF("Feature event %d", trigger->type);
+    atomic_inc(&feature_events);
+}
+
+SENSOR_DT_READ_IODEV(imu_steps_iodev, DT_ALIAS(accel), {(enum sensor_channel)SENSOR_CHAN_BMA423_STEPS, 0});
+
+// Counting steps and watching for tilt/tap on the host means streaming
+// every sample and running the detector on it. The feature engine does
+// that on the sensor: the host only pays for the events, and for reading
+// the count when it wants it. Prints the host CPU time of both.
+ZTEST(imu, test_imu_features)
+{
+    if (!IS_ENABLED(CONFIG_BMA423_FEATURES))
+    {
+        ztest_test_skip();
+    }
+
+    const struct device *imu = DEVICE_DT_GET(DT_ALIAS(accel));
+    zassert_true(device_is_ready(imu), "IMU device is not ready");
+
+    const struct sensor_decoder_api *decoder;
+    zassert_equal(sensor_get_decoder(imu, &decoder), 0, "Failed to get decoder");
+
+    struct bma423_stats stats;
+    bma423_stats_get(imu, &stats);
+    LOG_PRINTK("feature engine loaded in %u us\n", stats.config_upload_us);
+
+    // on the host: stream, decode and detect
+    struct host_steps host_steps = {0};
+    struct rtio_sqe *handle;
+    uint32_t host_cycles = 0;
+    bma423_stats_reset(imu);
+    uint32_t start = k_uptime_get_32();
+    zassert_equal(sensor_stream(&imu_stream_iodev, &imu_stream_rtio, (void *)imu, &handle), 0,
+                  "Failed to start streaming");
+    while (k_uptime_get_32() - start < FEATURE_TEST_MS)
+    {
+        struct rtio_cqe *cqe = rtio_cqe_consume_block(&imu_stream_rtio);
+        zassert_equal(cqe->result, 0, "Stream read failed");
+
+        uint8_t *buf;
+        uint32_t buf_len;
+        zassert_equal(rtio_cqe_get_mempool_buffer(&imu_stream_rtio, cqe, &buf, &buf_len), 0, "No buffer");
+        rtio_cqe_release(&imu_stream_rtio, cqe);
+
+        const uint32_t begin = k_cycle_get_32();
+        const struct sensor_chan_spec ch_spec = {.chan_idx = 0, .chan_type = SENSOR_CHAN_ACCEL_XYZ};
+        uint32_t fit = 0;
+        struct sensor_three_axis_data accel_data;
+        while (decoder->decode(buf, ch_spec, &fit, 1, &accel_data) > 0)
+        {
+            host_steps_feed(&host_steps, &accel_data);
+        }
+        host_cycles += k_cycle_get_32() - begin;
+        rtio_release_buffer(&imu_stream_rtio, buf, buf_len);
+    }
+    rtio_sqe_cancel(handle);
+    uint32_t elapsed_ms = k_uptime_get_32() - start;
+    bma423_stats_get(imu, &stats);
+    const uint32_t host_us = (stats.bus_us + k_cyc_to_us_floor32(host_cycles)) * MSEC_PER_SEC / elapsed_ms;
+    const uint32_t host_wakeups = stats.wakeups * MSEC_PER_SEC / elapsed_ms;
+    stream_drain();
+
+    // on the sensor: sleep until an event, read the count at the end
+    const struct sensor_trigger triggers[] = {
+        {.type = SENSOR_TRIG_TAP, .chan = SENSOR_CHAN_ACCEL_XYZ},
+        {.type = SENSOR_TRIG_DOUBLE_TAP, .chan = SENSOR_CHAN_ACCEL_XYZ},
+        {.type = (enum sensor_trigger_type)SENSOR_TRIG_BMA423_WRIST_TILT, .chan = SENSOR_CHAN_ACCEL_XYZ},
+    };
+    for (size_t i = 0; i < ARRAY_SIZE(triggers); i++)
+    {
+        zassert_equal(sensor_trigger_set(imu, &triggers[i], feature_handler), 0, "Failed to set trigger");
+    }
+
+    bma423_stats_reset(imu);
+    start = k_uptime_get_32();
+    k_sleep(K_MSEC(FEATURE_TEST_MS));
+
+    zassert_equal(sensor_read_async_mempool(&imu_steps_iodev, &imu_rtio, (void *)imu), 0, "Step read failed");
+    struct rtio_cqe *cqe = rtio_cqe_consume_block(&imu_rtio);
+    zassert_equal(cqe->result, 0, "Step read failed");
+    uint8_t *buf;
+    uint32_t buf_len;
+    zassert_equal(rtio_cqe_get_mempool_buffer(&imu_rtio, cqe, &buf, &buf_len), 0, "No buffer");
+    rtio_cqe_release(&imu_rtio, cqe);
+
+    const struct sensor_chan_spec steps_spec = {.chan_idx = 0, .chan_type = (enum sensor_channel)SENSOR_CHAN_BMA423_STEPS};
+    struct sensor_q31_data steps;
+    uint32_t fit = 0;
+    zassert_equal(decoder->decode(buf, steps_spec, &fit, 1, &steps), 1, "No step count");
+    rtio_release_buffer(&imu_rtio, buf, buf_len);
+
+    elapsed_ms = k_uptime_get_32() - start;
+    bma423_stats_get(imu, &stats);
+    const uint32_t feature_us = stats.bus_us * MSEC_PER_SEC / elapsed_ms;
+    const uint32_t feature_wakeups = stats.wakeups * MSEC_PER_SEC / elapsed_ms;
+
+    for (size_t i = 0; i < ARRAY_SIZE(triggers); i++)
+    {
+        zassert_equal(sensor_trigger_set(imu, &triggers[i], NULL), 0, "Failed to clear trigger");
+    }
+
+    LOG_PRINTK("host detection: %u steps, %u wake-ups/s, %u us/s of CPU\n", host_steps.count, host_wakeups,
+               host_us);
+    LOG_PRINTK("feature engine: %d steps, %u wake-ups/s, %u us/s of CPU, %d events\n", steps.readings[0].value,
+               feature_wakeups, feature_us, (int)atomic_get(&feature_events));
+    LOG_PRINTK("host CPU saved: %d us/s\n", (int)host_us - (int)feature_us);
+
+    zassert_true(feature_wakeups < host_wakeups, "The feature engine should wake the host less often");
+}
+
 ZTEST_SUITE(imu, NULL, NULL, NULL, NULL, NULL);
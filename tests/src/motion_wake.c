@@ -0,0 +1,65 @@
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/drivers/sensor/bma423.h>
+#include <t_watch_s3/motion_wake.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(bringup, CONFIG_BRINGUP_LOG_LEVEL);
+
+#define MOTION_WAIT_S 30
+#define STILL_MS 1000
+
+static void *motion_wake_setup(void)
+{
+    const struct device *imu = DEVICE_DT_GET(DT_ALIAS(accel));
+    zassert_true(device_is_ready(imu), "IMU device is not ready");
+
+    // short enough to not keep the tester waiting
+    const struct sensor_value still = {.val1 = STILL_MS};
+    zassert_equal(sensor_attr_set(imu, SENSOR_CHAN_ACCEL_XYZ,
+                                  (enum sensor_attribute)SENSOR_ATTR_BMA423_NO_MOTION_DUR, &still),
+                  0, "Failed to set the no-motion duration");
+    return NULL;
+}
+
+// Nothing samples the IMU while waiting: with CONFIG_PM the SoC light
+// sleeps until INT1 wakes it, and the latency is measured from that wake
+ZTEST(motion_wake, test_motion_wake_latency)
+{
+    if (IS_ENABLED(CONFIG_RUNNING_UNDER_CI))
+    {
+        ztest_test_skip();
+    }
+
+    zassert_equal(motion_wake_start(), 0, "Failed to start");
+
+    // no-motion has to fire once, so the next motion is a real pick-up:
+    // it also drops the motion seen while the watch was put down
+    LOG_PRINTK("Put the watch down and leave it still...\n");
+    struct motion_wake_stats stats;
+    const int64_t deadline = k_uptime_get() + MOTION_WAIT_S * MSEC_PER_SEC;
+    do
+    {
+        zassert_true(k_uptime_get() < deadline, "The watch never lay still");
+        k_sleep(K_MSEC(100));
+        motion_wake_stats_get(&stats);
+    } while (stats.stationary_events == 0 || motion_wake_is_moving());
+
+    LOG_PRINTK("Now pick it up (%d s)\n", MOTION_WAIT_S);
+    zassert_equal(motion_wake_wait(K_SECONDS(MOTION_WAIT_S)), 0, "No motion seen");
+    zassert_true(motion_wake_is_moving());
+
+    motion_wake_stats_get(&stats);
+    zassert_equal(motion_wake_stop(), 0, "Failed to stop");
+
+    LOG_PRINTK("motion events: %u, stationary events: %u, light sleep wakes: %u\n", stats.motion_events,
+               stats.stationary_events, stats.sleep_wakes);
+    if (IS_ENABLED(CONFIG_T_WATCH_S3_MOTION_WAKE_LIGHT_SLEEP))
+    {
+        zassert_true(stats.sleep_wakes > 0, "Never woke from light sleep on INT1");
+        LOG_PRINTK("wake to motion handler: %u us (max %u us)\n", stats.last_wake_us, stats.max_wake_us);
+    }
+    LOG_PRINTK("motion handler to waiting thread: %u us\n", stats.last_dispatch_us);
+}
+
+ZTEST_SUITE(motion_wake, NULL, motion_wake_setup, NULL, NULL, NULL);
@@ -0,0 +1,111 @@
+#include <stdlib.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/rtc.h>
+#include <zephyr/sys/timeutil.h>
+#include <t_watch_s3/time_service.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(bringup, CONFIG_BRINGUP_LOG_LEVEL);
+
+// 2025-05-20 13:30:20 UTC
+#define TIME_SERVICE_TEST_TIME 1747747820
+
+static void time_service_tests_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    // start from a known time, whatever the other suites left in the RTC,
+    // so the alarm always has 40 s to the next minute and a month to go
+    zassert_ok(time_service_set(TIME_SERVICE_TEST_TIME));
+}
+
+ZTEST(time_service, test_time_service_set)
+{
+    const struct device *rtc = DEVICE_DT_GET(DT_ALIAS(rtc));
+
+    zassert_ok(time_service_set(TIME_SERVICE_TEST_TIME));
+    zassert_true(time_service_is_set());
+
+    struct rtc_time time;
+    zassert_ok(rtc_get_time(rtc, &time));
+    zassert_within(timeutil_timegm64(rtc_time_to_tm(&time)), TIME_SERVICE_TEST_TIME, 1, "RTC was not set");
+
+    zassert_ok(time_service_get_rtc_time(&time));
+    zassert_equal(time.tm_hour, 13);
+    zassert_equal(time.tm_min, 30);
+    zassert_equal(time.tm_wday, 2, "2025-05-20 is a Tuesday");
+}
+
+ZTEST(time_service, test_time_service_now)
+{
+    struct time_service_stats before;
+    struct time_service_stats after;
+    time_service_stats_get(&before);
+
+    // reading wall time should cost about as much as reading uptime
+    const int calls = 1000;
+    int64_t last = time_service_now_ms();
+    const uint32_t start = k_cycle_get_32();
+    for (int i = 0; i < calls; i++)
+    {
+        const int64_t now = time_service_now_ms();
+        zassert_true(now >= last, "Wall time went backwards");
+        last = now;
+    }
+    const uint32_t cycles = k_cycle_get_32() - start;
+
+    time_service_stats_get(&after);
+    zassert_equal(after.rtc_reads, before.rtc_reads, "time_service_now_ms() read the RTC");
+    LOG_PRINTK("time_service: now_ms() in %u ns\n", (uint32_t)(k_cyc_to_ns_floor64(cycles) / calls));
+}
+
+// Lines wall time up with the RTC's seconds edge twice, 3 seconds apart,
+// printed as
+// time_service edge_window_us=... error_us=... polls=...
+ZTEST(time_service, test_time_service_sync)
+{
+    const struct device *rtc = DEVICE_DT_GET(DT_ALIAS(rtc));
+    struct time_service_stats before;
+    struct time_service_stats after;
+
+    // the first one steps wall time to the edge after time_service_set()
+    zassert_ok(time_service_sync());
+    k_sleep(K_SECONDS(3));
+
+    time_service_stats_get(&before);
+    const int64_t start = time_service_now_ms();
+    zassert_ok(time_service_sync());
+    zassert_true(time_service_now_ms() >= start, "Wall time went backwards across a sync");
+    time_service_stats_get(&after);
+
+    LOG_PRINTK("time_service edge_window_us=%u error_us=%d polls=%u\n", after.edge_window_us, after.last_error_us,
+               after.edge_polls - before.edge_polls);
+    zassert_equal(after.steps, before.steps, "A few seconds on, wall time should only need slewing");
+    zassert_true(after.edge_window_us < 2000, "The edge was only found to %u us", after.edge_window_us);
+    zassert_true(abs(after.last_error_us) < 5000, "Wall time was %d us off the RTC", after.last_error_us);
+
+    // right after the edge, the RTC's second and wall time agree
+    struct rtc_time time;
+    zassert_ok(rtc_get_time(rtc, &time));
+    const int64_t rtc_s = timeutil_timegm64(rtc_time_to_tm(&time));
+    zassert_within(time_service_now(), rtc_s, 1, "Wall time disagrees with the RTC");
+}
+
+ZTEST(time_service, test_time_service_alarm)
+{
+    struct time_service_stats before;
+    struct time_service_stats after;
+    time_service_stats_get(&before);
+
+    // fires at the start of the next minute
+    zassert_ok(time_service_alarm_set(time_service_now() + 1));
+    k_sleep(K_SECONDS(61));
+
+    time_service_stats_get(&after);
+    zassert_equal(after.alarms, before.alarms + 1, "The alarm did not go off");
+    zassert_ok(time_service_alarm_cancel());
+
+    zassert_equal(time_service_alarm_set(time_service_now() - 1), -EINVAL);
+    zassert_equal(time_service_alarm_set(time_service_now() + 60 * 24 * 60 * 60), -ERANGE);
+}
+
+ZTEST_SUITE(time_service, NULL, NULL, time_service_tests_before, NULL, NULL);
@@ -1,6 +1,10 @@
 #include <zephyr/ztest.h>
 #include <zephyr/input/input.h>
 #include <zephyr/dt-bindings/input/input-event-codes.h>
+#include <zephyr/drivers/input/ft6336.h>
+#include <zephyr/pm/device.h>
+#include <zephyr/pm/device_runtime.h>
+#include <t_watch_s3/touch_filter.h>
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_DECLARE(bringup, CONFIG_BRINGUP_LOG_LEVEL);
@@ -11,6 +15,7 @@ struct touch_fixture
     struct k_sem touch_press_sem;
     struct k_sem touch_drag_sem;
     struct k_sem touch_release_sem;
+    struct k_sem swipe_sem;
 };
 
 static void touch_input_callback(struct input_event *evt, void *user_data)
@@ -47,6 +52,21 @@ static void touch_input_callback(struct input_event *evt, void *user_data)
     }
 }
 
+static void touch_filter_callback(struct input_event *evt, void *user_data)
+{
+    struct touch_fixture *f = user_data;
+    if (!f->test_in_progress || evt->type != INPUT_EV_KEY || evt->value == 0)
+    {
+        return;
+    }
+
+    if (evt->code >= TOUCH_GESTURE_INPUT_CODE(TOUCH_GESTURE_SWIPE_UP) &&
+        evt->code <= TOUCH_GESTURE_INPUT_CODE(TOUCH_GESTURE_SWIPE_RIGHT))
+    {
+        k_sem_give(&f->swipe_sem);
+    }
+}
+
 static void *touch_tests_setup(void)
 {
     static struct touch_fixture fixture = {
@@ -60,9 +80,11 @@ static void *touch_tests_setup(void)
         .touch_drag_sem = Z_SEM_INITIALIZER(fixture.touch_drag_sem, 0, 10),
         // we expect 1 release event, so set this to 2 so we can catch too many
         .touch_release_sem = Z_SEM_INITIALIZER(fixture.touch_release_sem, 0, 2),
+        .swipe_sem = Z_SEM_INITIALIZER(fixture.swipe_sem, 0, 1),
     };
 
     INPUT_CALLBACK_DEFINE(DEVICE_DT_GET(DT_ALIAS(touch)), touch_input_callback, &fixture);
+    INPUT_CALLBACK_DEFINE(DEVICE_DT_GET(DT_NODELABEL(touch_filter)), touch_filter_callback, &fixture);
     return &fixture;
 }
 
@@ -71,6 +93,7 @@ static void touch_tests_before(void *fixture)
     struct touch_fixture *f = fixture;
     k_sem_reset(&f->touch_press_sem);
     k_sem_reset(&f->touch_release_sem);
+    k_sem_reset(&f->swipe_sem);
     f->test_in_progress = true;
 }
 
@@ -129,4 +152,76 @@ ZTEST_F(touch, test_touch_press)
     LOG_PRINTK("Touch released\n");
 }
 
+// What the filter in front of LVGL makes of one swipe: events in and out,
+// and the CPU time it took
+ZTEST_F(touch, test_touch_swipe)
+{
+    if (IS_ENABLED(CONFIG_RUNNING_UNDER_CI))
+    {
+        ztest_test_skip();
+    }
+
+    const struct device *filter = DEVICE_DT_GET(DT_NODELABEL(touch_filter));
+    zassert_true(device_is_ready(filter), "Touch filter is not ready");
+
+    struct touch_fixture *f = fixture;
+    touch_filter_stats_reset(filter);
+    LOG_PRINTK("Swipe across the screen\n");
+    zassert_equal(k_sem_take(&f->swipe_sem, K_SECONDS(5)), 0, "Expected a swipe, got timeout");
+
+    struct touch_filter_stats stats;
+    touch_filter_stats_get(filter, &stats);
+    LOG_PRINTK("swipe: %u events in %u reports from the controller, %u events in %u reports out\n", stats.events_in,
+               stats.reports_in, stats.events_out, stats.reports_out);
+    LOG_PRINTK("swipe: %u duplicates, %u rate limited, %u dropped\n", stats.duplicates, stats.rate_limited,
+               stats.dropped);
+    LOG_PRINTK("swipe: %u us in the filter, at most %u ns per event\n", stats.cpu_us, stats.cpu_max_ns);
+
+    zassert_true(stats.events_out < stats.events_in, "Filter passed on as much as it got");
+    zassert_equal(stats.dropped, 0, "Input queue overflowed");
+}
+
+// Monitor mode until the first contact, and how long that contact takes to
+// come out as an input event
+ZTEST_F(touch, test_touch_wake)
+{
+    if (IS_ENABLED(CONFIG_RUNNING_UNDER_CI) || !IS_ENABLED(CONFIG_PM_DEVICE))
+    {
+        ztest_test_skip();
+    }
+
+    const struct device *touch = DEVICE_DT_GET(DT_ALIAS(touch));
+    struct touch_fixture *f = fixture;
+    enum pm_device_state state;
+
+    if (pm_device_runtime_is_enabled(touch))
+    {
+        // released after idle-timeout-ms without a report
+        const k_timepoint_t end = sys_timepoint_calc(K_MSEC(2 * DT_PROP(DT_ALIAS(touch), idle_timeout_ms)));
+        do
+        {
+            k_msleep(10);
+            zassert_ok(pm_device_state_get(touch, &state));
+        } while (state != PM_DEVICE_STATE_SUSPENDED && !sys_timepoint_expired(end));
+        zassert_equal(state, PM_DEVICE_STATE_SUSPENDED, "Touch did not suspend when idle");
+    }
+    else
+    {
+        zassert_ok(pm_device_action_run(touch, PM_DEVICE_ACTION_SUSPEND));
+    }
+
+    ft6336_stats_reset(touch);
+    k_sem_reset(&f->touch_press_sem);
+    LOG_PRINTK("Touch the screen\n");
+    zassert_equal(k_sem_take(&f->touch_press_sem, K_SECONDS(5)), 0, "Expected a touch, got timeout");
+
+    struct ft6336_stats stats;
+    ft6336_stats_get(touch, &stats);
+    LOG_PRINTK("wake: %u us to the first event (%u light sleep wakes)\n", stats.last_wake_us, stats.sleep_wakes);
+    zassert_equal(stats.wakes, 1, "Expected one wake from monitor mode, got %u", stats.wakes);
+
+    zassert_ok(pm_device_state_get(touch, &state));
+    zassert_equal(state, PM_DEVICE_STATE_ACTIVE, "Touch should be back to full rate scanning");
+}
+
 ZTEST_SUITE(touch, NULL, touch_tests_setup, touch_tests_before, touch_tests_after, NULL);
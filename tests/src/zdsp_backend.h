@@ -1,7 +0,0 @@
-// intentionally empty
-//
-// The imu test uses the Z_SHIFT_Q31_TO_F32 defined in zephyr/dsp/utils.h.
-// However, that include file includes another file zdsp_backend.h that
-// is not available for the esp32 platform. We don't actually need any
-// dsp stuff 'except' for that macro, so the existence of this file
-// allows the build to continue.
\ No newline at end of file